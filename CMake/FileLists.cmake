@@ -19,10 +19,14 @@ set(sources
    src/ExtendedSystemOutput.cpp
    src/Ewald.cpp
    src/EwaldCached.cpp
+   src/EwaldRealTable.cpp
+   src/EwaldSPME.cpp
+   src/EwaldWolf.cpp
    src/FFConst.cpp
    src/FFDihedrals.cpp
    src/FFParticle.cpp
    src/FFSetup.cpp
+   src/FFT3D.cpp
    src/Forcefield.cpp
    src/FreeEnergyOutput.cpp
    src/Geometry.cpp
@@ -37,6 +41,7 @@ set(sources
    src/NoEwald.cpp
    src/OutConst.cpp
    src/OutputVars.cpp
+   src/ParallelGrain.cpp
    src/ParallelTemperingPreprocessor.cpp
    src/ParallelTemperingUtilities.cpp
    src/PDBSetup.cpp
@@ -45,9 +50,11 @@ set(sources
    src/PSFOutput.cpp
    src/Random123Wrapper.cpp
    src/Reader.cpp
+   src/SimdPairKernel.cpp
    src/Simulation.cpp
    src/StaticVals.cpp
    src/System.cpp
+   src/VerletList.cpp
    src/cbmc/DCCrankShaftAng.cpp
    src/cbmc/DCCrankShaftDih.cpp
    src/cbmc/DCCyclic.cpp
@@ -62,6 +69,7 @@ set(sources
    src/cbmc/DCHedronCycle.cpp
    src/cbmc/DCLinear.cpp
    src/cbmc/DCOnSphere.cpp
+   src/cbmc/DCRigid.cpp
    src/cbmc/DCRotateCOM.cpp
    src/cbmc/DCRotateOnAtom.cpp
    src/cbmc/DCSingle.cpp
@@ -72,6 +80,7 @@ set(headers
    src/BondAdjacencyList.h
    src/BoxDimensions.h
    src/BoxDimensionsNonOrth.h
+   src/BoxGeometry.h
    src/CalculateEnergy.h
    src/CBMC.h
    src/CellList.h
@@ -94,6 +103,9 @@ set(headers
    src/ExtendedSystemOutput.h
    src/Ewald.h
    src/EwaldCached.h  
+   src/EwaldRealTable.h
+   src/EwaldSPME.h
+   src/EwaldWolf.h
    src/FFAngles.h
    src/FFBonds.h
    src/FFConst.h
@@ -104,6 +116,7 @@ set(headers
    src/FFShift.h
    src/FFSwitch.h
    src/FFSwitchMartini.h
+   src/FFT3D.h
    src/FixedWidthReader.h
    src/Forcefield.h
    src/FreeEnergyOutput.h
@@ -126,6 +139,7 @@ set(headers
    src/OutConst.h
    src/OutputAbstracts.h
    src/OutputVars.h
+   src/ParallelGrain.h
    src/ParallelTemperingPreprocessor.h
    src/ParallelTemperingUtilities.h
    src/PDBConst.h
@@ -139,12 +153,15 @@ set(headers
    src/SeedReader.h
    src/Setup.h
    src/SimEventFrequency.h
+   src/SimdPairKernel.h
+   src/SimdPairKernelBody.h
    src/Simulation.h
    src/StaticVals.h
    src/SubdividedArray.h
    src/System.h
    src/TransformMatrix.h
    src/Velocity.h
+   src/VerletList.h
    src/Writer.h
    src/XYZArray.h
    src/cbmc/DCComponent.h
@@ -163,6 +180,7 @@ set(headers
    src/cbmc/DCHedronCycle.h
    src/cbmc/DCLinear.h
    src/cbmc/DCOnSphere.h
+   src/cbmc/DCRigid.h
    src/cbmc/DCRotateCOM.h
    src/cbmc/DCRotateOnAtom.h
    src/cbmc/DCSingle.h
@@ -52,6 +52,8 @@ public:
 
   int GetMolIndex(const uint box) const;
 
+  bool HasFraction(const uint box) const;
+
 
 protected:
   int molIndex[BOX_TOTAL]; // global molecule index
@@ -136,4 +138,9 @@ inline int Lambda::GetMolIndex(const uint box) const
   }
 }
 
+inline bool Lambda::HasFraction(const uint box) const
+{
+  return isFraction[box];
+}
+
 #endif
\ No newline at end of file
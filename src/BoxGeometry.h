@@ -0,0 +1,144 @@
+/*******************************************************************************
+GPU OPTIMIZED MONTE CARLO (GOMC) 2.75
+Copyright (C) 2022 GOMC Group
+A copy of the MIT License can be found in License.txt
+along with this program, also can be found at <https://opensource.org/licenses/MIT>.
+********************************************************************************/
+#ifndef BOX_GEOMETRY_H
+#define BOX_GEOMETRY_H
+
+#include "BasicTypes.h" //For uint, XYZ
+#include "XYZArray.h"
+#include "BoxDimensions.h"
+#include "BoxDimensionsNonOrth.h"
+#include <cmath>
+
+//Box geometry policies for the pair loops in CalculateEnergy. A policy is
+//built from the box dimensions once per call, before the loop, and provides
+//the same minimum image and cutoff test as BoxDimensions without going
+//through the virtual MinImage for every pair.
+
+//Orthogonal box. The minimum image rounds the separation to the nearest
+//multiple of the box length, which is branch free and can be vectorized.
+class OrthGeometry
+{
+public:
+  OrthGeometry(BoxDimensions const& boxAxes, const uint b) :
+    axis(boxAxes.GetAxis(b)), rCutSq(boxAxes.rCutSq[b])
+  {
+    axisInv = XYZ(1.0 / axis.x, 1.0 / axis.y, 1.0 / axis.z);
+  }
+
+  XYZ MinImage(XYZ rawVec) const
+  {
+    rawVec.x -= axis.x * std::rint(rawVec.x * axisInv.x);
+    rawVec.y -= axis.y * std::rint(rawVec.y * axisInv.y);
+    rawVec.z -= axis.z * std::rint(rawVec.z * axisInv.z);
+    return rawVec;
+  }
+
+  //Returns if within cutoff, if it is, gets distance, same coordinate array
+  bool InRcut(double & distSq, XYZ & dist, XYZArray const& arr,
+              const uint i, const uint j) const
+  {
+    dist = MinImage(arr.Difference(i, j));
+    distSq = dist.x * dist.x + dist.y * dist.y + dist.z * dist.z;
+    return (rCutSq > distSq);
+  }
+
+  //Returns if within cutoff, if it is, gets distance, two coordinate arrays
+  bool InRcut(double & distSq, XYZ & dist, XYZArray const& arr1,
+              const uint i, XYZArray const& arr2, const uint j) const
+  {
+    dist = MinImage(arr1.Difference(i, arr2, j));
+    distSq = dist.x * dist.x + dist.y * dist.y + dist.z * dist.z;
+    return (rCutSq > distSq);
+  }
+
+  bool InRcut(double & distSq, XYZArray const& arr1, const uint i,
+              XYZArray const& arr2, const uint j) const
+  {
+    XYZ dist;
+    return InRcut(distSq, dist, arr1, i, arr2, j);
+  }
+
+private:
+  XYZ axis, axisInv;
+  double rCutSq;
+};
+
+//Non-orthogonal box. Only valid when boxAxes is really a BoxDimensionsNonOrth,
+//i.e. when boxAxes.orthogonal[b] is false. Keeps a copy of the cell basis and
+//its inverse and applies the minimum image in the unslanted frame, exactly
+//like BoxDimensionsNonOrth::MinImage.
+class NonOrthGeometry
+{
+public:
+  NonOrthGeometry(BoxDimensions const& boxAxes, const uint b) :
+    axis(boxAxes.GetAxis(b)), halfAx(boxAxes.GetHalfAxis(b)),
+    rCutSq(boxAxes.rCutSq[b])
+  {
+    const BoxDimensionsNonOrth& nonOrth =
+      static_cast<const BoxDimensionsNonOrth&>(boxAxes);
+    for (uint i = 0; i < 3; ++i) {
+      basis[i] = nonOrth.cellBasis[b].Get(i);
+      basisInv[i] = nonOrth.cellBasis_Inv[b].Get(i);
+    }
+  }
+
+  XYZ MinImage(XYZ const& rawVec) const
+  {
+    XYZ unslant = Transform(basisInv, rawVec);
+    unslant.x = MinImageSigned(unslant.x, axis.x, halfAx.x);
+    unslant.y = MinImageSigned(unslant.y, axis.y, halfAx.y);
+    unslant.z = MinImageSigned(unslant.z, axis.z, halfAx.z);
+    return Transform(basis, unslant);
+  }
+
+  bool InRcut(double & distSq, XYZ & dist, XYZArray const& arr,
+              const uint i, const uint j) const
+  {
+    dist = MinImage(arr.Difference(i, j));
+    distSq = dist.x * dist.x + dist.y * dist.y + dist.z * dist.z;
+    return (rCutSq > distSq);
+  }
+
+  bool InRcut(double & distSq, XYZ & dist, XYZArray const& arr1,
+              const uint i, XYZArray const& arr2, const uint j) const
+  {
+    dist = MinImage(arr1.Difference(i, arr2, j));
+    distSq = dist.x * dist.x + dist.y * dist.y + dist.z * dist.z;
+    return (rCutSq > distSq);
+  }
+
+  bool InRcut(double & distSq, XYZArray const& arr1, const uint i,
+              XYZArray const& arr2, const uint j) const
+  {
+    XYZ dist;
+    return InRcut(distSq, dist, arr1, i, arr2, j);
+  }
+
+private:
+  //Same operation as TransformSlant/TransformUnSlant with rows m[0..2]
+  static XYZ Transform(const XYZ *m, XYZ const& A)
+  {
+    return XYZ(A.x * m[0].x + A.y * m[1].x + A.z * m[2].x,
+               A.x * m[0].y + A.y * m[1].y + A.z * m[2].y,
+               A.x * m[0].z + A.y * m[1].z + A.z * m[2].z);
+  }
+
+  static double MinImageSigned(double raw, const double ax,
+                               const double halfAx)
+  {
+    if (raw > halfAx)
+      raw -= ax;
+    else if (raw < -halfAx)
+      raw += ax;
+    return raw;
+  }
+
+  XYZ axis, halfAx, basis[3], basisInv[3];
+  double rCutSq;
+};
+
+#endif /*BOX_GEOMETRY_H*/
@@ -10,6 +10,7 @@ along with this program, also can be found at <https://opensource.org/licenses/M
 #include "DCLinear.h"
 #include "DCGraph.h"
 #include "DCCyclic.h"
+#include "DCRigid.h"
 #include <vector>
 
 
@@ -28,7 +29,10 @@ CBMC* MakeCBMC(System& sys, const Forcefield& ff,
 
   bool cyclic = (kind.NumBonds() > kind.NumAtoms() - 1) ? true : false;
 
-  if(cyclic) {
+  if(kind.isRigid) {
+    //Only position and orientation trials, no internal degrees of freedom
+    return new DCRigid(sys, ff, kind, set);
+  } else if(cyclic) {
     return new DCCyclic(sys, ff, kind, set);
   } else if (kind.NumAtoms() > 2) {
     //Any molecule woth 3 atoms and more will be built in DCGraph
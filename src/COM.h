@@ -13,6 +13,8 @@ along with this program, also can be found at <https://opensource.org/licenses/M
 #include "BoxDimensionsNonOrth.h"
 #include "XYZArray.h" //Parent class
 #include "MoleculeLookup.h" //For box iterators used in initial assignment
+#include <vector>
+#include <algorithm> //For max
 
 //COM array
 class COM : public XYZArray
@@ -37,12 +39,24 @@ public:
   void CalcCOM();
   void SetNew(const uint m, const uint b);
 
+  //Largest COM-to-atom distance seen for molecule kind k. Only the CBMC
+  //moves change the shape of a molecule and they all go through SetNew,
+  //the other moves translate and rotate molecules as a whole.
+  double KindRadius(const uint k) const
+  {
+    return kindRadius[k];
+  }
+
 private:
 
+  void UpdateRadius(const uint m, const uint start, const uint stop,
+                    const uint b);
+
   BoxDimensions & boxDimRef;
   XYZArray & coordRef;
   MoleculeLookup & molLookRef;
   Molecules const& molRef;
+  std::vector<double> kindRadius;
 };
 
 inline void COM::CalcCOM()
@@ -50,6 +64,7 @@ inline void COM::CalcCOM()
   MoleculeLookup::box_iterator current, end;
   uint pStart = 0, pStop = 0, pLen = 0;
   XYZArray::Init(molRef.count);
+  kindRadius.assign(molRef.GetKindsCount(), 0.0);
   for (uint b = 0; b < BOX_TOTAL; b++) {
     current = molLookRef.BoxBegin(b);
     end = molLookRef.BoxEnd(b);
@@ -63,6 +78,7 @@ inline void COM::CalcCOM()
       boxDimRef.WrapPBC(coordRef, pStart, pStop, b);
       Scale(*current, 1.0 / (double)(pLen));
       boxDimRef.WrapPBC(x[*current], y[*current], z[*current], b);
+      UpdateRadius(*current, pStart, pStop, b);
       ++current;
     }
   }
@@ -93,6 +109,20 @@ inline void COM::SetNew(const uint moleculeIndex, const uint box)
 
   // wrap the COM
   boxDimRef.WrapPBC(x[moleculeIndex], y[moleculeIndex], z[moleculeIndex], box);
+
+  UpdateRadius(moleculeIndex, atomStart, atomStop, box);
+}
+
+inline void COM::UpdateRadius(const uint m, const uint start,
+                              const uint stop, const uint b)
+{
+  if (kindRadius.size() != molRef.GetKindsCount())
+    kindRadius.resize(molRef.GetKindsCount(), 0.0);
+  double &radius = kindRadius[molRef.kIndex[m]];
+  for (uint p = start; p < stop; p++) {
+    XYZ dist = boxDimRef.MinImage(coordRef.Difference(p, *this, m), b);
+    radius = std::max(radius, dist.Length());
+  }
 }
 
 #endif /*COM_H*/
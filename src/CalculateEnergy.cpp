@@ -14,6 +14,14 @@ along with this program, also can be found at <https://opensource.org/licenses/M
 #include "System.h"                 //For init
 #include "StaticVals.h"             //For init
 #include "Forcefield.h"             //
+#include "FFShift.h"                //For the pair kernel instantiations
+#include "FFSwitch.h"
+#include "FFSwitchMartini.h"
+#include "FFExp6.h"
+#include "BoxGeometry.h"            //For the box geometry policies
+#include "SimdPairKernel.h"         //For the SIMD box pair kernel
+#include "ParallelGrain.h"          //For the move loop grain size
+#include "ConfigSetup.h"            //For the VDW kind constants
 #include "MoleculeLookup.h"
 #include "MoleculeKind.h"
 #include "Coordinates.h"
@@ -23,6 +31,7 @@ along with this program, also can be found at <https://opensource.org/licenses/M
 #include "GeomLib.h"
 #include "NumLib.h"
 #include <cassert>
+#include <limits>
 #ifdef GOMC_CUDA
 #include "CalculateEnergyCUDAKernel.cuh"
 #include "CalculateForceCUDAKernel.cuh"
@@ -78,17 +87,165 @@ void CalculateEnergy::Init(System & sys)
       particleIndex.push_back(int(a));
     }
   }
+  SelectPairKernels();
+  parallel_grain::Init(forcefield.parallelGrain);
+  InitScratch();
+  InitTailSums();
+  energyLedger = forcefield.energyLedger;
+  if(energyLedger) {
+    ledgerLJ.assign(mols.count, 0.0);
+    ledgerReal.assign(mols.count, 0.0);
+    ledgerDiffLJ.assign(mols.count, 0.0);
+    ledgerDiffReal.assign(mols.count, 0.0);
+    ledgerHasDiff.assign(mols.count, 0);
+    ledgerDiffMols.reserve(mols.count);
+  }
+  InvalidateLedger();
+  simdIsa = simd::ISA_NONE;
+  mixedPrecisionReady = mixedPrecision = false;
+#ifndef GOMC_CUDA
+  //The mixed precision kernel is built on the SIMD one
+  if(forcefield.simdKernel || forcefield.mixedPrecision)
+    InitSimdKernel();
+  if(forcefield.mixedPrecision)
+    InitMixedPrecision();
+  verletList.Init(forcefield.verletSkin);
+#endif
 #ifdef GOMC_CUDA
   InitCoordinatesCUDA(forcefield.particles->getCUDAVars(),
                       currentCoords.Count(), maxAtomInMol, currentCOM.Count());
 #endif
 }
 
+void CalculateEnergy::InitScratch()
+{
+  uint maxBonds = 0;
+  for(uint k = 0; k < mols.GetKindsCount(); ++k)
+    maxBonds = std::max(maxBonds, mols.kinds[k].bondList.count);
+#ifdef _OPENMP
+  scratch.resize(omp_get_max_threads());
+#else
+  scratch.resize(1);
+#endif
+  for(uint t = 0; t < scratch.size(); ++t) {
+    // *2 because we'll be storing inverse bond vectors
+    scratch[t].bondVec.Init(maxBonds * 2);
+    scratch[t].bondExist.reserve(maxBonds * 2);
+  }
+}
+
+void CalculateEnergy::InitTailSums()
+{
+  uint kinds = mols.GetKindsCount();
+  tailEnSum.assign(BOX_TOTAL * kinds, 0.0);
+  tailVirSum.assign(BOX_TOTAL * kinds, 0.0);
+  for (uint b = 0; b < BOX_TOTAL; ++b) {
+    for (uint k = 0; k < kinds; ++k) {
+      for (uint j = 0; j < kinds; ++j) {
+        double numJ = (double)(molLookup.NumKindInBox(j, b));
+        tailEnSum[b * kinds + k] += mols.pairEnCorrections[k * kinds + j] * numJ;
+        tailVirSum[b * kinds + k] += mols.pairVirCorrections[k * kinds + j] *
+                                     numJ;
+      }
+    }
+  }
+}
+
+void CalculateEnergy::ShiftTailSums(const uint kind, const uint fromBox,
+                                    const uint intoBox)
+{
+  uint kinds = mols.GetKindsCount();
+  for (uint k = 0; k < kinds; ++k) {
+    tailEnSum[fromBox * kinds + k] -= mols.pairEnCorrections[k * kinds + kind];
+    tailEnSum[intoBox * kinds + k] += mols.pairEnCorrections[k * kinds + kind];
+    tailVirSum[fromBox * kinds + k] -= mols.pairVirCorrections[k * kinds + kind];
+    tailVirSum[intoBox * kinds + k] += mols.pairVirCorrections[k * kinds + kind];
+  }
+}
+
+void CalculateEnergy::SelectPairKernels()
+{
+  //Same selection Forcefield uses to create forcefield.particles
+  if(forcefield.vdwKind == config_setup::FFValues::VDW_STD_KIND)
+    SetPairKernels<FFParticle>();
+  else if(forcefield.vdwKind == config_setup::FFValues::VDW_EXP6_KIND)
+    SetPairKernels<FF_EXP6>();
+  else if(forcefield.vdwKind == config_setup::FFValues::VDW_SHIFT_KIND)
+    SetPairKernels<FF_SHIFT>();
+  else if(forcefield.vdwKind == config_setup::FFValues::VDW_SWITCH_KIND &&
+          forcefield.isMartini)
+    SetPairKernels<FF_SWITCH_MARTINI>();
+  else if(forcefield.vdwKind == config_setup::FFValues::VDW_SWITCH_KIND &&
+          !forcefield.isMartini)
+    SetPairKernels<FF_SWITCH>();
+  else {
+    std::cout << "Undefined Potential Type detected!\n" << "Exiting!\n";
+    exit(EXIT_FAILURE);
+  }
+}
+
+template <class FF>
+void CalculateEnergy::SetPairKernels()
+{
+  //Only the combinations of terms used by BoxPairs callers are instantiated
+  for(int t = 0; t < PAIR_TERMS; t++) {
+    for(int g = 0; g < 2; g++) {
+      boxPairKernel[t][g] = NULL;
+      listBoxPairKernel[t][g] = NULL;
+    }
+  }
+  SetBoxPairKernels<FF, PAIR_ENERGY>();
+  SetBoxPairKernels<FF, PAIR_ENERGY | PAIR_VIRIAL>();
+  SetBoxPairKernels<FF, PAIR_ENERGY | PAIR_FORCE>();
+  SetBoxPairKernels<FF, PAIR_VIRIAL>();
+  moleculeInterKernel[0] =
+    &CalculateEnergy::MoleculeInterKernel<FF, OrthGeometry>;
+  moleculeInterKernel[1] =
+    &CalculateEnergy::MoleculeInterKernel<FF, NonOrthGeometry>;
+  moleculePairsKernel[0] =
+    &CalculateEnergy::MoleculePairsKernel<FF, OrthGeometry>;
+  moleculePairsKernel[1] =
+    &CalculateEnergy::MoleculePairsKernel<FF, NonOrthGeometry>;
+  moleculeSurrogateKernel[0] =
+    &CalculateEnergy::MoleculeSurrogateKernel<FF, OrthGeometry>;
+  moleculeSurrogateKernel[1] =
+    &CalculateEnergy::MoleculeSurrogateKernel<FF, NonOrthGeometry>;
+  molNonbondKernel[0] =
+    &CalculateEnergy::MolNonbondKernel<FF, OrthGeometry>;
+  molNonbondKernel[1] =
+    &CalculateEnergy::MolNonbondKernel<FF, NonOrthGeometry>;
+  particleNonbondedKernel[0] =
+    &CalculateEnergy::ParticleNonbondedKernel<FF, OrthGeometry>;
+  particleNonbondedKernel[1] =
+    &CalculateEnergy::ParticleNonbondedKernel<FF, NonOrthGeometry>;
+  particleInterKernel[0] =
+    &CalculateEnergy::ParticleInterKernel<FF, OrthGeometry>;
+  particleInterKernel[1] =
+    &CalculateEnergy::ParticleInterKernel<FF, NonOrthGeometry>;
+}
+
+template <class FF, int TERMS>
+void CalculateEnergy::SetBoxPairKernels()
+{
+  boxPairKernel[TERMS][0] =
+    &CalculateEnergy::BoxPairKernel<FF, OrthGeometry, TERMS>;
+  boxPairKernel[TERMS][1] =
+    &CalculateEnergy::BoxPairKernel<FF, NonOrthGeometry, TERMS>;
+  listBoxPairKernel[TERMS][0] =
+    &CalculateEnergy::ListBoxPairKernel<FF, OrthGeometry, TERMS>;
+  listBoxPairKernel[TERMS][1] =
+    &CalculateEnergy::ListBoxPairKernel<FF, NonOrthGeometry, TERMS>;
+}
+
 SystemPotential CalculateEnergy::SystemTotal()
 {
   GOMC_EVENT_START(1, GomcProfileEvent::EN_SYSTEM_TOTAL);
+  //drop any round-off the incremental tail sums picked up
+  InitTailSums();
+  //the pair part of the virial comes from the same pass as the energies
+  Virial pairVirial[BOX_TOTAL];
   SystemPotential pot =
-    SystemInter(SystemPotential(), currentCoords, currentAxes);
+    SystemInter(SystemPotential(), currentCoords, currentAxes, pairVirial);
 
   //system intra
   for (uint b = 0; b < BOX_TOTAL; ++b) {
@@ -125,7 +282,10 @@ SystemPotential CalculateEnergy::SystemTotal()
 
     GOMC_EVENT_STOP(1, GomcProfileEvent::EN_BOX_INTRA);
     //Calculate Virial
-    pot.boxVirial[b] = VirialCalc(b);
+    if (b < BOXES_WITH_U_NB)
+      pot.boxVirial[b] = FinishVirial(pairVirial[b], b);
+    else
+      pot.boxVirial[b] = Virial();
   }
 
   pot.Total();
@@ -145,11 +305,13 @@ SystemPotential CalculateEnergy::SystemTotal()
 
 SystemPotential CalculateEnergy::SystemInter(SystemPotential potential,
     XYZArray const& coords,
-    BoxDimensions const& boxAxes)
+    BoxDimensions const& boxAxes,
+    Virial* pairVirial)
 {
   for (uint b = 0; b < BOXES_WITH_U_NB; ++b) {
     //calculate LJ interaction and real term of electrostatic interaction
-    potential = BoxInter(potential, coords, boxAxes, b);
+    potential = BoxInter(potential, coords, boxAxes, b,
+                         pairVirial != NULL ? &pairVirial[b] : NULL);
     //calculate reciprocal term of electrostatic interaction
     potential.boxEnergy[b].recip = calcEwald->BoxReciprocal(b, false);
   }
@@ -165,7 +327,8 @@ SystemPotential CalculateEnergy::SystemInter(SystemPotential potential,
 SystemPotential CalculateEnergy::BoxInter(SystemPotential potential,
                                           XYZArray const& coords,
                                           BoxDimensions const& boxAxes,
-                                          const uint box)
+                                          const uint box,
+                                          Virial* pairVirial)
 {
   //Handles reservoir box case, returning zeroed structure if
   //interactions are off.
@@ -175,13 +338,13 @@ SystemPotential CalculateEnergy::BoxInter(SystemPotential potential,
   GOMC_EVENT_START(1, GomcProfileEvent::EN_BOX_INTER);
   double tempREn = 0.0, tempLJEn = 0.0;
 
+#ifdef GOMC_CUDA
   std::vector<int> cellVector, cellStartIndex, mapParticleToCell;
   std::vector< std::vector<int> > neighborList;
   cellList.GetCellListNeighbor(box, currentCoords.Count(),
                                cellVector, cellStartIndex, mapParticleToCell);
   neighborList = cellList.GetNeighborList(box);
 
-#ifdef GOMC_CUDA
   //update unitcell in GPU
   UpdateCellBasisCUDA(forcefield.particles->getCUDAVars(), box,
                       boxAxes.cellBasis[box].x, boxAxes.cellBasis[box].y,
@@ -202,16 +365,206 @@ SystemPotential CalculateEnergy::BoxInter(SystemPotential potential,
                   particleKind, particleMol, tempREn, tempLJEn, forcefield.sc_coul,
                   forcefield.sc_sigma_6, forcefield.sc_alpha,
                   forcefield.sc_power, box);
+  if(pairVirial != NULL)
+    PairVirial(*pairVirial, box);
 #else
-#ifdef _OPENMP
+  if(UseSimdKernel(boxAxes, box)) {
+    SimdBoxInter(tempREn, tempLJEn, coords, boxAxes, box,
+                 cellList.CellVector(box), cellList.CellStartIndex(box),
+                 cellList.MapParticleToCell(box),
+                 cellList.NeighborStencil(box), mixedPrecision);
+    //the vector kernel has no virial, so it takes a second pass
+    if(pairVirial != NULL)
+      PairVirial(*pairVirial, box);
+  } else if(pairVirial != NULL) {
+    BoxPairs(PAIR_ENERGY | PAIR_VIRIAL, tempREn, tempLJEn, *pairVirial,
+             coords, NULL, NULL, boxAxes, box);
+  } else {
+    Virial unused;
+    BoxPairs(PAIR_ENERGY, tempREn, tempLJEn, unused, coords, NULL, NULL,
+             boxAxes, box);
+  }
+#endif
+
+  // setting energy and virial of LJ interaction
+  potential.boxEnergy[box].inter = tempLJEn;
+  // setting energy and virial of coulomb interaction
+  potential.boxEnergy[box].real = tempREn;
+
+  GOMC_EVENT_STOP(1, GomcProfileEvent::EN_BOX_INTER);
+  // set correction energy and virial
+  if (forcefield.useLRC) {
+    EnergyCorrection(potential, boxAxes, box);
+  }
+
+  potential.Total();
+  return potential;
+}
+
+void CalculateEnergy::BoxPairs(const int terms, double &tempREn,
+                               double &tempLJEn, Virial &tempVir,
+                               XYZArray const& coords, XYZArray* atomForce,
+                               XYZArray* molForce,
+                               BoxDimensions const& boxAxes, const uint box)
+{
+  if(UseVerletList()) {
+    //The Verlet pair list replaces the cell traversal
+    UpdateVerletList(coords, boxAxes, box);
+    ListBoxPairKernelFn kernel =
+      listBoxPairKernel[terms][GeomIndex(boxAxes, box)];
+    (this->*kernel)(tempREn, tempLJEn, tempVir, coords, atomForce, molForce,
+                    boxAxes, box);
+  } else {
+    bool halfShell = UseHalfShell(box);
+    BoxPairKernelFn kernel = boxPairKernel[terms][GeomIndex(boxAxes, box)];
+    (this->*kernel)(tempREn, tempLJEn, tempVir, coords, atomForce, molForce,
+                    boxAxes, box, cellList.CellVector(box),
+                    cellList.CellStartIndex(box),
+                    cellList.MapParticleToCell(box),
+                    halfShell ? cellList.HalfStencil(box) :
+                    cellList.NeighborStencil(box), halfShell);
+  }
+}
+
+template <class FF, class Geom, int TERMS>
+inline void CalculateEnergy::PairTerms(FF const& ff, Geom const& geom,
+                                       XYZArray const& coords,
+                                       const int currParticle,
+                                       const int nParticle, const uint box,
+                                       double &sumREn, double &sumLJEn,
+                                       double *vT, double *rT,
+                                       double *aForcex, double *aForcey,
+                                       double *aForcez, double *mForcex,
+                                       double *mForcey, double *mForcez) const
+{
+  double distSq;
+  XYZ virComponents, forceLJ, forceReal;
+  if(!geom.InRcut(distSq, virComponents, coords, currParticle, nParticle))
+    return;
+
+  //calculate the minimum image between com of two molecules
+  XYZ comC;
+  if(TERMS & PAIR_VIRIAL) {
+    comC = geom.MinImage(currentCOM.Difference(particleMol[currParticle],
+                         particleMol[nParticle]));
+  }
+  double lambdaVDW = GetLambdaVDW(particleMol[currParticle],
+                                  particleMol[nParticle], box);
+  if (electrostatic) {
+    double lambdaCoulomb = GetLambdaCoulomb(particleMol[currParticle],
+                                            particleMol[nParticle], box);
+    double qi_qj = particleCharge[currParticle] * particleCharge[nParticle];
+    //skip particle pairs with no charge
+    if (qi_qj != 0.0) {
+      double qi_qj_fact = qi_qj * num::qqFact;
+      if(TERMS & PAIR_ENERGY) {
+        sumREn += ff.FF::CalcCoulomb(distSq, particleKind[currParticle],
+                                     particleKind[nParticle], qi_qj_fact,
+                                     lambdaCoulomb, box);
+      }
+      if(TERMS & PAIR_VIRIAL) {
+        //qqFact is applied to the whole tensor in FinishVirial
+        double pRF = ff.FF::CalcCoulombVir(distSq, particleKind[currParticle],
+                                           particleKind[nParticle], qi_qj,
+                                           lambdaCoulomb, box);
+        //calculate the top diagonal of pressure tensor
+        rT[0] += pRF * (virComponents.x * comC.x);
+        rT[1] += pRF * (virComponents.y * comC.y);
+        rT[2] += pRF * (virComponents.z * comC.z);
+      }
+      if(TERMS & PAIR_FORCE) {
+        forceReal = virComponents * ff.FF::CalcCoulombVir(distSq,
+                    particleKind[currParticle], particleKind[nParticle],
+                    qi_qj_fact, lambdaCoulomb, box);
+      }
+    }
+  }
+
+  if(TERMS & PAIR_ENERGY) {
+    sumLJEn += ff.FF::CalcEn(distSq, particleKind[currParticle],
+                             particleKind[nParticle], lambdaVDW);
+  }
+  if(TERMS & (PAIR_VIRIAL | PAIR_FORCE)) {
+    double pVF = ff.FF::CalcVir(distSq, particleKind[currParticle],
+                                particleKind[nParticle], lambdaVDW);
+    if(TERMS & PAIR_VIRIAL) {
+      vT[0] += pVF * (virComponents.x * comC.x);
+      vT[1] += pVF * (virComponents.y * comC.y);
+      vT[2] += pVF * (virComponents.z * comC.z);
+    }
+    if(TERMS & PAIR_FORCE) {
+      forceLJ = virComponents * pVF;
+      aForcex[currParticle] += forceLJ.x + forceReal.x;
+      aForcey[currParticle] += forceLJ.y + forceReal.y;
+      aForcez[currParticle] += forceLJ.z + forceReal.z;
+      aForcex[nParticle] += -(forceLJ.x + forceReal.x);
+      aForcey[nParticle] += -(forceLJ.y + forceReal.y);
+      aForcez[nParticle] += -(forceLJ.z + forceReal.z);
+      mForcex[particleMol[currParticle]] += (forceLJ.x + forceReal.x);
+      mForcey[particleMol[currParticle]] += (forceLJ.y + forceReal.y);
+      mForcez[particleMol[currParticle]] += (forceLJ.z + forceReal.z);
+      mForcex[particleMol[nParticle]] += -(forceLJ.x + forceReal.x);
+      mForcey[particleMol[nParticle]] += -(forceLJ.y + forceReal.y);
+      mForcez[particleMol[nParticle]] += -(forceLJ.z + forceReal.z);
+    }
+  }
+}
+
+void CalculateEnergy::SetPairVirial(Virial &tempVir, const double *vT,
+                                    const double *rT) const
+{
+  //only the diagonal is computed
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) {
+      tempVir.interTens[i][j] = (i == j ? vT[i] : 0.0);
+      tempVir.realTens[i][j] = (i == j ? rT[i] : 0.0);
+    }
+  }
+}
+
+template <class FF, class Geom, int TERMS>
+void CalculateEnergy::BoxPairKernel(double &tempREn, double &tempLJEn,
+                                    Virial &tempVir, XYZArray const& coords,
+                                    XYZArray* atomForce, XYZArray* molForce,
+                                    BoxDimensions const& boxAxes,
+                                    const uint box,
+                                    std::vector<int> const& cellVector,
+                                    std::vector<int> const& cellStartIndex,
+                                    std::vector<int> const& mapParticleToCell,
+                                    std::vector<int> const& neighborList,
+                                    const bool halfShell) const
+{
+  const FF& ff = static_cast<const FF&>(*forcefield.particles);
+  const Geom geom(boxAxes, box);
+  const int stencilSize = halfShell ? CellList::HALF_NEIGHBOR_CELLS :
+                          NUMBER_OF_NEIGHBOR_CELL;
+  double sumREn = 0.0, sumLJEn = 0.0;
+  //diagonals of the VDW and real part of electrostatic virial tensors
+  double vT[3] = {0.0, 0.0, 0.0}, rT[3] = {0.0, 0.0, 0.0};
+  //without forces the force reductions run over one scratch element each
+  double scratch[6] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+  const bool force = (TERMS & PAIR_FORCE);
+  double *aForcex = force ? atomForce->x : &scratch[0];
+  double *aForcey = force ? atomForce->y : &scratch[1];
+  double *aForcez = force ? atomForce->z : &scratch[2];
+  double *mForcex = force ? molForce->x : &scratch[3];
+  double *mForcey = force ? molForce->y : &scratch[4];
+  double *mForcez = force ? molForce->z : &scratch[5];
+  int atomCount = force ? atomForce->Count() : 1;
+  int molCount = force ? molForce->Count() : 1;
+
+#if defined _OPENMP && _OPENMP >= 201511 // check if OpenMP version is 4.5
 #if GCC_VERSION >= 90000
-  #pragma omp parallel for default(none) shared(boxAxes, cellStartIndex, \
-  cellVector, coords, mapParticleToCell, box, neighborList) \
-reduction(+:tempREn, tempLJEn)
+  #pragma omp parallel for default(none) shared(geom, ff, cellStartIndex, \
+  cellVector, coords, mapParticleToCell, box, neighborList, halfShell, \
+  stencilSize) \
+reduction(+:sumREn, sumLJEn, vT, rT, aForcex[:atomCount], aForcey[:atomCount], \
+            aForcez[:atomCount], mForcex[:molCount], mForcey[:molCount], mForcez[:molCount])
 #else
-  #pragma omp parallel for default(none) shared(boxAxes, cellStartIndex, \
+  #pragma omp parallel for default(none) shared(geom, ff, cellStartIndex, \
   cellVector, coords, mapParticleToCell, neighborList) \
-reduction(+:tempREn, tempLJEn)
+reduction(+:sumREn, sumLJEn, vT, rT, aForcex[:atomCount], aForcey[:atomCount], \
+            aForcez[:atomCount], mForcex[:molCount], mForcey[:molCount], mForcez[:molCount])
 #endif
 #endif
   // loop over all particles
@@ -220,56 +573,112 @@ reduction(+:tempREn, tempLJEn)
     // find the which cell currParticle belong to
     int currCell = mapParticleToCell[currParticle];
     // loop over currCell neighboring cells
-    for(int nCellIndex = 0; nCellIndex < NUMBER_OF_NEIGHBOR_CELL; nCellIndex++) {
+    for(int nCellIndex = 0; nCellIndex < stencilSize; nCellIndex++) {
       // find the index of neighboring cell
-      int neighborCell = neighborList[currCell][nCellIndex];
+      int neighborCell = neighborList[currCell * stencilSize + nCellIndex];
 
       // find the ending index in neighboring cell
       int endIndex = cellStartIndex[neighborCell + 1];
       // loop over particle inside neighboring cell
-      for(int nParticleIndex = cellStartIndex[neighborCell];
-          nParticleIndex < endIndex; nParticleIndex++) {
+      // the half shell starts with the own cell, where currParticle is only
+      // paired with the particles after it
+      int startIndex = (halfShell && nCellIndex == 0) ? currParticleIdx + 1 :
+                       cellStartIndex[neighborCell];
+      for(int nParticleIndex = startIndex; nParticleIndex < endIndex;
+          nParticleIndex++) {
         int nParticle = cellVector[nParticleIndex];
 
         // avoid same particles and duplicate work
-        if(currParticle < nParticle && particleMol[currParticle] != particleMol[nParticle]) {
-          double distSq;
-          XYZ virComponents;
-          if(boxAxes.InRcut(distSq, virComponents, coords, currParticle, nParticle, box)) {
-            double lambdaVDW = GetLambdaVDW(particleMol[currParticle], particleMol[nParticle], box);
-            if (electrostatic) {
-              double lambdaCoulomb = GetLambdaCoulomb(particleMol[currParticle],
-                                                      particleMol[nParticle], box);
-              double qi_qj_fact = particleCharge[currParticle] *
-                                  particleCharge[nParticle] * num::qqFact;
-              if (qi_qj_fact != 0.0) {
-                tempREn += forcefield.particles->CalcCoulomb(distSq,
-                           particleKind[currParticle], particleKind[nParticle],
-                           qi_qj_fact, lambdaCoulomb, box);
-              }
-            }
-            tempLJEn += forcefield.particles->CalcEn(distSq,
-                        particleKind[currParticle], particleKind[nParticle], lambdaVDW);
-          }
+        if((halfShell || currParticle < nParticle) &&
+           particleMol[currParticle] != particleMol[nParticle]) {
+          PairTerms<FF, Geom, TERMS>(ff, geom, coords, currParticle,
+                                     nParticle, box, sumREn, sumLJEn, vT, rT,
+                                     aForcex, aForcey, aForcez,
+                                     mForcex, mForcey, mForcez);
         }
       }
     }
   }
-#endif
 
-  // setting energy and virial of LJ interaction
-  potential.boxEnergy[box].inter = tempLJEn;
-  // setting energy and virial of coulomb interaction
-  potential.boxEnergy[box].real = tempREn;
+  if(TERMS & PAIR_ENERGY) {
+    tempREn = sumREn;
+    tempLJEn = sumLJEn;
+  }
+  if(TERMS & PAIR_VIRIAL)
+    SetPairVirial(tempVir, vT, rT);
+}
 
-  GOMC_EVENT_STOP(1, GomcProfileEvent::EN_BOX_INTER);
-  // set correction energy and virial
-  if (forcefield.useLRC) {
-    EnergyCorrection(potential, boxAxes, box);
+void CalculateEnergy::UpdateVerletList(XYZArray const& coords,
+                                       BoxDimensions const& boxAxes,
+                                       const uint box)
+{
+  verletAtoms.clear();
+  MoleculeLookup::box_iterator thisMol = molLookup.BoxBegin(box);
+  MoleculeLookup::box_iterator end = molLookup.BoxEnd(box);
+  while (thisMol != end) {
+    for(int p = mols.MolStart(*thisMol); p != mols.MolEnd(*thisMol); p++)
+      verletAtoms.push_back(p);
+    ++thisMol;
   }
+  verletList.Update(coords, boxAxes, box, verletAtoms, particleMol);
+}
 
-  potential.Total();
-  return potential;
+template <class FF, class Geom, int TERMS>
+void CalculateEnergy::ListBoxPairKernel(double &tempREn, double &tempLJEn,
+                                        Virial &tempVir,
+                                        XYZArray const& coords,
+                                        XYZArray* atomForce,
+                                        XYZArray* molForce,
+                                        BoxDimensions const& boxAxes,
+                                        const uint box) const
+{
+  const FF& ff = static_cast<const FF&>(*forcefield.particles);
+  const Geom geom(boxAxes, box);
+  const std::vector<int>& atoms = verletList.Atoms(box);
+  const std::vector<int>& start = verletList.Start(box);
+  const std::vector<int>& pairs = verletList.Pairs(box);
+  double sumREn = 0.0, sumLJEn = 0.0;
+  double vT[3] = {0.0, 0.0, 0.0}, rT[3] = {0.0, 0.0, 0.0};
+  double scratch[6] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+  const bool force = (TERMS & PAIR_FORCE);
+  double *aForcex = force ? atomForce->x : &scratch[0];
+  double *aForcey = force ? atomForce->y : &scratch[1];
+  double *aForcez = force ? atomForce->z : &scratch[2];
+  double *mForcex = force ? molForce->x : &scratch[3];
+  double *mForcey = force ? molForce->y : &scratch[4];
+  double *mForcez = force ? molForce->z : &scratch[5];
+  int atomCount = force ? atomForce->Count() : 1;
+  int molCount = force ? molForce->Count() : 1;
+
+#if defined _OPENMP && _OPENMP >= 201511 // check if OpenMP version is 4.5
+#if GCC_VERSION >= 90000
+  #pragma omp parallel for default(none) shared(geom, ff, atoms, start, \
+  pairs, coords, box) \
+reduction(+:sumREn, sumLJEn, vT, rT, aForcex[:atomCount], aForcey[:atomCount], \
+            aForcez[:atomCount], mForcex[:molCount], mForcey[:molCount], mForcez[:molCount])
+#else
+  #pragma omp parallel for default(none) shared(geom, ff, atoms, start, \
+  pairs, coords) \
+reduction(+:sumREn, sumLJEn, vT, rT, aForcex[:atomCount], aForcey[:atomCount], \
+            aForcez[:atomCount], mForcex[:molCount], mForcey[:molCount], mForcez[:molCount])
+#endif
+#endif
+  for(int row = 0; row < (int) atoms.size(); row++) {
+    int currParticle = atoms[row];
+    for(int k = start[row]; k < start[row + 1]; k++) {
+      PairTerms<FF, Geom, TERMS>(ff, geom, coords, currParticle, pairs[k],
+                                 box, sumREn, sumLJEn, vT, rT,
+                                 aForcex, aForcey, aForcez,
+                                 mForcex, mForcey, mForcez);
+    }
+  }
+
+  if(TERMS & PAIR_ENERGY) {
+    tempREn = sumREn;
+    tempLJEn = sumLJEn;
+  }
+  if(TERMS & PAIR_VIRIAL)
+    SetPairVirial(tempVir, vT, rT);
 }
 
 SystemPotential CalculateEnergy::BoxForce(SystemPotential potential,
@@ -287,25 +696,25 @@ SystemPotential CalculateEnergy::BoxForce(SystemPotential potential,
   GOMC_EVENT_START(1, GomcProfileEvent::EN_BOX_FORCE);
 
   double tempREn = 0.0, tempLJEn = 0.0;
-  // make a pointer to atom force and mol force for OpenMP
-  double *aForcex = atomForce.x;
-  double *aForcey = atomForce.y;
-  double *aForcez = atomForce.z;
-  double *mForcex = molForce.x;
-  double *mForcey = molForce.y;
-  double *mForcez = molForce.z;
-  int atomCount = atomForce.Count();
-  int molCount = molForce.Count();
 
   // Reset Force Arrays
   ResetForce(atomForce, molForce, box);
 
+#ifdef GOMC_CUDA
   std::vector<int> cellVector, cellStartIndex, mapParticleToCell;
   std::vector<std::vector<int> > neighborList;
   cellList.GetCellListNeighbor(box, coords.Count(), cellVector, cellStartIndex, mapParticleToCell);
   neighborList = cellList.GetNeighborList(box);
 
-#ifdef GOMC_CUDA
+  double *aForcex = atomForce.x;
+  double *aForcey = atomForce.y;
+  double *aForcez = atomForce.z;
+  double *mForcex = molForce.x;
+  double *mForcey = molForce.y;
+  double *mForcez = molForce.z;
+  int atomCount = atomForce.Count();
+  int molCount = molForce.Count();
+
   //update unitcell in GPU
   UpdateCellBasisCUDA(forcefield.particles->getCUDAVars(), box,
                       boxAxes.cellBasis[box].x, boxAxes.cellBasis[box].y,
@@ -331,79 +740,348 @@ SystemPotential CalculateEnergy::BoxForce(SystemPotential potential,
                   forcefield.sc_power, box);
 
 #else
+  if(UseSimdKernel(boxAxes, box)) {
+    SimdBoxForce(tempREn, tempLJEn, coords, atomForce, molForce, boxAxes, box,
+                 cellList.CellVector(box), cellList.CellStartIndex(box),
+                 cellList.MapParticleToCell(box),
+                 cellList.NeighborStencil(box));
+  } else {
+    Virial unused;
+    BoxPairs(PAIR_ENERGY | PAIR_FORCE, tempREn, tempLJEn, unused, coords,
+             &atomForce, &molForce, boxAxes, box);
+  }
+#endif
+
+  // setting energy and virial of LJ interaction
+  potential.boxEnergy[box].inter = tempLJEn;
+  // setting energy and virial of coulomb interaction
+  potential.boxEnergy[box].real = tempREn;
+
+  GOMC_EVENT_STOP(1, GomcProfileEvent::EN_BOX_FORCE);
+  return potential;
+}
+
+
+void CalculateEnergy::InitSimdKernel()
+{
+  simd::Isa isa = simd::DetectIsa();
+  if(isa == simd::ISA_NONE) {
+    std::cout << "Warning: SIMDKernel requires AVX2 or AVX-512 support. "
+              "Using the scalar pair kernel.\n";
+    return;
+  }
+  if(!forcefield.particles->GetSimdParams(simdParams)) {
+    std::cout << "Warning: SIMDKernel only supports the VDW and SHIFT "
+              "potentials with n = 12. Using the scalar pair kernel.\n";
+    return;
+  }
+
+  //Check the vector kernel against the scalar one on the initial system
+  simdIsa = isa;
+  for (uint b = 0; b < BOXES_WITH_U_NB; ++b) {
+    if(!currentAxes.orthogonal[b])
+      continue;
+    std::vector<int> const& cellVector = cellList.CellVector(b);
+    std::vector<int> const& cellStartIndex = cellList.CellStartIndex(b);
+    std::vector<int> const& mapParticleToCell = cellList.MapParticleToCell(b);
+    std::vector<int> const& neighborList = cellList.NeighborStencil(b);
+    double refREn = 0.0, refLJEn = 0.0, simdREn = 0.0, simdLJEn = 0.0;
+    Virial unused;
+    BoxPairs(PAIR_ENERGY, refREn, refLJEn, unused, currentCoords, NULL, NULL,
+             currentAxes, b);
+    SimdBoxInter(simdREn, simdLJEn, currentCoords, currentAxes, b,
+                 cellVector, cellStartIndex, mapParticleToCell, neighborList,
+                 false);
+    double tol = 1.0e-8 * std::max(1.0, std::abs(refREn) + std::abs(refLJEn));
+    if(std::abs(refREn - simdREn) > tol || std::abs(refLJEn - simdLJEn) > tol) {
+      std::cout << "Warning: SIMD pair kernel energy for box " << b
+                << " differs from the scalar kernel (LJ " << simdLJEn
+                << " vs " << refLJEn << ", real " << simdREn << " vs "
+                << refREn << "). Using the scalar pair kernel.\n";
+      simdIsa = simd::ISA_NONE;
+      return;
+    }
+  }
+  printf("%-40s %-s \n", "Info: SIMD box pair kernel", simd::IsaName(isa));
+}
+
+void CalculateEnergy::InitMixedPrecision()
+{
+  if(simdIsa == simd::ISA_NONE) {
+    std::cout << "Warning: MixedPrecision needs the SIMD box pair kernel. "
+              "Using double precision.\n";
+    return;
+  }
+  simdParams.FillSingle();
+
+  //Single precision pair energies are good to about 1e-6 relative, check the
+  //box sums against the scalar kernel with room for that
+  for (uint b = 0; b < BOXES_WITH_U_NB; ++b) {
+    if(!currentAxes.orthogonal[b])
+      continue;
+    std::vector<int> const& cellVector = cellList.CellVector(b);
+    std::vector<int> const& cellStartIndex = cellList.CellStartIndex(b);
+    std::vector<int> const& mapParticleToCell = cellList.MapParticleToCell(b);
+    std::vector<int> const& neighborList = cellList.NeighborStencil(b);
+    double refREn = 0.0, refLJEn = 0.0, mixREn = 0.0, mixLJEn = 0.0;
+    Virial unused;
+    BoxPairs(PAIR_ENERGY, refREn, refLJEn, unused, currentCoords, NULL, NULL,
+             currentAxes, b);
+    SimdBoxInter(mixREn, mixLJEn, currentCoords, currentAxes, b,
+                 cellVector, cellStartIndex, mapParticleToCell, neighborList,
+                 true);
+    double tol = 1.0e-4 * std::max(1.0, std::abs(refREn) + std::abs(refLJEn));
+    if(std::abs(refREn - mixREn) > tol || std::abs(refLJEn - mixLJEn) > tol) {
+      std::cout << "Warning: Mixed precision pair kernel energy for box " << b
+                << " differs from the scalar kernel (LJ " << mixLJEn
+                << " vs " << refLJEn << ", real " << mixREn << " vs "
+                << refREn << "). Using double precision.\n";
+      return;
+    }
+  }
+  mixedPrecisionReady = mixedPrecision = true;
+  printf("%-40s %-s \n", "Info: Mixed precision box pair kernel",
+         simd::IsaName(simdIsa));
+}
+
+void CalculateEnergy::FillSimdAtoms(XYZArray const& coords,
+                                    BoxDimensions const& boxAxes,
+                                    const uint box,
+                                    std::vector<int> const& cellVector,
+                                    simd::BoxParams &boxPar,
+                                    const bool single)
+{
+  int count = (int) cellVector.size();
+  simdAtoms.Resize(count, single);
+  for(int p = 0; p < count; p++) {
+    int atom = cellVector[p];
+    if(single) {
+      simdAtoms.xf[p] = coords.x[atom];
+      simdAtoms.yf[p] = coords.y[atom];
+      simdAtoms.zf[p] = coords.z[atom];
+      simdAtoms.chargef[p] = particleCharge[atom];
+    } else {
+      simdAtoms.x[p] = coords.x[atom];
+      simdAtoms.y[p] = coords.y[atom];
+      simdAtoms.z[p] = coords.z[atom];
+      simdAtoms.charge[p] = particleCharge[atom];
+    }
+    simdAtoms.kind[p] = particleKind[atom];
+    simdAtoms.mol[p] = particleMol[atom];
+    simdAtoms.atom[p] = atom;
+  }
+
+  XYZ axis = boxAxes.GetAxis(box);
+  boxPar.axis[0] = axis.x;
+  boxPar.axis[1] = axis.y;
+  boxPar.axis[2] = axis.z;
+  for(uint i = 0; i < 3; i++)
+    boxPar.axisInv[i] = 1.0 / boxPar.axis[i];
+  boxPar.rCutSq = boxAxes.rCutSq[box];
+  boxPar.rCutCoulombSq = forcefield.rCutCoulombSq[box];
+  boxPar.alpha = forcefield.alpha[box];
+  boxPar.alphaSq = forcefield.alphaSq[box];
+  boxPar.rCutCoulomb = forcefield.rCutCoulomb[box];
+  boxPar.wolfShift = forcefield.wolfShift[box];
+  boxPar.wolfForceShift = forcefield.wolfForceShift[box];
+  EwaldRealTable const& table = forcefield.ewaldTable;
+  if(ewald && table.Enabled(box)) {
+    boxPar.tableEn = table.EnergyCoef(box);
+    boxPar.tableVir = table.VirialCoef(box);
+    boxPar.tableStart = table.Start(box);
+    boxPar.tableEnd = table.End(box);
+    boxPar.tableShift = table.Shift(box);
+    boxPar.tableBase = table.Base(box);
+    boxPar.tableMask = table.Mask(box);
+  } else {
+    boxPar.tableEn = boxPar.tableVir = NULL;
+    boxPar.tableStart = boxPar.tableEnd = 0.0;
+    boxPar.tableShift = 0;
+    boxPar.tableBase = boxPar.tableMask = 0;
+  }
+}
+
+void CalculateEnergy::SimdBoxInter(double &tempREn, double &tempLJEn,
+                                   XYZArray const& coords,
+                                   BoxDimensions const& boxAxes,
+                                   const uint box,
+                                   std::vector<int> const& cellVector,
+                                   std::vector<int> const& cellStartIndex,
+                                   std::vector<int> const& mapParticleToCell,
+                                   std::vector<int> const& neighborList,
+                                   const bool single)
+{
+  simd::BoxParams boxPar;
+  FillSimdAtoms(coords, boxAxes, box, cellVector, boxPar, single);
+  const simd::CellAtoms& atoms = simdAtoms;
+  const simd::PairParams& par = simdParams;
+  const simd::Isa isa = simdIsa;
+  const int skipMol = lambdaRef.HasFraction(box) ?
+                      lambdaRef.GetMolIndex(box) : -1;
+  double sumREn = 0.0, sumLJEn = 0.0;
+
+#ifdef _OPENMP
+#if GCC_VERSION >= 90000
+  #pragma omp parallel for default(none) shared(atoms, par, boxPar, isa, \
+  skipMol, cellStartIndex, cellVector, mapParticleToCell, neighborList, \
+  single) reduction(+:sumREn, sumLJEn)
+#else
+  #pragma omp parallel for default(none) shared(atoms, par, boxPar, \
+  cellStartIndex, cellVector, mapParticleToCell, neighborList) \
+reduction(+:sumREn, sumLJEn)
+#endif
+#endif
+  for(int currParticleIdx = 0; currParticleIdx < (int) cellVector.size(); currParticleIdx++) {
+    if(atoms.mol[currParticleIdx] == skipMol)
+      continue;
+    int currCell = mapParticleToCell[cellVector[currParticleIdx]];
+    if(single) {
+      simd::RowEnergyMixed(isa, atoms, par, boxPar, currParticleIdx,
+                           &neighborList[currCell * NUMBER_OF_NEIGHBOR_CELL],
+                           NUMBER_OF_NEIGHBOR_CELL, &cellStartIndex[0],
+                           skipMol, sumREn, sumLJEn);
+    } else {
+      simd::RowEnergy(isa, atoms, par, boxPar, currParticleIdx,
+                      &neighborList[currCell * NUMBER_OF_NEIGHBOR_CELL], NUMBER_OF_NEIGHBOR_CELL,
+                      &cellStartIndex[0], skipMol, sumREn, sumLJEn);
+    }
+  }
+
+  if(skipMol >= 0) {
+    FractionalPairs(sumREn, sumLJEn, coords, NULL, NULL, boxAxes, box,
+                    cellVector, cellStartIndex, mapParticleToCell,
+                    neighborList);
+  }
+
+  tempREn = sumREn;
+  tempLJEn = sumLJEn;
+}
+
+void CalculateEnergy::SimdBoxForce(double &tempREn, double &tempLJEn,
+                                   XYZArray const& coords,
+                                   XYZArray& atomForce, XYZArray& molForce,
+                                   BoxDimensions const& boxAxes,
+                                   const uint box,
+                                   std::vector<int> const& cellVector,
+                                   std::vector<int> const& cellStartIndex,
+                                   std::vector<int> const& mapParticleToCell,
+                                   std::vector<int> const& neighborList)
+{
+  simd::BoxParams boxPar;
+  FillSimdAtoms(coords, boxAxes, box, cellVector, boxPar, false);
+  const simd::CellAtoms& atoms = simdAtoms;
+  const simd::PairParams& par = simdParams;
+  const simd::Isa isa = simdIsa;
+  const int skipMol = lambdaRef.HasFraction(box) ?
+                      lambdaRef.GetMolIndex(box) : -1;
+  double sumREn = 0.0, sumLJEn = 0.0;
+  // make a pointer to atom force and mol force for OpenMP
+  double *aForcex = atomForce.x;
+  double *aForcey = atomForce.y;
+  double *aForcez = atomForce.z;
+  double *mForcex = molForce.x;
+  double *mForcey = molForce.y;
+  double *mForcez = molForce.z;
+  int atomCount = atomForce.Count();
+  int molCount = molForce.Count();
+
 #if defined _OPENMP && _OPENMP >= 201511 // check if OpenMP version is 4.5
 #if GCC_VERSION >= 90000
-  #pragma omp parallel for default(none) shared(boxAxes, cellStartIndex, \
-  cellVector, coords, mapParticleToCell, box, neighborList) \
-reduction(+:tempREn, tempLJEn, aForcex[:atomCount], aForcey[:atomCount], \
+  #pragma omp parallel for default(none) shared(atoms, par, boxPar, isa, \
+  skipMol, cellStartIndex, cellVector, mapParticleToCell, neighborList) \
+reduction(+:sumREn, sumLJEn, aForcex[:atomCount], aForcey[:atomCount], \
             aForcez[:atomCount], mForcex[:molCount], mForcey[:molCount], mForcez[:molCount])
 #else
-  #pragma omp parallel for default(none) shared(boxAxes, cellStartIndex, \
-  cellVector, coords, mapParticleToCell, neighborList) \
-reduction(+:tempREn, tempLJEn, aForcex[:atomCount], aForcey[:atomCount], \
+  #pragma omp parallel for default(none) shared(atoms, par, boxPar, \
+  cellStartIndex, cellVector, mapParticleToCell, neighborList) \
+reduction(+:sumREn, sumLJEn, aForcex[:atomCount], aForcey[:atomCount], \
             aForcez[:atomCount], mForcex[:molCount], mForcey[:molCount], mForcez[:molCount])
 #endif
 #endif
   for(int currParticleIdx = 0; currParticleIdx < (int) cellVector.size(); currParticleIdx++) {
-    int currParticle = cellVector[currParticleIdx];
-    int currCell = mapParticleToCell[currParticle];
+    if(atoms.mol[currParticleIdx] == skipMol)
+      continue;
+    int currCell = mapParticleToCell[cellVector[currParticleIdx]];
+    simd::RowForce(isa, atoms, par, boxPar, currParticleIdx,
+                   &neighborList[currCell * NUMBER_OF_NEIGHBOR_CELL], NUMBER_OF_NEIGHBOR_CELL,
+                   &cellStartIndex[0], skipMol, sumREn, sumLJEn,
+                   aForcex, aForcey, aForcez, mForcex, mForcey, mForcez);
+  }
 
-    for(int nCellIndex = 0; nCellIndex < NUMBER_OF_NEIGHBOR_CELL; nCellIndex++) {
-      int neighborCell = neighborList[currCell][nCellIndex];
+  if(skipMol >= 0) {
+    FractionalPairs(sumREn, sumLJEn, coords, &atomForce, &molForce, boxAxes,
+                    box, cellVector, cellStartIndex, mapParticleToCell,
+                    neighborList);
+  }
 
+  tempREn = sumREn;
+  tempLJEn = sumLJEn;
+}
+
+void CalculateEnergy::FractionalPairs(double &tempREn, double &tempLJEn,
+                                      XYZArray const& coords,
+                                      XYZArray* atomForce,
+                                      XYZArray* molForce,
+                                      BoxDimensions const& boxAxes,
+                                      const uint box,
+                                      std::vector<int> const& cellVector,
+                                      std::vector<int> const& cellStartIndex,
+                                      std::vector<int> const& mapParticleToCell,
+                                      std::vector<int> const& neighborList) const
+{
+  const FFParticle& ff = *forcefield.particles;
+  const int fracMol = lambdaRef.GetMolIndex(box);
+
+  for(int currParticle = mols.MolStart(fracMol);
+      currParticle < mols.MolEnd(fracMol); currParticle++) {
+    int currCell = mapParticleToCell[currParticle];
+    for(int nCellIndex = 0; nCellIndex < NUMBER_OF_NEIGHBOR_CELL; nCellIndex++) {
+      int neighborCell = neighborList[currCell * NUMBER_OF_NEIGHBOR_CELL + nCellIndex];
       int endIndex = cellStartIndex[neighborCell + 1];
       for(int nParticleIndex = cellStartIndex[neighborCell];
           nParticleIndex < endIndex; nParticleIndex++) {
         int nParticle = cellVector[nParticleIndex];
+        // every pair has exactly one atom in the fractional molecule
+        if(particleMol[nParticle] == fracMol)
+          continue;
 
-        if(currParticle < nParticle && particleMol[currParticle] != particleMol[nParticle]) {
-          double distSq;
-          XYZ virComponents, forceLJ, forceReal;
-          if(boxAxes.InRcut(distSq, virComponents, coords, currParticle, nParticle, box)) {
-            double lambdaVDW = GetLambdaVDW(particleMol[currParticle], particleMol[nParticle], box);
-            if (electrostatic) {
-              double lambdaCoulomb = GetLambdaCoulomb(particleMol[currParticle],
-                                                      particleMol[nParticle], box);
-              double qi_qj_fact = particleCharge[currParticle] * particleCharge[nParticle] *
-                                  num::qqFact;
-              if (qi_qj_fact != 0.0) {
-                tempREn += forcefield.particles->CalcCoulomb(distSq, particleKind[currParticle],
-                           particleKind[nParticle], qi_qj_fact, lambdaCoulomb, box);
-                // Calculating the force
-                forceReal = virComponents * forcefield.particles->CalcCoulombVir(distSq,
-                            particleKind[currParticle], particleKind[nParticle], qi_qj_fact, lambdaCoulomb, box);
+        double distSq;
+        XYZ virComponents, forceLJ, forceReal;
+        if(boxAxes.InRcut(distSq, virComponents, coords, currParticle,
+                          nParticle, box)) {
+          double lambdaVDW = GetLambdaVDW(fracMol, particleMol[nParticle], box);
+          if (electrostatic) {
+            double lambdaCoulomb = GetLambdaCoulomb(fracMol,
+                                                    particleMol[nParticle], box);
+            double qi_qj_fact = particleCharge[currParticle] *
+                                particleCharge[nParticle] * num::qqFact;
+            if (qi_qj_fact != 0.0) {
+              tempREn += ff.CalcCoulomb(distSq, particleKind[currParticle],
+                                        particleKind[nParticle], qi_qj_fact,
+                                        lambdaCoulomb, box);
+              if(atomForce != NULL) {
+                forceReal = virComponents * ff.CalcCoulombVir(distSq,
+                            particleKind[currParticle], particleKind[nParticle],
+                            qi_qj_fact, lambdaCoulomb, box);
               }
             }
-            tempLJEn += forcefield.particles->CalcEn(distSq, particleKind[currParticle],
-                        particleKind[nParticle], lambdaVDW);
-            forceLJ = virComponents * forcefield.particles->CalcVir(distSq, particleKind[currParticle],
-                      particleKind[nParticle], lambdaVDW);
-            aForcex[currParticle] += forceLJ.x + forceReal.x;
-            aForcey[currParticle] += forceLJ.y + forceReal.y;
-            aForcez[currParticle] += forceLJ.z + forceReal.z;
-            aForcex[nParticle] += -(forceLJ.x + forceReal.x);
-            aForcey[nParticle] += -(forceLJ.y + forceReal.y);
-            aForcez[nParticle] += -(forceLJ.z + forceReal.z);
-            mForcex[particleMol[currParticle]] += (forceLJ.x + forceReal.x);
-            mForcey[particleMol[currParticle]] += (forceLJ.y + forceReal.y);
-            mForcez[particleMol[currParticle]] += (forceLJ.z + forceReal.z);
-            mForcex[particleMol[nParticle]] += -(forceLJ.x + forceReal.x);
-            mForcey[particleMol[nParticle]] += -(forceLJ.y + forceReal.y);
-            mForcez[particleMol[nParticle]] += -(forceLJ.z + forceReal.z);
+          }
+          tempLJEn += ff.CalcEn(distSq, particleKind[currParticle],
+                                particleKind[nParticle], lambdaVDW);
+          if(atomForce != NULL) {
+            forceLJ = virComponents * ff.CalcVir(distSq,
+                      particleKind[currParticle], particleKind[nParticle],
+                      lambdaVDW);
+            XYZ force = forceLJ + forceReal;
+            atomForce->Add(currParticle, force);
+            atomForce->Sub(nParticle, force);
+            molForce->Add(fracMol, force);
+            molForce->Sub(particleMol[nParticle], force);
           }
         }
       }
     }
   }
-#endif
-
-  // setting energy and virial of LJ interaction
-  potential.boxEnergy[box].inter = tempLJEn;
-  // setting energy and virial of coulomb interaction
-  potential.boxEnergy[box].real = tempREn;
-
-  GOMC_EVENT_STOP(1, GomcProfileEvent::EN_BOX_FORCE);
-  return potential;
 }
 
 
@@ -417,22 +1095,28 @@ Virial CalculateEnergy::VirialCalc(const uint box)
   // no need to calculate the virial for reservoir
   if (box >= BOXES_WITH_U_NB)
     return tempVir;
-  
-  GOMC_EVENT_START(1, GomcProfileEvent::EN_BOX_VIRIAL);
 
-  //tensors for VDW and real part of electrostatic
-  double vT11 = 0.0, vT12 = 0.0, vT13 = 0.0;
-  double vT22 = 0.0, vT23 = 0.0, vT33 = 0.0;
-  double rT11 = 0.0, rT12 = 0.0, rT13 = 0.0;
-  double rT22 = 0.0, rT23 = 0.0, rT33 = 0.0;
+  PairVirial(tempVir, box);
+  return FinishVirial(tempVir, box);
+}
+
+void CalculateEnergy::PairVirial(Virial &tempVir, const uint box)
+{
+  GOMC_EVENT_START(1, GomcProfileEvent::EN_BOX_VIRIAL);
 
+#ifdef GOMC_CUDA
   std::vector<int> cellVector, cellStartIndex, mapParticleToCell;
   std::vector<std::vector<int> > neighborList;
   cellList.GetCellListNeighbor(box, currentCoords.Count(), cellVector,
                                cellStartIndex, mapParticleToCell);
   neighborList = cellList.GetNeighborList(box);
 
-#ifdef GOMC_CUDA
+  //tensors for VDW and real part of electrostatic
+  double vT11 = 0.0, vT12 = 0.0, vT13 = 0.0;
+  double vT22 = 0.0, vT23 = 0.0, vT33 = 0.0;
+  double rT11 = 0.0, rT12 = 0.0, rT13 = 0.0;
+  double rT22 = 0.0, rT23 = 0.0, rT33 = 0.0;
+
   //update unitcell in GPU
   UpdateCellBasisCUDA(forcefield.particles->getCUDAVars(), box,
                       currentAxes.cellBasis[box].x,
@@ -458,81 +1142,6 @@ Virial CalculateEnergy::VirialCalc(const uint box)
                        forcefield.sc_coul,
                        forcefield.sc_sigma_6, forcefield.sc_alpha,
                        forcefield.sc_power, box);
-#else
-#ifdef _OPENMP
-#if GCC_VERSION >= 90000
-  #pragma omp parallel for default(none) shared(cellStartIndex, cellVector, \
-  mapParticleToCell, neighborList, box) \
-reduction(+:vT11, vT12, vT13, vT22, vT23, vT33, rT11, rT12, rT13, rT22, rT23, rT33)
-#else
-  #pragma omp parallel for default(none) shared(cellStartIndex, cellVector, \
-  mapParticleToCell, neighborList) \
-reduction(+:vT11, vT12, vT13, vT22, vT23, vT33, rT11, rT12, rT13, rT22, rT23, rT33)
-#endif
-#endif
-  for(int currParticleIdx = 0; currParticleIdx < (int) cellVector.size(); currParticleIdx++) {
-    int currParticle = cellVector[currParticleIdx];
-    int currCell = mapParticleToCell[currParticle];
-
-    for(int nCellIndex = 0; nCellIndex < NUMBER_OF_NEIGHBOR_CELL; nCellIndex++) {
-      int neighborCell = neighborList[currCell][nCellIndex];
-
-      int endIndex = cellStartIndex[neighborCell + 1];
-      for(int nParticleIndex = cellStartIndex[neighborCell];
-          nParticleIndex < endIndex; nParticleIndex++) {
-        int nParticle = cellVector[nParticleIndex];
-
-        // make sure the pairs are unique and they belong to different molecules
-        if(currParticle < nParticle && particleMol[currParticle] != particleMol[nParticle]) {
-          double distSq;
-          XYZ virC;
-          if (currentAxes.InRcut(distSq, virC, currentCoords, currParticle,
-                                 nParticle, box)) {
-
-            //calculate the distance between com of two molecules
-            XYZ comC = currentCOM.Difference(particleMol[currParticle], particleMol[nParticle]);
-            //calculate the minimum image between com of two molecules
-            comC = currentAxes.MinImage(comC, box);
-            double lambdaVDW = GetLambdaVDW(particleMol[currParticle], particleMol[nParticle], box);
-
-            if (electrostatic) {
-              double lambdaCoulomb = GetLambdaCoulomb(particleMol[currParticle],
-                                                      particleMol[nParticle], box);
-              double qi_qj = particleCharge[currParticle] * particleCharge[nParticle];
-
-              //skip particle pairs with no charge
-              if (qi_qj != 0.0) {
-                double pRF = forcefield.particles->CalcCoulombVir(distSq, particleKind[currParticle],
-                             particleKind[nParticle], qi_qj, lambdaCoulomb, box);
-                //calculate the top diagonal of pressure tensor
-                rT11 += pRF * (virC.x * comC.x);
-                //rT12 += pRF * (0.5 * (virC.x * comC.y + virC.y * comC.x));
-                //rT13 += pRF * (0.5 * (virC.x * comC.z + virC.z * comC.x));
-
-                rT22 += pRF * (virC.y * comC.y);
-                //rT23 += pRF * (0.5 * (virC.y * comC.z + virC.z * comC.y));
-
-                rT33 += pRF * (virC.z * comC.z);
-              }
-            }
-
-            double pVF = forcefield.particles->CalcVir(distSq, particleKind[currParticle],
-                         particleKind[nParticle], lambdaVDW);
-            //calculate the top diagonal of pressure tensor
-            vT11 += pVF * (virC.x * comC.x);
-            //vT12 += pVF * (0.5 * (virC.x * comC.y + virC.y * comC.x));
-            //vT13 += pVF * (0.5 * (virC.x * comC.z + virC.z * comC.x));
-
-            vT22 += pVF * (virC.y * comC.y);
-            //vT23 += pVF * (0.5 * (virC.y * comC.z + virC.z * comC.y));
-
-            vT33 += pVF * (virC.z * comC.z);
-          }
-        }
-      }
-    }
-  }
-#endif
 
   // set the all tensor values
   tempVir.interTens[0][0] = vT11;
@@ -547,27 +1156,41 @@ reduction(+:vT11, vT12, vT13, vT22, vT23, vT33, rT11, rT12, rT13, rT22, rT23, rT
   tempVir.interTens[2][1] = vT23;
   tempVir.interTens[2][2] = vT33;
 
-  if (electrostatic) {
-    // real part of electrostatic
-    tempVir.realTens[0][0] = rT11 * num::qqFact;
-    tempVir.realTens[0][1] = rT12 * num::qqFact;
-    tempVir.realTens[0][2] = rT13 * num::qqFact;
+  tempVir.realTens[0][0] = rT11;
+  tempVir.realTens[0][1] = rT12;
+  tempVir.realTens[0][2] = rT13;
+
+  tempVir.realTens[1][0] = rT12;
+  tempVir.realTens[1][1] = rT22;
+  tempVir.realTens[1][2] = rT23;
 
-    tempVir.realTens[1][0] = rT12 * num::qqFact;
-    tempVir.realTens[1][1] = rT22 * num::qqFact;
-    tempVir.realTens[1][2] = rT23 * num::qqFact;
+  tempVir.realTens[2][0] = rT13;
+  tempVir.realTens[2][1] = rT23;
+  tempVir.realTens[2][2] = rT33;
+#else
+  double tempREn = 0.0, tempLJEn = 0.0;
+  BoxPairs(PAIR_VIRIAL, tempREn, tempLJEn, tempVir, currentCoords, NULL, NULL,
+           currentAxes, box);
+#endif
+  GOMC_EVENT_STOP(1, GomcProfileEvent::EN_BOX_VIRIAL);
+}
+
+Virial CalculateEnergy::FinishVirial(Virial tempVir, const uint box)
+{
 
-    tempVir.realTens[2][0] = rT13 * num::qqFact;
-    tempVir.realTens[2][1] = rT23 * num::qqFact;
-    tempVir.realTens[2][2] = rT33 * num::qqFact;
+  // real part of electrostatic
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) {
+      tempVir.realTens[i][j] *= num::qqFact;
+    }
   }
 
   // setting virial of LJ
-  tempVir.inter = vT11 + vT22 + vT33;
+  tempVir.inter = tempVir.interTens[0][0] + tempVir.interTens[1][1] +
+                  tempVir.interTens[2][2];
   // setting virial of coulomb
-  tempVir.real = (rT11 + rT22 + rT33) * num::qqFact;
-
-  GOMC_EVENT_STOP(1, GomcProfileEvent::EN_BOX_VIRIAL);
+  tempVir.real = tempVir.realTens[0][0] + tempVir.realTens[1][1] +
+                 tempVir.realTens[2][2];
 
   if (forcefield.useLRC || forcefield.useIPC) {
     VirialCorrection(tempVir, currentAxes, box);
@@ -580,13 +1203,276 @@ reduction(+:vT11, vT12, vT13, vT22, vT23, vT33, rT11, rT12, rT13, rT22, rT23, rT
   return tempVir;
 }
 
-
 bool CalculateEnergy::MoleculeInter(Intermolecular &inter_LJ,
                                     Intermolecular &inter_coulomb,
                                     XYZArray const& molCoords,
                                     const uint molIndex,
                                     const uint box) const
 {
+  if(energyLedger && box < BOXES_WITH_U_NB) {
+    GOMC_EVENT_START(1, GomcProfileEvent::EN_MOL_INTER);
+    if(!ledgerValid[box])
+      RebuildLedger(molIndex, box);
+    //Only the new configuration is visited, its pair energies are kept for
+    //LedgerAccept
+    ClearLedgerDiff();
+    ledgerNewLJ = ledgerNewReal = 0.0;
+    bool overlap = MoleculePairs(molCoords, 0, molIndex, box, ledgerNewLJ,
+                                 ledgerNewReal, 1.0, true);
+    inter_LJ.energy = ledgerNewLJ - ledgerLJ[molIndex];
+    inter_coulomb.energy = ledgerNewReal - ledgerReal[molIndex];
+    GOMC_EVENT_STOP(1, GomcProfileEvent::EN_MOL_INTER);
+    return overlap;
+  }
+  MoleculeInterKernelFn kernel =
+    moleculeInterKernel[GeomIndex(currentAxes, box)];
+  return (this->*kernel)(inter_LJ, inter_coulomb, molCoords, molIndex, box);
+}
+
+bool CalculateEnergy::MoleculeSurrogate(double &energy,
+                                        XYZArray const& molCoords,
+                                        const uint molIndex,
+                                        const uint box) const
+{
+  energy = 0.0;
+  if(box >= BOXES_WITH_U_NB)
+    return false;
+  MoleculeSurrogateKernelFn kernel =
+    moleculeSurrogateKernel[GeomIndex(currentAxes, box)];
+  return (this->*kernel)(energy, molCoords, molIndex, box);
+}
+
+template <class FF, class Geom>
+bool CalculateEnergy::MoleculeSurrogateKernel(double &energy,
+                                              XYZArray const& molCoords,
+                                              const uint molIndex,
+                                              const uint box) const
+{
+  const FF& ff = static_cast<const FF&>(*forcefield.particles);
+  const Geom geom(currentAxes, box);
+  double tempLJEn = 0.0;
+  uint start = mols.MolStart(molIndex);
+  uint length = mols.GetKind(molIndex).NumAtoms();
+
+  //Subtract the old configuration, then add the new one
+  for (int c = 0; c < 2; ++c) {
+    XYZArray const* coords = (c == 0) ? &currentCoords : &molCoords;
+    uint first = (c == 0) ? start : 0;
+    double sign = (c == 0) ? -1.0 : 1.0;
+    for (uint p = 0; p < length; ++p) {
+      uint atom = start + p;
+      CellList::Neighbors n = cellList.EnumerateLocal((*coords)[first + p],
+                              box);
+      while (!n.Done()) {
+        uint nAtom = *n;
+        n.Next();
+        double distSq = 0.0;
+        XYZ virComponents;
+        if (particleMol[nAtom] == (int) molIndex ||
+            !geom.InRcut(distSq, virComponents, *coords, first + p,
+                         currentCoords, nAtom) ||
+            distSq >= forcefield.rCutSurrogateSq)
+          continue;
+        //The move is rejected, the energy is not needed
+        if (c == 1 && distSq < forcefield.rCutLowSq)
+          return true;
+        double lambdaVDW = GetLambdaVDW(molIndex, particleMol[nAtom], box);
+        tempLJEn += sign * ff.FF::CalcEn(distSq, particleKind[atom],
+                                         particleKind[nAtom], lambdaVDW);
+      }
+    }
+  }
+  energy = tempLJEn;
+  return false;
+}
+
+void CalculateEnergy::LedgerAccept(const uint molIndex, const uint box)
+{
+  if(!energyLedger || box >= BOXES_WITH_U_NB)
+    return;
+  //Subtract the old pair energies from the neighbors, which get the new
+  //ones from the trial
+  double oldLJ = 0.0, oldReal = 0.0;
+  MoleculePairs(currentCoords, mols.MolStart(molIndex), molIndex, box, oldLJ,
+                oldReal, -1.0);
+  ApplyLedgerDiff();
+  ledgerLJ[molIndex] = ledgerNewLJ;
+  ledgerReal[molIndex] = ledgerNewReal;
+}
+
+void CalculateEnergy::InvalidateLedger()
+{
+  for(uint b = 0; b < BOX_TOTAL; b++)
+    ledgerValid[b] = false;
+}
+
+void CalculateEnergy::RebuildLedger(const uint molIndex, const uint box) const
+{
+  MoleculeLookup::box_iterator thisMol = molLookup.BoxBegin(box);
+  MoleculeLookup::box_iterator end = molLookup.BoxEnd(box);
+  std::vector<uint> molID;
+  while (thisMol != end) {
+    molID.push_back(*thisMol);
+    ++thisMol;
+  }
+
+#ifdef _OPENMP
+#if GCC_VERSION >= 90000
+  #pragma omp parallel for default(none) shared(box, molID)
+#else
+  #pragma omp parallel for default(none) shared(molID)
+#endif
+#endif
+  for (int i = 0; i < (int) molID.size(); i++) {
+    double lj = 0.0, real = 0.0;
+    MoleculePairs(currentCoords, mols.MolStart(molID[i]), molID[i], box, lj,
+                  real, 0.0);
+    ledgerLJ[molID[i]] = lj;
+    ledgerReal[molID[i]] = real;
+  }
+  //molIndex is not in the cell list, so its pairs are missing from the
+  //energies of its neighbors
+  double lj = 0.0, real = 0.0;
+  ClearLedgerDiff();
+  MoleculePairs(currentCoords, mols.MolStart(molIndex), molIndex, box, lj,
+                real, 1.0);
+  ApplyLedgerDiff();
+  ledgerValid[box] = true;
+}
+
+void CalculateEnergy::ApplyLedgerDiff() const
+{
+  for(uint i = 0; i < ledgerDiffMols.size(); i++) {
+    uint m = ledgerDiffMols[i];
+    ledgerLJ[m] += ledgerDiffLJ[m];
+    ledgerReal[m] += ledgerDiffReal[m];
+  }
+  ClearLedgerDiff();
+}
+
+void CalculateEnergy::ClearLedgerDiff() const
+{
+  for(uint i = 0; i < ledgerDiffMols.size(); i++) {
+    uint m = ledgerDiffMols[i];
+    ledgerDiffLJ[m] = ledgerDiffReal[m] = 0.0;
+    ledgerHasDiff[m] = 0;
+  }
+  ledgerDiffMols.clear();
+}
+
+template <class FF, class Geom>
+bool CalculateEnergy::MoleculePairsKernel(XYZArray const& coords,
+                                          const uint first,
+                                          const uint molIndex,
+                                          const uint box, double &ljEn,
+                                          double &realEn,
+                                          const double scatter,
+                                          const bool stopOnOverlap) const
+{
+  const FF& ff = static_cast<const FF&>(*forcefield.particles);
+  const Geom geom(currentAxes, box);
+  bool overlap = false;
+  uint start = mols.MolStart(molIndex);
+  uint length = mols.GetKind(molIndex).NumAtoms();
+
+  for (uint p = 0; p < length; ++p) {
+    uint atom = start + p;
+    CellList::Neighbors n = cellList.EnumerateLocal(coords[first + p], box);
+    while (!n.Done()) {
+      uint nAtom = *n;
+      uint nMol = particleMol[nAtom];
+      n.Next();
+      double distSq = 0.0;
+      XYZ virComponents;
+      if (nMol == molIndex || !geom.InRcut(distSq, virComponents, coords,
+                                           first + p, currentCoords, nAtom))
+        continue;
+      if(distSq < forcefield.rCutLowSq) {
+        overlap = true;
+        if(stopOnOverlap)
+          return true;
+      }
+
+      double pairReal = 0.0;
+      if (electrostatic) {
+        double qi_qj_fact = particleCharge[atom] * particleCharge[nAtom] *
+                            num::qqFact;
+        if (qi_qj_fact != 0.0) {
+          double lambdaCoulomb = GetLambdaCoulomb(molIndex, nMol, box);
+          pairReal = ff.FF::CalcCoulomb(distSq, particleKind[atom],
+                                        particleKind[nAtom], qi_qj_fact,
+                                        lambdaCoulomb, box);
+        }
+      }
+      double lambdaVDW = GetLambdaVDW(molIndex, nMol, box);
+      double pairLJ = ff.FF::CalcEn(distSq, particleKind[atom],
+                                    particleKind[nAtom], lambdaVDW);
+      realEn += pairReal;
+      ljEn += pairLJ;
+      if (scatter != 0.0) {
+        if (!ledgerHasDiff[nMol]) {
+          ledgerHasDiff[nMol] = 1;
+          ledgerDiffMols.push_back(nMol);
+        }
+        ledgerDiffLJ[nMol] += scatter * pairLJ;
+        ledgerDiffReal[nMol] += scatter * pairReal;
+      }
+    }
+  }
+  return overlap;
+}
+
+template <class Geom>
+void CalculateEnergy::ScreenSphere(XYZ &center, double &radius,
+                                   Geom const& geom, XYZArray const& coords,
+                                   const uint start, const uint len) const
+{
+  XYZ sum;
+  for (uint p = 1; p < len; ++p)
+    sum += geom.MinImage(coords.Difference(start + p, start));
+  center = coords[start] + sum * (1.0 / (double) len);
+  radius = 0.0;
+  for (uint p = 0; p < len; ++p)
+    radius = std::max(radius,
+                      geom.MinImage(coords[start + p] - center).Length());
+}
+
+template <class Geom>
+bool CalculateEnergy::ScreenMol(Geom const& geom, XYZ const& center,
+                                const double reach, const uint mol,
+                                const unsigned char flag) const
+{
+  Scratch &s = ThreadScratch();
+  unsigned char &state = s.molScreen[mol];
+  if (!(state & flag)) {
+    if (state == 0)
+      s.screened.push_back(mol);
+    double r = reach + currentCOM.KindRadius(mols.kIndex[mol]);
+    XYZ dist = geom.MinImage(currentCOM.Get(mol) - center);
+    state |= flag;
+    if (dist.LengthSq() < r * r)
+      state |= (flag << 1);
+  }
+  return state & (flag << 1);
+}
+
+void CalculateEnergy::ClearScreen() const
+{
+  Scratch &s = ThreadScratch();
+  for (uint i = 0; i < s.screened.size(); ++i)
+    s.molScreen[s.screened[i]] = 0;
+  s.screened.clear();
+}
+
+template <class FF, class Geom>
+bool CalculateEnergy::MoleculeInterKernel(Intermolecular &inter_LJ,
+                                          Intermolecular &inter_coulomb,
+                                          XYZArray const& molCoords,
+                                          const uint molIndex,
+                                          const uint box) const
+{
+  const FF& ff = static_cast<const FF&>(*forcefield.particles);
+  const Geom geom(currentAxes, box);
   double tempREn = 0.0, tempLJEn = 0.0;
   bool overlap = false;
 
@@ -594,34 +1480,55 @@ bool CalculateEnergy::MoleculeInter(Intermolecular &inter_LJ,
     GOMC_EVENT_START(1, GomcProfileEvent::EN_MOL_INTER);
     uint length = mols.GetKind(molIndex).NumAtoms();
     uint start = mols.MolStart(molIndex);
+    //neighbor molecules whose COM is too far from the sphere around the old
+    //or new atoms are skipped before any of their atoms is looked at
+    const bool screen = forcefield.comScreen;
+    XYZ oldCenter, newCenter;
+    double oldReach = 0.0, newReach = 0.0;
+    if (screen) {
+      std::vector<unsigned char> &molScreen = ThreadScratch().molScreen;
+      if (molScreen.size() != mols.count)
+        molScreen.assign(mols.count, 0);
+      //the margin covers the rounding of the rigid moves in the kind radius
+      double radius;
+      ScreenSphere(oldCenter, radius, geom, currentCoords, start, length);
+      oldReach = currentAxes.rCut[box] + radius + 1.0e-3;
+      ScreenSphere(newCenter, radius, geom, molCoords, 0, length);
+      newReach = currentAxes.rCut[box] + radius + 1.0e-3;
+    }
 
     for (uint p = 0; p < length; ++p) {
       uint atom = start + p;
       CellList::Neighbors n = cellList.EnumerateLocal(currentCoords[atom],
                               box);
 
-      std::vector<uint> nIndex;
+      std::vector<uint> &nIndex = ThreadScratch().nIndex;
+      nIndex.clear();
       //store atom index in neighboring cell
       while (!n.Done()) {
-        nIndex.push_back(*n);
+        if (!screen || ScreenMol(geom, oldCenter, oldReach, particleMol[*n],
+                                 SCREEN_OLD))
+          nIndex.push_back(*n);
         n.Next();
       }
 
 #ifdef _OPENMP
 #if GCC_VERSION >= 90000
-      #pragma omp parallel for default(none) shared(atom, nIndex, box, molIndex) \
-      reduction(+:tempREn, tempLJEn)
+      #pragma omp parallel for default(none) shared(geom, ff, atom, nIndex, box, molIndex) \
+      reduction(+:tempREn, tempLJEn) \
+      if(parallel_grain::Parallel(nIndex.size()))
 #else
-      #pragma omp parallel for default(none) shared(atom, nIndex) \
-      reduction(+:tempREn, tempLJEn)
+      #pragma omp parallel for default(none) shared(geom, ff, atom, nIndex) \
+      reduction(+:tempREn, tempLJEn) \
+      if(parallel_grain::Parallel(nIndex.size()))
 #endif
 #endif
       for(int i = 0; i < (int) nIndex.size(); i++) {
         double distSq = 0.0;
         XYZ virComponents;
         //Subtract old energy
-        if (currentAxes.InRcut(distSq, virComponents, currentCoords, atom,
-                               nIndex[i], box)) {
+        if (geom.InRcut(distSq, virComponents, currentCoords, atom,
+                        nIndex[i])) {
           double lambdaVDW = GetLambdaVDW(molIndex, particleMol[nIndex[i]], box);
 
           if (electrostatic) {
@@ -631,12 +1538,12 @@ bool CalculateEnergy::MoleculeInter(Intermolecular &inter_LJ,
                                 num::qqFact;
 
             if (qi_qj_fact != 0.0) {
-              tempREn += -forcefield.particles->CalcCoulomb(distSq, particleKind[atom],
+              tempREn += -ff.FF::CalcCoulomb(distSq, particleKind[atom],
                          particleKind[nIndex[i]], qi_qj_fact, lambdaCoulomb, box);
             }
           }
 
-          tempLJEn += -forcefield.particles->CalcEn(distSq, particleKind[atom],
+          tempLJEn += -ff.FF::CalcEn(distSq, particleKind[atom],
                       particleKind[nIndex[i]], lambdaVDW);
         }
       }
@@ -646,24 +1553,31 @@ bool CalculateEnergy::MoleculeInter(Intermolecular &inter_LJ,
       //store atom index in neighboring cell
       nIndex.clear();
       while (!n.Done()) {
-        nIndex.push_back(*n);
+        if (!screen || ScreenMol(geom, newCenter, newReach, particleMol[*n],
+                                 SCREEN_NEW))
+          nIndex.push_back(*n);
         n.Next();
       }
 
 #ifdef _OPENMP
 #if GCC_VERSION >= 90000
-      #pragma omp parallel for default(none) shared(atom, molCoords, nIndex, overlap, p, molIndex, box) \
-      reduction(+:tempREn, tempLJEn)
+      #pragma omp parallel for default(none) shared(geom, ff, atom, molCoords, nIndex, overlap, p, molIndex, box) \
+      reduction(+:tempREn, tempLJEn) \
+      if(parallel_grain::Parallel(nIndex.size()))
 #else
-      #pragma omp parallel for default(none) shared(atom, molCoords, nIndex, overlap, p) \
-      reduction(+:tempREn, tempLJEn)
+      #pragma omp parallel for default(none) shared(geom, ff, atom, molCoords, nIndex, overlap, p) \
+      reduction(+:tempREn, tempLJEn) \
+      if(parallel_grain::Parallel(nIndex.size()))
 #endif
 #endif
       for(int i = 0; i < (int) nIndex.size(); i++) {
         double distSq = 0.0;
         XYZ virComponents;
-        if (currentAxes.InRcut(distSq, virComponents, molCoords, p,
-                               currentCoords, nIndex[i], box)) {
+        //The move is rejected on an overlap, the energies are not needed
+        if (overlap)
+          continue;
+        if (geom.InRcut(distSq, virComponents, molCoords, p,
+                        currentCoords, nIndex[i])) {
           double lambdaVDW = GetLambdaVDW(molIndex, particleMol[nIndex[i]], box);
 
           if(distSq < forcefield.rCutLowSq) {
@@ -677,18 +1591,22 @@ bool CalculateEnergy::MoleculeInter(Intermolecular &inter_LJ,
                                 particleCharge[nIndex[i]] * num::qqFact;
 
             if (qi_qj_fact != 0.0) {
-              tempREn += forcefield.particles->CalcCoulomb(distSq,
+              tempREn += ff.FF::CalcCoulomb(distSq,
                          particleKind[atom], particleKind[nIndex[i]],
                          qi_qj_fact, lambdaCoulomb, box);
             }
           }
 
-          tempLJEn += forcefield.particles->CalcEn(distSq,
+          tempLJEn += ff.FF::CalcEn(distSq,
                       particleKind[atom],
                       particleKind[nIndex[i]], lambdaVDW);
         }
       }
+      if (overlap)
+        break;
     }
+    if (screen)
+      ClearScreen();
     GOMC_EVENT_STOP(1, GomcProfileEvent::EN_MOL_INTER);
   }
 
@@ -703,32 +1621,49 @@ void CalculateEnergy::ParticleNonbonded(double* inter,
                                         XYZArray const& trialPos,
                                         const uint partIndex,
                                         const uint box,
-                                        const uint trials) const
+                                        const uint trials,
+                                        const bool* overlap) const
 {
   if (box >= BOXES_WITH_U_B)
     return;
 
+  ParticleNonbondedKernelFn kernel =
+    particleNonbondedKernel[GeomIndex(currentAxes, box)];
+  (this->*kernel)(inter, trialMol, trialPos, partIndex, box, trials,
+                  overlap);
+}
+
+template <class FF, class Geom>
+void CalculateEnergy::ParticleNonbondedKernel(double* inter,
+                                              cbmc::TrialMol const& trialMol,
+                                              XYZArray const& trialPos,
+                                              const uint partIndex,
+                                              const uint box,
+                                              const uint trials,
+                                              const bool* overlap) const
+{
   GOMC_EVENT_START(1, GomcProfileEvent::EN_CBMC_INTRA_NB);
+  const FF& ff = static_cast<const FF&>(*forcefield.particles);
+  const Geom geom(currentAxes, box);
+  const bool drop = forcefield.dropOverlapTrials && overlap != NULL;
   const MoleculeKind& kind = trialMol.GetKind();
+  uint kindI = kind.AtomKind(partIndex);
   //loop over all partners of the trial particle
   const uint* partner = kind.sortedNB.Begin(partIndex);
   const uint* end = kind.sortedNB.End(partIndex);
   while (partner != end) {
     if (trialMol.AtomExists(*partner)) {
+      uint kindJ = kind.AtomKind(*partner);
+      double qi_qj_fact = kind.AtomCharge(partIndex) *
+                          kind.AtomCharge(*partner) * num::qqFact;
       for (uint t = 0; t < trials; ++t) {
         double distSq;
-        if (currentAxes.InRcut(distSq, trialPos, t, trialMol.GetCoords(), *partner, box)) {
-          inter[t] += forcefield.particles->CalcEn(distSq,
-                      kind.AtomKind(partIndex),
-                      kind.AtomKind(*partner), 1.0);
-          if (electrostatic) {
-            double qi_qj_fact = kind.AtomCharge(partIndex) *
-                                kind.AtomCharge(*partner) * num::qqFact;
-
-            if (qi_qj_fact != 0.0) {
-              forcefield.particles->CalcCoulombAdd_1_4(inter[t], distSq,
-                                                       qi_qj_fact, true);
-            }
+        if (drop && overlap[t])
+          continue;
+        if (geom.InRcut(distSq, trialPos, t, trialMol.GetCoords(), *partner)) {
+          inter[t] += ff.FF::CalcEn(distSq, kindI, kindJ, 1.0);
+          if (electrostatic && qi_qj_fact != 0.0) {
+            ff.FF::CalcCoulombAdd_1_4(inter[t], distSq, qi_qj_fact, true);
           }
         }
       }
@@ -745,18 +1680,38 @@ void CalculateEnergy::ParticleInter(double* en, double *real,
                                     const uint molIndex,
                                     const uint box,
                                     const uint trials) const
+{
+  ParticleInterKernelFn kernel =
+    particleInterKernel[GeomIndex(currentAxes, box)];
+  (this->*kernel)(en, real, trialPos, overlap, partIndex, molIndex, box,
+                  trials);
+}
+
+template <class FF, class Geom>
+void CalculateEnergy::ParticleInterKernel(double* en, double *real,
+                                          XYZArray const& trialPos,
+                                          bool* overlap,
+                                          const uint partIndex,
+                                          const uint molIndex,
+                                          const uint box,
+                                          const uint trials) const
 {
   if(box >= BOXES_WITH_U_NB)
     return;
   
   GOMC_EVENT_START(1, GomcProfileEvent::EN_CBMC_INTER);
+  const FF& ff = static_cast<const FF&>(*forcefield.particles);
+  const Geom geom(currentAxes, box);
   double tempLJ, tempReal;
   MoleculeKind const& thisKind = mols.GetKind(molIndex);
   uint kindI = thisKind.AtomKind(partIndex);
   double kindICharge = thisKind.AtomCharge(partIndex);
-  std::vector<uint> nIndex;
+  std::vector<uint> &nIndex = ThreadScratch().nIndex;
+  const bool drop = forcefield.dropOverlapTrials;
 
   for(uint t = 0; t < trials; ++t) {
+    if(drop && overlap[t])
+      continue;
     nIndex.clear();
     tempReal = 0.0;
     tempLJ = 0.0;
@@ -768,38 +1723,45 @@ void CalculateEnergy::ParticleInter(double* en, double *real,
 
 #ifdef _OPENMP
 #if GCC_VERSION >= 90000
-    #pragma omp parallel for default(none) shared(kindI, kindICharge, nIndex, \
-    overlap, t, trialPos, box, molIndex) \
-reduction(+:tempLJ, tempReal)
+    #pragma omp parallel for default(none) shared(geom, ff, kindI, kindICharge, nIndex, \
+    overlap, t, trialPos, box, molIndex, drop) \
+reduction(+:tempLJ, tempReal) \
+    if(parallel_grain::Parallel(nIndex.size()))
 #else
-    #pragma omp parallel for default(none) shared(kindI, kindICharge, nIndex, \
+    #pragma omp parallel for default(none) shared(geom, ff, kindI, kindICharge, nIndex, \
     overlap, t, trialPos) \
-reduction(+:tempLJ, tempReal)
+reduction(+:tempLJ, tempReal) \
+    if(parallel_grain::Parallel(nIndex.size()))
 #endif
 #endif
     for(int i = 0; i < (int) nIndex.size(); i++) {
       double distSq = 0.0;
-      if(currentAxes.InRcut(distSq, trialPos, t, currentCoords, nIndex[i], box)) {
+      if(drop && overlap[t])
+        continue;
+      if(geom.InRcut(distSq, trialPos, t, currentCoords, nIndex[i])) {
         double lambdaVDW = GetLambdaVDW(molIndex, particleMol[nIndex[i]], box);
 
         if(distSq < forcefield.rCutLowSq) {
           overlap[t] |= true;
         }
-        tempLJ += forcefield.particles->CalcEn(distSq, kindI,
-                                               particleKind[nIndex[i]],
-                                               lambdaVDW);
+        tempLJ += ff.FF::CalcEn(distSq, kindI, particleKind[nIndex[i]],
+                                lambdaVDW);
         if(electrostatic) {
           double lambdaCoulomb = GetLambdaCoulomb(molIndex, particleMol[nIndex[i]],
                                                   box);
           double qi_qj_fact = particleCharge[nIndex[i]] * kindICharge * num::qqFact;
  
           if (qi_qj_fact != 0.0) {
-            tempReal += forcefield.particles->CalcCoulomb(distSq, kindI,
+            tempReal += ff.FF::CalcCoulomb(distSq, kindI,
                         particleKind[nIndex[i]], qi_qj_fact, lambdaCoulomb, box);
           }
         }
       }
     }
+    if(drop && overlap[t]) {
+      en[t] = std::numeric_limits<double>::infinity();
+      continue;
+    }
     en[t] += tempLJ;
     real[t] += tempReal;
   }
@@ -818,16 +1780,13 @@ Intermolecular CalculateEnergy::MoleculeTailChange(const uint box,
 
     double sign = (add ? 1.0 : -1.0);
     uint mkIdxII = kind * mols.GetKindsCount() + kind;
-    for (uint j = 0; j < mols.GetKindsCount(); ++j) {
-      uint mkIdxIJ = j * mols.GetKindsCount() + kind;
-      double rhoDeltaIJ_2 = sign * 2.0 * (double)(molLookup.NumKindInBox(j, box)) *
-                            currentAxes.volInv[box];
-      delta.energy += mols.pairEnCorrections[mkIdxIJ] * rhoDeltaIJ_2;
-    }
+    //sum over kinds j of pairEnCorrections[kind][j] * N_j
+    double rhoDelta_2 = sign * 2.0 *
+                        tailEnSum[box * mols.GetKindsCount() + kind];
 
-    //We already calculated part of the change for this type in the loop
-    delta.energy += mols.pairEnCorrections[mkIdxII] *
-                    currentAxes.volInv[box];
+    //Adding the molecule to itself is the extra self pair term
+    delta.energy = (rhoDelta_2 + mols.pairEnCorrections[mkIdxII]) *
+                   currentAxes.volInv[box];
   }
   return delta;
 }
@@ -843,16 +1802,13 @@ Intermolecular CalculateEnergy::MoleculeTailVirChange(const uint box,
 
     double sign = (add ? 1.0 : -1.0);
     uint mkIdxII = kind * mols.GetKindsCount() + kind;
-    for (uint j = 0; j < mols.GetKindsCount(); ++j) {
-      uint mkIdxIJ = j * mols.GetKindsCount() + kind;
-      double rhoDeltaIJ_2 = sign * 2.0 * (double)(molLookup.NumKindInBox(j, box)) *
-                            currentAxes.volInv[box];
-      delta.virial += mols.pairVirCorrections[mkIdxIJ] * rhoDeltaIJ_2;
-    }
+    //sum over kinds j of pairVirCorrections[kind][j] * N_j
+    double rhoDelta_2 = sign * 2.0 *
+                        tailVirSum[box * mols.GetKindsCount() + kind];
 
-    //We already calculated part of the change for this type in the loop
-    delta.virial += mols.pairVirCorrections[mkIdxII] *
-                    currentAxes.volInv[box];
+    //Adding the molecule to itself is the extra self pair term
+    delta.virial = (rhoDelta_2 + mols.pairVirCorrections[mkIdxII]) *
+                   currentAxes.volInv[box];
   }
   return delta;
 }
@@ -866,8 +1822,13 @@ void CalculateEnergy::MoleculeIntra(const uint molIndex,
   bondEn[0] = 0.0, bondEn[1] = 0.0;
 
   MoleculeKind& molKind = mols.kinds[mols.kIndex[molIndex]];
-  // *2 because we'll be storing inverse bond vectors
-  XYZArray bondVec(molKind.bondList.count * 2);
+  //nothing can change inside a rigid molecule, its intra energy is zero
+  if (molKind.isRigid) {
+    GOMC_EVENT_STOP(1, GomcProfileEvent::EN_MOL_INTRA);
+    return;
+  }
+  // holds the bond vectors and their inverse
+  XYZArray &bondVec = ThreadScratch().bondVec;
 
   BondVectors(bondVec, molKind, molIndex, box);
   MolBond(bondEn[0], molKind, bondVec, molIndex, box);
@@ -886,9 +1847,14 @@ Energy CalculateEnergy::MoleculeIntra(cbmc::TrialMol const &mol) const
   double bondEn = 0.0, intraNonbondEn = 0.0;
   // *2 because we'll be storing inverse bond vectors
   const MoleculeKind& molKind = mol.GetKind();
+  if (molKind.isRigid) {
+    GOMC_EVENT_STOP(1, GomcProfileEvent::EN_MOL_INTRA);
+    return Energy();
+  }
   uint count = molKind.bondList.count;
-  XYZArray bondVec(count * 2);
-  std::vector<bool> bondExist(count * 2, false);
+  XYZArray &bondVec = ThreadScratch().bondVec;
+  std::vector<bool> &bondExist = ThreadScratch().bondExist;
+  bondExist.assign(count * 2, false);
 
   BondVectors(bondVec, mol, bondExist, molKind);
   MolBond(bondEn, mol, bondVec, bondExist, molKind);
@@ -1065,30 +2031,9 @@ void CalculateEnergy::MolNonbond(double & energy,
   if (box >= BOXES_WITH_U_B)
     return;
 
-  double distSq;
-  double qi_qj_fact;
-
-  for (uint i = 0; i < molKind.nonBonded.count; ++i) {
-    uint p1 = mols.start[molIndex] + molKind.nonBonded.part1[i];
-    uint p2 = mols.start[molIndex] + molKind.nonBonded.part2[i];
-    if (currentAxes.InRcut(distSq, currentCoords, p1, p2, box)) {
-      energy += forcefield.particles->CalcEn(distSq, molKind.AtomKind
-                                             (molKind.nonBonded.part1[i]),
-                                             molKind.AtomKind
-                                             (molKind.nonBonded.part2[i]), 1.0);
-      if (electrostatic) {
-        qi_qj_fact = num::qqFact *
-                     molKind.AtomCharge(molKind.nonBonded.part1[i]) *
-                     molKind.AtomCharge(molKind.nonBonded.part2[i]);
-
-        if (qi_qj_fact != 0.0) {
-          forcefield.particles->CalcCoulombAdd_1_4(energy, distSq,
-            qi_qj_fact, true);
-        }
-      }
-    }
-  }
-
+  MolNonbondKernelFn kernel = molNonbondKernel[GeomIndex(currentAxes, box)];
+  (this->*kernel)(energy, molKind.tableNB, currentCoords,
+                  mols.start[molIndex], box, true, NULL);
 }
 
 // Calculate 1-N nonbonded intra energy using pos
@@ -1098,30 +2043,10 @@ void CalculateEnergy::MolNonbond(double & energy, cbmc::TrialMol const &mol,
   if (mol.GetBox() >= BOXES_WITH_U_B)
     return;
 
-  double distSq;
-  double qi_qj_fact;
-  uint count = molKind.nonBonded.count;
-
-  for (uint i = 0; i < count; ++i) {
-    uint p1 = molKind.nonBonded.part1[i];
-    uint p2 = molKind.nonBonded.part2[i];
-    if(mol.AtomExists(p1) && mol.AtomExists(p2)) {
-      if (currentAxes.InRcut(distSq, mol.GetCoords(), p1, p2, mol.GetBox())) {
-        energy += forcefield.particles->CalcEn(distSq, molKind.AtomKind(p1),
-                                               molKind.AtomKind(p2), 1.0);
-        if (electrostatic) {
-          qi_qj_fact = num::qqFact * molKind.AtomCharge(1) *
-                       molKind.AtomCharge(p2);
-
-          if (qi_qj_fact != 0.0) {
-            forcefield.particles->CalcCoulombAdd_1_4(energy, distSq,
-              qi_qj_fact, true);
-           }
-        }
-      }
-    }
-  }
-
+  MolNonbondKernelFn kernel =
+    molNonbondKernel[GeomIndex(currentAxes, mol.GetBox())];
+  (this->*kernel)(energy, molKind.tableNB, mol.GetCoords(), 0, mol.GetBox(),
+                  true, &mol);
 }
 
 // Calculate 1-4 nonbonded intra energy
@@ -1133,30 +2058,9 @@ void CalculateEnergy::MolNonbond_1_4(double & energy,
   if (box >= BOXES_WITH_U_B)
     return;
 
-  double distSq;
-  double qi_qj_fact;
-
-  for (uint i = 0; i < molKind.nonBonded_1_4.count; ++i) {
-    uint p1 = mols.start[molIndex] + molKind.nonBonded_1_4.part1[i];
-    uint p2 = mols.start[molIndex] + molKind.nonBonded_1_4.part2[i];
-    if (currentAxes.InRcut(distSq, currentCoords, p1, p2, box)) {
-      forcefield.particles->CalcAdd_1_4(energy, distSq,
-                                        molKind.AtomKind
-                                        (molKind.nonBonded_1_4.part1[i]),
-                                        molKind.AtomKind
-                                        (molKind.nonBonded_1_4.part2[i]));
-      if (electrostatic) {
-        qi_qj_fact = num::qqFact *
-                     molKind.AtomCharge(molKind.nonBonded_1_4.part1[i]) *
-                     molKind.AtomCharge(molKind.nonBonded_1_4.part2[i]);
-
-        if (qi_qj_fact != 0.0) {
-          forcefield.particles->CalcCoulombAdd_1_4(energy, distSq,
-            qi_qj_fact, false);
-        }
-      }
-    }
-  }
+  MolNonbondKernelFn kernel = molNonbondKernel[GeomIndex(currentAxes, box)];
+  (this->*kernel)(energy, molKind.tableNB_1_4, currentCoords,
+                  mols.start[molIndex], box, false, NULL);
 }
 
 // Calculate 1-4 nonbonded intra energy using pos
@@ -1167,30 +2071,10 @@ void CalculateEnergy::MolNonbond_1_4(double & energy,
   if (mol.GetBox() >= BOXES_WITH_U_B)
     return;
 
-  double distSq;
-  double qi_qj_fact;
-  uint count = molKind.nonBonded_1_4.count;
-
-  for (uint i = 0; i < count; ++i) {
-    uint p1 = molKind.nonBonded_1_4.part1[i];
-    uint p2 = molKind.nonBonded_1_4.part2[i];
-    if(mol.AtomExists(p1) && mol.AtomExists(p2)) {
-      if (currentAxes.InRcut(distSq, mol.GetCoords(), p1, p2, mol.GetBox())) {
-        forcefield.particles->CalcAdd_1_4(energy, distSq,
-                                          molKind.AtomKind(p1),
-                                          molKind.AtomKind(p2));
-        if (electrostatic) {
-          qi_qj_fact = num::qqFact * molKind.AtomCharge(p1) *
-                       molKind.AtomCharge(p2);
-
-          if (qi_qj_fact != 0.0) {
-            forcefield.particles->CalcCoulombAdd_1_4(energy, distSq,
-                qi_qj_fact, false);
-          }
-        }
-      }
-    }
-  }
+  MolNonbondKernelFn kernel =
+    molNonbondKernel[GeomIndex(currentAxes, mol.GetBox())];
+  (this->*kernel)(energy, molKind.tableNB_1_4, mol.GetCoords(), 0,
+                  mol.GetBox(), false, &mol);
 }
 
 // Calculate 1-3 nonbonded intra energy
@@ -1202,33 +2086,12 @@ void CalculateEnergy::MolNonbond_1_3(double & energy,
   if (box >= BOXES_WITH_U_B)
     return;
 
-  double distSq;
-  double qi_qj_fact;
-
-  for (uint i = 0; i < molKind.nonBonded_1_3.count; ++i) {
-    uint p1 = mols.start[molIndex] + molKind.nonBonded_1_3.part1[i];
-    uint p2 = mols.start[molIndex] + molKind.nonBonded_1_3.part2[i];
-    if (currentAxes.InRcut(distSq, currentCoords, p1, p2, box)) {
-      forcefield.particles->CalcAdd_1_4(energy, distSq,
-                                        molKind.AtomKind
-                                        (molKind.nonBonded_1_3.part1[i]),
-                                        molKind.AtomKind
-                                        (molKind.nonBonded_1_3.part2[i]));
-      if (electrostatic) {
-        qi_qj_fact = num::qqFact *
-                     molKind.AtomCharge(molKind.nonBonded_1_3.part1[i]) *
-                     molKind.AtomCharge(molKind.nonBonded_1_3.part2[i]);
-
-        if (qi_qj_fact != 0.0) {
-          forcefield.particles->CalcCoulombAdd_1_4(energy, distSq,
-              qi_qj_fact, false);
-        }
-      }
-    }
-  }
+  MolNonbondKernelFn kernel = molNonbondKernel[GeomIndex(currentAxes, box)];
+  (this->*kernel)(energy, molKind.tableNB_1_3, currentCoords,
+                  mols.start[molIndex], box, false, NULL);
 }
 
-// Calculate 1-3 nonbonded intra energy
+// Calculate 1-3 nonbonded intra energy using pos
 void CalculateEnergy::MolNonbond_1_3(double & energy,
                                      cbmc::TrialMol const &mol,
                                      MoleculeKind const& molKind) const
@@ -1236,28 +2099,37 @@ void CalculateEnergy::MolNonbond_1_3(double & energy,
   if (mol.GetBox() >= BOXES_WITH_U_B)
     return;
 
-  double distSq;
-  double qi_qj_fact;
-  uint count = molKind.nonBonded_1_3.count;
+  MolNonbondKernelFn kernel =
+    molNonbondKernel[GeomIndex(currentAxes, mol.GetBox())];
+  (this->*kernel)(energy, molKind.tableNB_1_3, mol.GetCoords(), 0,
+                  mol.GetBox(), false, &mol);
+}
 
-  for (uint i = 0; i < count; ++i) {
-    uint p1 = molKind.nonBonded_1_3.part1[i];
-    uint p2 = molKind.nonBonded_1_3.part2[i];
-    if(mol.AtomExists(p1) && mol.AtomExists(p2)) {
-      if (currentAxes.InRcut(distSq, mol.GetCoords(), p1, p2, mol.GetBox())) {
-        forcefield.particles->CalcAdd_1_4(energy, distSq,
-                                          molKind.AtomKind(p1),
-                                          molKind.AtomKind(p2));
-        if (electrostatic) {
-          qi_qj_fact = num::qqFact * molKind.AtomCharge(p1) *
-                       molKind.AtomCharge(p2);
+template <class FF, class Geom>
+void CalculateEnergy::MolNonbondKernel(double &energy,
+                                       NonbondTable const& table,
+                                       XYZArray const& coords,
+                                       const uint start, const uint box,
+                                       const bool oneN,
+                                       cbmc::TrialMol const* mol) const
+{
+  const FF& ff = static_cast<const FF&>(*forcefield.particles);
+  const Geom geom(currentAxes, box);
+  uint count = table.Count();
 
-          if (qi_qj_fact != 0.0) {
-            forcefield.particles->CalcCoulombAdd_1_4(energy, distSq,
-              qi_qj_fact, false);
-          }
-        }
-      }
+  for (uint i = 0; i < count; ++i) {
+    uint p1 = table.part1[i];
+    uint p2 = table.part2[i];
+    if (mol != NULL && !(mol->AtomExists(p1) && mol->AtomExists(p2)))
+      continue;
+    double distSq;
+    if (geom.InRcut(distSq, coords, start + p1, coords, start + p2)) {
+      if (oneN)
+        energy += ff.FF::CalcEn(distSq, table.kind1[i], table.kind2[i], 1.0);
+      else
+        ff.FF::CalcAdd_1_4(energy, distSq, table.kind1[i], table.kind2[i]);
+      if (electrostatic && table.qi_qj_fact[i] != 0.0)
+        ff.FF::CalcCoulombAdd_1_4(energy, distSq, table.qi_qj_fact[i], oneN);
     }
   }
 }
@@ -1335,12 +2207,9 @@ void CalculateEnergy::EnergyCorrection(SystemPotential& pot,
   double en = 0.0;
   for (uint i = 0; i < mols.GetKindsCount(); ++i) {
     uint numI = molLookup.NumKindInBox(i, box);
-    for (uint j = 0; j < mols.GetKindsCount(); ++j) {
-      uint numJ = molLookup.NumKindInBox(j, box);
-      en += mols.pairEnCorrections[i * mols.GetKindsCount() + j] * numI * numJ
-            * boxAxes.volInv[box];
-    }
+    en += tailEnSum[box * mols.GetKindsCount() + i] * numI;
   }
+  en *= boxAxes.volInv[box];
 
   if(!forcefield.freeEnergy) {
     pot.boxEnergy[box].tc = en;
@@ -1353,18 +2222,11 @@ void CalculateEnergy::EnergyCorrection(SystemPotential& pot,
     //remove the LRC for one molecule with lambda = 1
     en += MoleculeTailChange(box, fk, false).energy;
 
-    //Add the LRC for fractional molecule
-    for (uint i = 0; i < mols.GetKindsCount(); ++i) {
-      uint molNum = molLookup.NumKindInBox(i, box);
-      if(i == fk) {
-        --molNum; // We have one less molecule (it is fractional molecule)
-      }
-      double rhoDeltaIJ_2 = 2.0 * (double)(molNum) * currentAxes.volInv[box];
-      en += lambdaVDW * mols.pairEnCorrections[fk * mols.GetKindsCount() + i] *
-            rhoDeltaIJ_2;
-    }
-    //We already calculated part of the change for this type in the loop
-    en += lambdaVDW * mols.pairEnCorrections[fk * mols.GetKindsCount() + fk] *
+    //Add the LRC for fractional molecule, we have one less molecule of
+    //its own kind and add it back as the self pair term
+    uint fkIdx = fk * mols.GetKindsCount() + fk;
+    en += lambdaVDW * (2.0 * tailEnSum[box * mols.GetKindsCount() + fk] -
+                       mols.pairEnCorrections[fkIdx]) *
           currentAxes.volInv[box];
     pot.boxEnergy[box].tc = en;
   }
@@ -1400,12 +2262,9 @@ void CalculateEnergy::VirialCorrection(Virial& virial,
 
   for (uint i = 0; i < mols.GetKindsCount(); ++i) {
     uint numI = molLookup.NumKindInBox(i, box);
-    for (uint j = 0; j < mols.GetKindsCount(); ++j) {
-      uint numJ = molLookup.NumKindInBox(j, box);
-      vir += mols.pairVirCorrections[i * mols.GetKindsCount() + j] *
-             numI * numJ * boxAxes.volInv[box];
-    }
+    vir += tailVirSum[box * mols.GetKindsCount() + i] * numI;
   }
+  vir *= boxAxes.volInv[box];
 
   if(!forcefield.freeEnergy) {
     virial.tc = vir;
@@ -1418,18 +2277,11 @@ void CalculateEnergy::VirialCorrection(Virial& virial,
     //remove the LRC for one molecule with lambda = 1
     vir += MoleculeTailVirChange(box, fk, false).virial;
 
-    //Add the LRC for fractional molecule
-    for (uint i = 0; i < mols.GetKindsCount(); ++i) {
-      uint molNum = molLookup.NumKindInBox(i, box);
-      if(i == fk) {
-        --molNum; // We have one less molecule (it is fractional molecule)
-      }
-      double rhoDeltaIJ_2 = 2.0 * (double)(molNum) * currentAxes.volInv[box];
-      vir += lambdaVDW * mols.pairVirCorrections[fk * mols.GetKindsCount() + i] *
-              rhoDeltaIJ_2;
-    }
-    //We already calculated part of the change for this type in the loop
-    vir += lambdaVDW * mols.pairVirCorrections[fk * mols.GetKindsCount() + fk] *
+    //Add the LRC for fractional molecule, we have one less molecule of
+    //its own kind and add it back as the self pair term
+    uint fkIdx = fk * mols.GetKindsCount() + fk;
+    vir += lambdaVDW * (2.0 * tailVirSum[box * mols.GetKindsCount() + fk] -
+                        mols.pairVirCorrections[fkIdx]) *
            currentAxes.volInv[box];
     virial.tc = vir;
   }
@@ -1592,7 +2444,8 @@ void CalculateEnergy::SingleMoleculeInter(Energy &interEnOld,
       CellList::Neighbors n = cellList.EnumerateLocal(currentCoords[atom],
                               box);
 
-      std::vector<uint> nIndex;
+      std::vector<uint> &nIndex = ThreadScratch().nIndex;
+      nIndex.clear();
       //store atom index in neighboring cell
       while (!n.Done()) {
         if(particleMol[*n] != (int) molIndex) {
@@ -1605,10 +2458,12 @@ void CalculateEnergy::SingleMoleculeInter(Energy &interEnOld,
 #if GCC_VERSION >= 90000
       #pragma omp parallel for default(none) shared(atom, nIndex, box, \
       lambdaNewCoulomb, lambdaOldCoulomb, lambdaOldVDW, lambdaNewVDW) \
-reduction(+:tempREnOld, tempLJEnOld, tempREnNew, tempLJEnNew)
+reduction(+:tempREnOld, tempLJEnOld, tempREnNew, tempLJEnNew) \
+      if(parallel_grain::Parallel(nIndex.size()))
 #else
       #pragma omp parallel for default(none) shared(atom, nIndex) \
-      reduction(+:tempREnOld, tempLJEnOld, tempREnNew, tempLJEnNew)
+      reduction(+:tempREnOld, tempLJEnOld, tempREnNew, tempLJEnNew) \
+      if(parallel_grain::Parallel(nIndex.size()))
 #endif
 #endif
       for(int i = 0; i < (int) nIndex.size(); i++) {
@@ -1703,18 +2558,20 @@ void CalculateEnergy::EnergyChange(Energy *energyDiff, Energy &dUdL_VDW,
   uint length = mols.GetKind(molIndex).NumAtoms();
   uint start = mols.MolStart(molIndex);
   uint lambdaSize = lambda_VDW.size();
-  double *tempLJEnDiff = new double [lambdaSize];
-  double *tempREnDiff = new double [lambdaSize];
+  Scratch &buf = ThreadScratch();
+  buf.ljEnDiff.assign(lambdaSize, 0.0);
+  buf.realEnDiff.assign(lambdaSize, 0.0);
+  double *tempLJEnDiff = &buf.ljEnDiff[0];
+  double *tempREnDiff = &buf.realEnDiff[0];
   double dudl_VDW = 0.0, dudl_Coul = 0.0;
-  std::fill_n(tempLJEnDiff, lambdaSize, 0.0);
-  std::fill_n(tempREnDiff, lambdaSize, 0.0);
 
   // Calculate the vdw, short range electrostatic energy
   for (uint p = 0; p < length; ++p) {
     uint atom = start + p;
     CellList::Neighbors n = cellList.EnumerateLocal(currentCoords[atom], box);
 
-    std::vector<uint> nIndex;
+    std::vector<uint> &nIndex = ThreadScratch().nIndex;
+    nIndex.clear();
     //store atom index in neighboring cell
     while (!n.Done()) {
       if(particleMol[*n] != (int) molIndex) {
@@ -1727,11 +2584,13 @@ void CalculateEnergy::EnergyChange(Energy *energyDiff, Energy &dUdL_VDW,
 #if GCC_VERSION >= 90000
     #pragma omp parallel for default(none) shared(atom, lambda_Coul, lambda_VDW, \
     lambdaSize, nIndex, box, iState) \
-reduction(+:dudl_VDW, dudl_Coul, tempREnDiff[:lambdaSize], tempLJEnDiff[:lambdaSize])
+reduction(+:dudl_VDW, dudl_Coul, tempREnDiff[:lambdaSize], tempLJEnDiff[:lambdaSize]) \
+    if(parallel_grain::Parallel(nIndex.size() * lambdaSize))
 #else
     #pragma omp parallel for default(none) shared(atom, lambda_Coul, lambda_VDW, \
     lambdaSize, nIndex) \
-reduction(+:dudl_VDW, dudl_Coul, tempREnDiff[:lambdaSize], tempLJEnDiff[:lambdaSize])
+reduction(+:dudl_VDW, dudl_Coul, tempREnDiff[:lambdaSize], tempLJEnDiff[:lambdaSize]) \
+    if(parallel_grain::Parallel(nIndex.size() * lambdaSize))
 #endif
 #endif
     for(int i = 0; i < (int) nIndex.size(); i++) {
@@ -1783,8 +2642,6 @@ reduction(+:dudl_VDW, dudl_Coul, tempREnDiff[:lambdaSize], tempLJEnDiff[:lambdaS
     energyDiff[s].inter += tempLJEnDiff[s];
     energyDiff[s].real += tempREnDiff[s];
   }
-  delete [] tempLJEnDiff;
-  delete [] tempREnDiff;
 
   if (forcefield.useLRC) {
     //Need to calculate change in LRC
@@ -1812,29 +2669,18 @@ void CalculateEnergy::ChangeLRC(Energy *energyDiff, Energy &dUdL_VDW,
   uint fk = mols.GetMolKind(molIndex);
   double lambda_istate = lambda_VDW[iState];
 
-  //Add the LRC for fractional molecule
+  //LRC of the fractional molecule with lambda = 1, we have one less
+  //molecule of its own kind and add it back as the self pair term
+  double tcFull = (2.0 * tailEnSum[box * mols.GetKindsCount() + fk] -
+                   mols.pairEnCorrections[fk * mols.GetKindsCount() + fk]) *
+                  currentAxes.volInv[box];
+
   for(size_t s = 0; s < lambda_VDW.size(); s++) {
     double lambdaVDW = lambda_VDW[s];
-    for (uint i = 0; i < mols.GetKindsCount(); ++i) {
-      uint molNum = molLookup.NumKindInBox(i, box);
-      if(i == fk) {
-        --molNum; // We have one less molecule (it is fractional molecule)
-      }
-      double rhoDeltaIJ_2 = 2.0 * (double)(molNum) * currentAxes.volInv[box];
-      energyDiff[s].tc += mols.pairEnCorrections[fk * mols.GetKindsCount() + i] *
-                          rhoDeltaIJ_2 * (lambdaVDW - lambda_istate);
-      if(s == iState) {
-        //Calculate du/dl in VDW LRC for current state
-        dUdL_VDW.tc += mols.pairEnCorrections[fk * mols.GetKindsCount() + i] *
-                       rhoDeltaIJ_2;
-      }
-    }
-    energyDiff[s].tc += mols.pairEnCorrections[fk * mols.GetKindsCount() + fk] *
-                        currentAxes.volInv[box] * (lambdaVDW - lambda_istate);
+    energyDiff[s].tc += tcFull * (lambdaVDW - lambda_istate);
     if(s == iState) {
       //Calculate du/dl in VDW LRC for current state
-      dUdL_VDW.tc += mols.pairEnCorrections[fk * mols.GetKindsCount() + fk] *
-                     currentAxes.volInv[box];
+      dUdL_VDW.tc += tcFull;
     }
   }
 }
@@ -13,6 +13,8 @@ along with this program, also can be found at <https://opensource.org/licenses/M
 #include "Ewald.h"
 #include "NoEwald.h"
 #include "CellList.h"
+#include "SimdPairKernel.h"
+#include "VerletList.h"
 
 #include <vector>
 
@@ -57,11 +59,21 @@ public:
   //! Calculates total energy/virial of all boxes in the system
   SystemPotential SystemTotal() ;
 
-  //! Calculates total energy/virial of a single box in the system
+  //! Switches the box pair energies between the single precision kernel,
+  //! if the MixedPrecision engine is active, and double precision
+  void SetMixedPrecision(const bool enable)
+  {
+    mixedPrecision = enable && mixedPrecisionReady;
+  }
+
+  //! Calculates total energy/virial of a single box in the system. If
+  //! pairVirial is given, the pair part of the virial of the box is
+  //! accumulated into it, for FinishVirial.
   SystemPotential BoxInter(SystemPotential potential,
                            XYZArray const& coords,
                            BoxDimensions const& boxAxes,
-                           const uint box);
+                           const uint box,
+                           Virial* pairVirial = NULL);
 
   //! Calculates force of a single box in the system
   SystemPotential BoxForce(SystemPotential potential,
@@ -74,6 +86,13 @@ public:
   //! Calculate force and virial for the box
   Virial VirialCalc(const uint box);
 
+  //! Adds the pair (LJ and real space) virial tensors of box to tempVir
+  void PairVirial(Virial &tempVir, const uint box);
+
+  //! Scales and traces the pair virial of box and adds the corrections and
+  //! the reciprocal term. VirialCalc is PairVirial followed by FinishVirial.
+  Virial FinishVirial(Virial tempVir, const uint box);
+
   //! Set the force for atom and mol to zero for box
   void ResetForce(XYZArray& atomForce, XYZArray& molForce, uint box);
 
@@ -85,7 +104,8 @@ public:
   //! @return System potential assuming no molecule changes
   SystemPotential SystemInter(SystemPotential potential,
                               XYZArray const& coords,
-                              BoxDimensions const& boxAxes) ;
+                              BoxDimensions const& boxAxes,
+                              Virial* pairVirial = NULL) ;
 
   //! Calculates intermolecular energy (LJ and coulomb) of a molecule
   //!                           were it at molCoords.
@@ -99,6 +119,33 @@ public:
                      XYZArray const& molCoords, const uint molIndex,
                      const uint box) const;
 
+  //! With the EnergyLedger keyword, MoleculeInter takes the old energy of
+  //! the molecule from a per-molecule ledger instead of a second pair pass.
+  //! Updates the ledger for the accepted move of molIndex tried by the last
+  //! MoleculeInter call. Call it while molIndex is still removed from the
+  //! cell list and before its new coordinates are copied.
+  void LedgerAccept(const uint molIndex, const uint box);
+
+  //! Marks the ledger stale after a move that changed the system without
+  //! updating it, so the next MoleculeInter rebuilds it
+  void InvalidateLedger();
+
+  bool LedgerEnabled() const
+  {
+    return energyLedger;
+  }
+
+  //! LJ energy change of molIndex moving to molCoords over the pairs closer
+  //! than RcutSurrogate, for the first stage of the two-stage acceptance of
+  //! displacements and rotations. Returns true on an overlap.
+  bool MoleculeSurrogate(double &energy, XYZArray const& molCoords,
+                         const uint molIndex, const uint box) const;
+
+  bool SurrogateEnabled() const
+  {
+    return forcefield.rCutSurrogateSq > 0.0;
+  }
+
   //! Calculates Nonbonded intra energy (LJ and coulomb )for
   //!                       candidate positions
   //! @param energy Return array, must be pre-allocated to size n
@@ -107,11 +154,14 @@ public:
   //! @param partIndex Index of particle within the molecule
   //! @param box Index of box molecule is in
   //! @param trials Number of trials to loop over in position array. (cbmc)
+  //! @param overlap (optional) Overlap flags of ParticleInter, the trials
+  //!                           it dropped are skipped
   void ParticleNonbonded(double* inter, const cbmc::TrialMol& trialMol,
                          XYZArray const& trialPos,
                          const uint partIndex,
                          const uint box,
-                         const uint trials) const;
+                         const uint trials,
+                         const bool* overlap = NULL) const;
 
 
   //! Calculates Nonbonded inter energy (LJ and coulomb)for
@@ -122,6 +172,9 @@ public:
   //! @param molIndex Index of molecule
   //! @param box Index of box molecule is in
   //! @param trials Number of trials to loop over in position array. (cbmc)
+  //! With DropOverlapTrials, a trial closer than rCutLow to another atom
+  //! stops its pair loop and gets an infinite energy, so its weight is 0.
+  //! Trials already flagged in overlap are not evaluated again.
   void ParticleInter(double* en, double *real,
                      XYZArray const& trialPos,
                      bool* overlap,
@@ -189,6 +242,11 @@ public:
   //!Calculates energy corrections for the box
   double EnergyCorrection(const uint box, const uint *kCount) const;
 
+  //! Moves one molecule of a kind between the running tail sums of two
+  //! boxes. Called next to every MoleculeLookup::ShiftMolBox.
+  void ShiftTailSums(const uint kind, const uint fromBox,
+                     const uint intoBox);
+
   //Calculate inter energy for single molecule in the system.
   void SingleMoleculeInter(Energy &interEnOld, Energy &interEnNew,
                            const double lambdaOldVDW,
@@ -213,6 +271,9 @@ private:
   void VirialCorrection(Virial& virial, BoxDimensions const& boxAxes,
                         const uint box) const;
 
+  //! Rebuilds the running tail sums from the molecule counts
+  void InitTailSums();
+
 
   //! Calculates bond vectors of a full molecule, stores them in vecs
   void BondVectors(XYZArray & vecs,
@@ -298,6 +359,278 @@ private:
   double GetLambdaCoulomb(uint molA, uint molB, uint box) const;
   uint NumberOfParticlesInsideBox(uint box);
 
+  //! Sizes the per-thread scratch buffers
+  void InitScratch();
+
+  //! Selects the pair kernels matching the type of forcefield.particles
+  void SelectPairKernels();
+
+  //! Points the pair kernels at the instantiation for particle type FF
+  template <class FF>
+  void SetPairKernels();
+
+  //! Terms computed by one pass of the box pair loop
+  enum BoxPairTerm { PAIR_ENERGY = 1, PAIR_VIRIAL = 2, PAIR_FORCE = 4,
+                     PAIR_TERMS = 8
+                   };
+
+  //! Template helper of SetPairKernels for one combination of terms
+  template <class FF, int TERMS>
+  void SetBoxPairKernels();
+
+  //! Runs the box pair loop of box once for the terms (a mask of
+  //! BoxPairTerm): energies into tempREn and tempLJEn, the diagonal pair
+  //! virial into tempVir and forces into atomForce and molForce, which may
+  //! be NULL without PAIR_FORCE.
+  void BoxPairs(const int terms, double &tempREn, double &tempLJEn,
+                Virial &tempVir, XYZArray const& coords, XYZArray* atomForce,
+                XYZArray* molForce, BoxDimensions const& boxAxes,
+                const uint box);
+
+  //! Pair loops of BoxPairs, MoleculeInter and ParticleInter. They are
+  //! templated on the concrete FFParticle type, so the pair potential calls
+  //! are resolved at compile time and can be inlined, instead of going
+  //! through the vtable for every pair. Geom is OrthGeometry or
+  //! NonOrthGeometry (BoxGeometry.h) and supplies the minimum image and
+  //! cutoff test for the box. TERMS selects what the box kernels compute,
+  //! so energy, virial and force share the distance and the potential
+  //! evaluation of a pair. With halfShell the box kernels walk
+  //! CellList::HalfStencil instead of the 27 neighbor cells.
+  template <class FF, class Geom, int TERMS>
+  void BoxPairKernel(double &tempREn, double &tempLJEn, Virial &tempVir,
+                     XYZArray const& coords, XYZArray* atomForce,
+                     XYZArray* molForce, BoxDimensions const& boxAxes,
+                     const uint box, std::vector<int> const& cellVector,
+                     std::vector<int> const& cellStartIndex,
+                     std::vector<int> const& mapParticleToCell,
+                     std::vector<int> const& neighborList,
+                     const bool halfShell) const;
+
+  //! Same pair sums as BoxPairKernel, over the pairs of verletList instead
+  //! of the 27 neighbor cells
+  template <class FF, class Geom, int TERMS>
+  void ListBoxPairKernel(double &tempREn, double &tempLJEn, Virial &tempVir,
+                         XYZArray const& coords, XYZArray* atomForce,
+                         XYZArray* molForce, BoxDimensions const& boxAxes,
+                         const uint box) const;
+
+  //! Terms of one pair of the box kernels. vT and rT are the diagonals of
+  //! the LJ and real space virial tensors.
+  template <class FF, class Geom, int TERMS>
+  void PairTerms(FF const& ff, Geom const& geom, XYZArray const& coords,
+                 const int currParticle, const int nParticle, const uint box,
+                 double &sumREn, double &sumLJEn, double *vT, double *rT,
+                 double *aForcex, double *aForcey, double *aForcez,
+                 double *mForcex, double *mForcey, double *mForcez) const;
+
+  //! Stores the diagonal virial sums of the box kernels in tempVir
+  void SetPairVirial(Virial &tempVir, const double *vT,
+                     const double *rT) const;
+
+  //! With COMScreen, a sphere around the atoms [start, start + len) of
+  //! coords, centered on their unwrapped centroid
+  template <class Geom>
+  void ScreenSphere(XYZ &center, double &radius, Geom const& geom,
+                    XYZArray const& coords, const uint start,
+                    const uint len) const;
+
+  //! False if no atom of molecule mol can be within reach of center, using
+  //! its COM and the radius of its kind. The answer is kept in the thread
+  //! scratch under flag until ClearScreen.
+  template <class Geom>
+  bool ScreenMol(Geom const& geom, XYZ const& center, const double reach,
+                 const uint mol, const unsigned char flag) const;
+  void ClearScreen() const;
+
+  template <class FF, class Geom>
+  bool MoleculeInterKernel(Intermolecular &inter_LJ,
+                           Intermolecular &inter_coulomb,
+                           XYZArray const& molCoords, const uint molIndex,
+                           const uint box) const;
+
+  //! Pair energies of the atoms of molIndex at coords[first], ... with the
+  //! atoms of the other molecules in the cell list of box. If scatter is
+  //! not 0, scatter times each pair energy is also added to the ledger
+  //! difference of the other molecule. Returns true on an overlap, at once
+  //! with stopOnOverlap, leaving the sums partial.
+  template <class FF, class Geom>
+  bool MoleculePairsKernel(XYZArray const& coords, const uint first,
+                           const uint molIndex, const uint box,
+                           double &ljEn, double &realEn,
+                           const double scatter,
+                           const bool stopOnOverlap) const;
+
+  //! Intramolecular nonbonded pairs of table, with the 1-N scaling if oneN
+  //! and the 1-4 scaling otherwise. The atoms are at coords[start + part].
+  //! With mol, pairs with an atom not yet placed in mol are skipped.
+  template <class FF, class Geom>
+  void MolNonbondKernel(double &energy, NonbondTable const& table,
+                        XYZArray const& coords, const uint start,
+                        const uint box, const bool oneN,
+                        cbmc::TrialMol const* mol) const;
+
+  template <class FF, class Geom>
+  void ParticleNonbondedKernel(double* inter, cbmc::TrialMol const& trialMol,
+                               XYZArray const& trialPos,
+                               const uint partIndex, const uint box,
+                               const uint trials,
+                               const bool* overlap) const;
+
+  template <class FF, class Geom>
+  bool MoleculeSurrogateKernel(double &energy, XYZArray const& molCoords,
+                               const uint molIndex, const uint box) const;
+
+  template <class FF, class Geom>
+  void ParticleInterKernel(double* en, double *real,
+                           XYZArray const& trialPos, bool* overlap,
+                           const uint partIndex, const uint molIndex,
+                           const uint box, const uint trials) const;
+
+  typedef void (CalculateEnergy::*BoxPairKernelFn)(double&, double&,
+      Virial&, XYZArray const&, XYZArray*, XYZArray*, BoxDimensions const&,
+      const uint, std::vector<int> const&, std::vector<int> const&,
+      std::vector<int> const&, std::vector<int> const&, const bool) const;
+  typedef void (CalculateEnergy::*ListBoxPairKernelFn)(double&, double&,
+      Virial&, XYZArray const&, XYZArray*, XYZArray*, BoxDimensions const&,
+      const uint) const;
+  typedef bool (CalculateEnergy::*MoleculeInterKernelFn)(Intermolecular&,
+      Intermolecular&, XYZArray const&, const uint, const uint) const;
+  typedef bool (CalculateEnergy::*MoleculePairsKernelFn)(XYZArray const&,
+      const uint, const uint, const uint, double&, double&,
+      const double, const bool) const;
+  typedef bool (CalculateEnergy::*MoleculeSurrogateKernelFn)(double&,
+      XYZArray const&, const uint, const uint) const;
+  typedef void (CalculateEnergy::*MolNonbondKernelFn)(double&,
+      NonbondTable const&, XYZArray const&, const uint, const uint,
+      const bool, cbmc::TrialMol const*) const;
+  typedef void (CalculateEnergy::*ParticleNonbondedKernelFn)(double*,
+      cbmc::TrialMol const&, XYZArray const&, const uint, const uint,
+      const uint, const bool*) const;
+  typedef void (CalculateEnergy::*ParticleInterKernelFn)(double*, double*,
+      XYZArray const&, bool*, const uint, const uint, const uint,
+      const uint) const;
+
+  //! Kernels indexed by GeomIndex: 0 orthogonal, 1 non-orthogonal box. The
+  //! box kernels are first indexed by the BoxPairTerm mask.
+  BoxPairKernelFn boxPairKernel[PAIR_TERMS][2];
+  ListBoxPairKernelFn listBoxPairKernel[PAIR_TERMS][2];
+  MoleculeInterKernelFn moleculeInterKernel[2];
+  MoleculePairsKernelFn moleculePairsKernel[2];
+  MoleculeSurrogateKernelFn moleculeSurrogateKernel[2];
+  MolNonbondKernelFn molNonbondKernel[2];
+  ParticleNonbondedKernelFn particleNonbondedKernel[2];
+  ParticleInterKernelFn particleInterKernel[2];
+
+  uint GeomIndex(BoxDimensions const& boxAxes, const uint box) const
+  {
+    return boxAxes.orthogonal[box] ? 0 : 1;
+  }
+
+  //! Enables the SIMD box pair kernel if the CPU and the potential support
+  //! it and it reproduces the scalar BoxInter energies of the initial system
+  void InitSimdKernel();
+
+  bool UseSimdKernel(BoxDimensions const& boxAxes, const uint box) const
+  {
+    return simdIsa != simd::ISA_NONE && boxAxes.orthogonal[box];
+  }
+
+  //! True if the box pair loops can use the half shell stencil of box
+  bool UseHalfShell(const uint box) const
+  {
+    return forcefield.halfShell && !cellList.HalfStencil(box).empty();
+  }
+
+  bool UseVerletList() const
+  {
+    return verletList.Enabled();
+  }
+
+  //! Rebuilds the Verlet pair list of box if an atom of coords moved too far
+  void UpdateVerletList(XYZArray const& coords, BoxDimensions const& boxAxes,
+                        const uint box);
+
+  //! Checks the single precision box pair kernel against the scalar one on
+  //! the initial system and enables it if the energies agree
+  void InitMixedPrecision();
+
+  //! Copies the particle data of box into simdAtoms in cell order, in
+  //! single precision for the mixed precision kernel
+  void FillSimdAtoms(XYZArray const& coords, BoxDimensions const& boxAxes,
+                     const uint box, std::vector<int> const& cellVector,
+                     simd::BoxParams &boxPar, const bool single);
+
+  //! Vectorized energy and force versions of BoxPairKernel for an
+  //! orthogonal box. Pairs with the fractional molecule are done in scalar.
+  //! With single the pair energies are computed in single precision.
+  void SimdBoxInter(double &tempREn, double &tempLJEn, XYZArray const& coords,
+                    BoxDimensions const& boxAxes, const uint box,
+                    std::vector<int> const& cellVector,
+                    std::vector<int> const& cellStartIndex,
+                    std::vector<int> const& mapParticleToCell,
+                    std::vector<int> const& neighborList, const bool single);
+
+  void SimdBoxForce(double &tempREn, double &tempLJEn, XYZArray const& coords,
+                    XYZArray& atomForce, XYZArray& molForce,
+                    BoxDimensions const& boxAxes, const uint box,
+                    std::vector<int> const& cellVector,
+                    std::vector<int> const& cellStartIndex,
+                    std::vector<int> const& mapParticleToCell,
+                    std::vector<int> const& neighborList);
+
+  //! Pairs of the fractional molecule with the rest of the box, which the
+  //! SIMD kernel skips because they need lambda. Forces are added if
+  //! atomForce is not NULL.
+  void FractionalPairs(double &tempREn, double &tempLJEn,
+                       XYZArray const& coords, XYZArray* atomForce,
+                       XYZArray* molForce, BoxDimensions const& boxAxes,
+                       const uint box, std::vector<int> const& cellVector,
+                       std::vector<int> const& cellStartIndex,
+                       std::vector<int> const& mapParticleToCell,
+                       std::vector<int> const& neighborList) const;
+
+  simd::Isa simdIsa;
+  simd::PairParams simdParams;
+  simd::CellAtoms simdAtoms;
+  //! The single precision kernel passed its check, and is in use
+  bool mixedPrecisionReady, mixedPrecision;
+
+  bool MoleculePairs(XYZArray const& coords, const uint first,
+                     const uint molIndex, const uint box, double &ljEn,
+                     double &realEn, const double scatter,
+                     const bool stopOnOverlap = false) const
+  {
+    MoleculePairsKernelFn kernel =
+      moleculePairsKernel[GeomIndex(currentAxes, box)];
+    return (this->*kernel)(coords, first, molIndex, box, ljEn, realEn,
+                           scatter, stopOnOverlap);
+  }
+
+  //! Recomputes the ledger of box. molIndex is the molecule removed from
+  //! the cell list by the move in progress.
+  void RebuildLedger(const uint molIndex, const uint box) const;
+
+  //! Adds the ledger differences to the ledger and clears them
+  void ApplyLedgerDiff() const;
+  void ClearLedgerDiff() const;
+
+  //! Per-molecule intermolecular LJ and real space energies of the
+  //! EnergyLedger keyword, by molecule index
+  bool energyLedger;
+  mutable std::vector<double> ledgerLJ, ledgerReal;
+  mutable bool ledgerValid[BOX_TOTAL];
+  //! Pair energy changes of the neighbor molecules of the last
+  //! MoleculeInter trial, and the molecules which have one
+  mutable std::vector<double> ledgerDiffLJ, ledgerDiffReal;
+  mutable std::vector<char> ledgerHasDiff;
+  mutable std::vector<uint> ledgerDiffMols;
+  //! New energies of the molecule of the last MoleculeInter trial
+  mutable double ledgerNewLJ, ledgerNewReal;
+
+  VerletList verletList;
+  //! Atoms of the box for verletList, reused between calls
+  std::vector<int> verletAtoms;
+
 
   const Forcefield& forcefield;
   const Molecules& mols;
@@ -321,6 +654,38 @@ private:
   const MoleculeLookup& molLookup;
   const BoxDimensions& currentAxes;
   const CellList& cellList;
+
+  //! Running tail sums, [box * kinds + k] holds the sum over kinds j of
+  //! mols.pairEnCorrections[k][j] * N_j(box), so the tail change of one
+  //! molecule is O(1) and the box tail is O(kinds)
+  std::vector<double> tailEnSum, tailVirSum;
+
+  //! Reusable buffers of the molecule energy paths, one set per OpenMP
+  //! thread. They are sized in Init and only grow after that, so the
+  //! steady state Monte Carlo loop does not allocate.
+  //! Scratch::molScreen flags of the old and new configuration in
+  //! MoleculeInter, the next bit tells if the molecule is near
+  enum { SCREEN_OLD = 1, SCREEN_NEW = 4 };
+
+  struct Scratch {
+    std::vector<uint> nIndex;
+    //COMScreen state of each molecule and the molecules that have one
+    std::vector<unsigned char> molScreen;
+    std::vector<uint> screened;
+    std::vector<double> ljEnDiff, realEnDiff;
+    std::vector<bool> bondExist;
+    XYZArray bondVec;
+  };
+  mutable std::vector<Scratch> scratch;
+
+  Scratch& ThreadScratch() const
+  {
+#ifdef _OPENMP
+    return scratch[omp_get_thread_num()];
+#else
+    return scratch[0];
+#endif
+  }
 };
 
 #endif /*ENERGY_H*/
@@ -34,6 +34,12 @@ ConfigSetup::ConfigSetup(void)
   sys.elect.ewald = false;
   sys.elect.enable = false;
   sys.elect.cache = false;
+  sys.elect.ewaldTable = false;
+  sys.elect.ewaldTableAccuracy = 1.0e-9;
+  sys.elect.ewaldRecurrence = false;
+  sys.elect.spme = false;
+  sys.elect.wolf = false;
+  sys.elect.wolfDSF = false;
   sys.elect.tolerance = DBL_MAX;
   sys.elect.oneFourScale = DBL_MAX;
   sys.elect.dielectric = DBL_MAX;
@@ -74,6 +80,16 @@ ConfigSetup::ConfigSetup(void)
   sys.ff.VDW_KIND = UINT_MAX;
   sys.ff.doTailCorr = true;
   sys.ff.doImpulsePressureCorr = false;
+  sys.ff.simdKernel = false;
+  sys.ff.verletSkin = 0.0;
+  sys.ff.halfShell = false;
+  sys.ff.mixedPrecision = false;
+  sys.ff.mixedPrecisionFreq = 10000;
+  sys.ff.parallelGrain = -1;
+  sys.ff.energyLedger = false;
+  sys.ff.cutoffSurrogate = 0.0;
+  sys.ff.dropOverlapTrials = false;
+  sys.ff.comScreen = false;
   sys.ff.rswitch = DBL_MAX;
   sys.ff.cutoff = DBL_MAX;
   sys.ff.cutoffLow = DBL_MAX;
@@ -412,6 +428,50 @@ void ConfigSetup::Init(const char *fileName, MultiSim const*const& multisim)
         printf("%-40s %-s \n", "Info: Impulse Pressure Correction", "Active");
       else
         printf("%-40s %-s \n", "Info: Impulse Pressure Correction", "Inactive");
+    } else if(CheckString(line[0], "SIMDKernel")) {
+      sys.ff.simdKernel = checkBool(line[1]);
+      if(sys.ff.simdKernel)
+        printf("%-40s %-s \n", "Info: SIMD box pair kernel", "Active");
+      else
+        printf("%-40s %-s \n", "Info: SIMD box pair kernel", "Inactive");
+    } else if(CheckString(line[0], "VerletSkin")) {
+      sys.ff.verletSkin = stringtod(line[1]);
+      if(sys.ff.verletSkin > 0.0)
+        printf("%-40s %-4.4f A \n", "Info: Verlet pair list skin", sys.ff.verletSkin);
+      else
+        printf("%-40s %-s \n", "Info: Verlet pair list", "Inactive");
+    } else if(CheckString(line[0], "HalfShell")) {
+      sys.ff.halfShell = checkBool(line[1]);
+      if(sys.ff.halfShell)
+        printf("%-40s %-s \n", "Info: Half shell cell stencil", "Active");
+      else
+        printf("%-40s %-s \n", "Info: Half shell cell stencil", "Inactive");
+    } else if(CheckString(line[0], "MixedPrecision")) {
+      sys.ff.mixedPrecision = checkBool(line[1]);
+      if(line.size() >= 3)
+        sys.ff.mixedPrecisionFreq = stringtoi(line[2]);
+      if(sys.ff.mixedPrecision) {
+        if(sys.ff.mixedPrecisionFreq == 0) {
+          std::cout << "Error: MixedPrecision recalculation frequency must be "
+                    "greater than zero!\n";
+          exit(EXIT_FAILURE);
+        }
+        printf("%-40s %-s \n", "Info: Mixed precision energy engine", "Active");
+        printf("%-40s %-lu \n", "Info: Double precision recalculation freq",
+               sys.ff.mixedPrecisionFreq);
+      } else
+        printf("%-40s %-s \n", "Info: Mixed precision energy engine", "Inactive");
+    } else if(CheckString(line[0], "ParallelGrain")) {
+      sys.ff.parallelGrain = stringtoi(line[1]);
+      if(sys.ff.parallelGrain >= 0)
+        printf("%-40s %-d pairs\n", "Info: Parallel loop grain",
+               sys.ff.parallelGrain);
+    } else if(CheckString(line[0], "EnergyLedger")) {
+      sys.ff.energyLedger = checkBool(line[1]);
+      if(sys.ff.energyLedger)
+        printf("%-40s %-s \n", "Info: Molecule energy ledger", "Active");
+      else
+        printf("%-40s %-s \n", "Info: Molecule energy ledger", "Inactive");
     } else if(CheckString(line[0], "Rswitch")) {
       sys.ff.rswitch = stringtod(line[1]);
       printf("%-40s %-4.4f \n", "Info: Switch distance", sys.ff.rswitch);
@@ -640,6 +700,25 @@ void ConfigSetup::Init(const char *fileName, MultiSim const*const& multisim)
     } else if(CheckString(line[0], "RcutLow")) {
       sys.ff.cutoffLow = stringtod(line[1]);
       printf("%-40s %-4.4lf A\n", "Info: Short Range Cutoff", sys.ff.cutoffLow);
+    } else if(CheckString(line[0], "DropOverlapTrials")) {
+      sys.ff.dropOverlapTrials = checkBool(line[1]);
+      if(sys.ff.dropOverlapTrials)
+        printf("%-40s %-s \n", "Info: Drop overlapping CBMC trials", "Active");
+      else
+        printf("%-40s %-s \n", "Info: Drop overlapping CBMC trials", "Inactive");
+    } else if(CheckString(line[0], "COMScreen")) {
+      sys.ff.comScreen = checkBool(line[1]);
+      if(sys.ff.comScreen)
+        printf("%-40s %-s \n", "Info: Molecule COM pre-screening", "Active");
+      else
+        printf("%-40s %-s \n", "Info: Molecule COM pre-screening", "Inactive");
+    } else if(CheckString(line[0], "RcutSurrogate")) {
+      sys.ff.cutoffSurrogate = stringtod(line[1]);
+      if(sys.ff.cutoffSurrogate > 0.0)
+        printf("%-40s %-4.4lf A\n", "Info: Two-stage acceptance cutoff",
+               sys.ff.cutoffSurrogate);
+      else
+        printf("%-40s %-s \n", "Info: Two-stage acceptance", "Inactive");
     } else if(CheckString(line[0], "Exclude")) {
       if(line[1] == sys.exclude.EXC_ONETWO) {
         sys.exclude.EXCLUDE_KIND = sys.exclude.EXC_ONETWO_KIND;
@@ -685,6 +764,48 @@ void ConfigSetup::Init(const char *fileName, MultiSim const*const& multisim)
       } else {
         printf("%-40s %-s \n", "Info: Cache Ewald Fourier", "Inactive");
       }
+    } else if(CheckString(line[0], "EwaldTable")) {
+      sys.elect.ewaldTable = checkBool(line[1]);
+      if(line.size() > 2)
+        sys.elect.ewaldTableAccuracy = stringtod(line[2]);
+      if(sys.elect.ewaldTable) {
+        printf("%-40s %-s \n", "Info: Ewald real space table", "Active");
+        printf("%-40s %-1.3E \n", "Info: Ewald real space table accuracy",
+               sys.elect.ewaldTableAccuracy);
+      } else {
+        printf("%-40s %-s \n", "Info: Ewald real space table", "Inactive");
+      }
+    } else if(CheckString(line[0], "EwaldRecurrence")) {
+      sys.elect.ewaldRecurrence = checkBool(line[1]);
+      if(sys.elect.ewaldRecurrence) {
+        printf("%-40s %-s \n", "Info: Ewald phase recurrence", "Active");
+      } else {
+        printf("%-40s %-s \n", "Info: Ewald phase recurrence", "Inactive");
+      }
+    } else if(CheckString(line[0], "SPME")) {
+      sys.elect.spme = checkBool(line[1]);
+      if(sys.elect.spme) {
+        printf("%-40s %-s \n", "Info: Smooth particle mesh Ewald", "Active");
+      } else {
+        printf("%-40s %-s \n", "Info: Smooth particle mesh Ewald", "Inactive");
+      }
+    } else if(CheckString(line[0], "Wolf")) {
+      sys.elect.wolf = checkBool(line[1]);
+      if(line.size() > 2) {
+        if(CheckString(line[2], "DSF")) {
+          sys.elect.wolfDSF = true;
+        } else if(!CheckString(line[2], "Wolf")) {
+          std::cout << "Error: Wolf summation kind " << line[2]
+                    << " is not supported! Use Wolf or DSF." << std::endl;
+          exit(EXIT_FAILURE);
+        }
+      }
+      if(sys.elect.wolf) {
+        printf("%-40s %-s \n", "Info: Wolf summation",
+               sys.elect.wolfDSF ? "Active (damped shifted force)" : "Active");
+      } else {
+        printf("%-40s %-s \n", "Info: Wolf summation", "Inactive");
+      }
     } else if(CheckString(line[0], "1-4scaling")) {
       sys.elect.oneFourScale = stringtod(line[1]);
     } else if(CheckString(line[0], "Dielectric")) {
@@ -1585,6 +1706,36 @@ void ConfigSetup::fillDefaults(void)
     printf("Warning: Cache Ewald Fourier set, but will be ignored: Ewald method off.\n");
   }
 
+  if (sys.elect.ewald == false && sys.elect.wolf == true) {
+    printf("Warning: Wolf summation set, but will be ignored: Ewald method off.\n");
+    sys.elect.wolf = false;
+  } else if (sys.elect.wolf == true) {
+    if (sys.elect.spme == true) {
+      printf("Warning: SPME set, but will be ignored: Wolf summation on.\n");
+      sys.elect.spme = false;
+    }
+    if (sys.elect.cache == true) {
+      printf("Warning: Cache Ewald Fourier set, but will be ignored: Wolf summation on.\n");
+      sys.elect.cache = false;
+    }
+  }
+
+  if (sys.elect.ewald == false && sys.elect.spme == true) {
+    printf("Warning: SPME set, but will be ignored: Ewald method off.\n");
+  } else if (sys.elect.spme == true && sys.elect.cache == true) {
+    printf("Warning: Cache Ewald Fourier set, but will be ignored: SPME on.\n");
+  }
+#ifdef GOMC_CUDA
+  if (sys.elect.spme == true) {
+    printf("Warning: SPME is not available on the GPU, Ewald will be used.\n");
+    sys.elect.spme = false;
+  }
+  if (sys.elect.wolf == true) {
+    printf("Warning: Wolf summation is not available on the GPU, Ewald will be used.\n");
+    sys.elect.wolf = false;
+  }
+#endif
+
   if(sys.elect.enable && sys.elect.dielectric == DBL_MAX && in.ffKind.isMARTINI) {
     sys.elect.dielectric = 15.0f;
     printf("%-40s %-4.4f \n", "Default: Dielectric", sys.elect.dielectric);
@@ -159,6 +159,16 @@ struct FFValues {
   uint VDW_KIND;
   double cutoff, cutoffLow, rswitch;
   bool doTailCorr, vdwGeometricSigma, doImpulsePressureCorr;
+  bool simdKernel;
+  double verletSkin;
+  bool halfShell;
+  bool mixedPrecision;
+  ulong mixedPrecisionFreq;
+  int parallelGrain;
+  bool energyLedger;
+  double cutoffSurrogate;
+  bool dropOverlapTrials;
+  bool comScreen;
   std::string kind;
 
   static const std::string VDW, VDW_SHIFT, VDW_SWITCH, VDW_EXP6;
@@ -204,8 +214,14 @@ struct ElectroStatic {
   bool enable;
   bool ewald;
   bool cache;
+  bool ewaldTable;
+  bool ewaldRecurrence;
+  bool spme;
+  bool wolf;
+  bool wolfDSF;
   bool cutoffCoulombRead[BOX_TOTAL];
   double tolerance;
+  double ewaldTableAccuracy;
   double oneFourScale;
   double dielectric;
   double cutoffCoulomb[BOX_TOTAL];
@@ -18,6 +18,7 @@ along with this program, also can be found at <https://opensource.org/licenses/M
 #include "TrialMol.h"
 #include "GeomLib.h"
 #include "NumLib.h"
+#include "ParallelGrain.h"
 #include <cassert>
 #ifdef GOMC_CUDA
 #include "CalculateEwaldCUDAKernel.cuh"
@@ -37,6 +38,19 @@ along with this program, also can be found at <https://opensource.org/licenses/M
 
 using namespace geom;
 
+namespace
+{
+//sin and cos of x in single precision, for the MixedPrecision engine. x is
+//reduced to [-PI, PI] in double first, so the float argument keeps its
+//precision for large k.r
+inline void SinCosSingle(const double x, double &s, double &c)
+{
+  float xf = (float)(x - 2.0 * M_PI * rint(x * (0.5 * M_1_PI)));
+  s = sinf(xf);
+  c = cosf(xf);
+}
+}
+
 Ewald::Ewald(StaticVals & stat, System & sys) :
   ff(stat.forcefield), mols(stat.mol), currentCoords(sys.coordinates),
 #ifdef VARIABLE_PARTICLE_NUMBER
@@ -53,11 +67,14 @@ Ewald::Ewald(StaticVals & stat, System & sys) :
   recip_rcut = 0.0;
   recip_rcut_Sq = 0.0;
   multiParticleEnabled = stat.multiParticleEnabled;
+  phaseFactors = false;
+  kmax = NULL;
 }
 
 Ewald::~Ewald()
 {
-  if(ff.ewald) {
+  //nothing is allocated by the subclasses without reciprocal space
+  if(ff.ewald && kmax != NULL) {
 #ifdef GOMC_CUDA
     DestroyEwaldCUDAVars(ff.particles->getCUDAVars());
 #endif
@@ -76,6 +93,8 @@ Ewald::~Ewald()
       delete[] sumInew[b];
       delete[] sumRref[b];
       delete[] sumIref[b];
+      delete[] kIdx[b];
+      delete[] kIdxRef[b];
     }
 
     delete[] kmax;
@@ -93,6 +112,8 @@ Ewald::~Ewald()
     delete[] sumInew;
     delete[] sumRref;
     delete[] sumIref;
+    delete[] kIdx;
+    delete[] kIdxRef;
     delete[] imageSize;
     delete[] imageSizeRef;
   }
@@ -123,6 +144,9 @@ void Ewald::Init()
     lengthMol[atom] = mols.MolLength(particleMol[atom]);
   }
 
+  if(ff.ewaldRecurrence)
+    phaseFactors = true;
+
   AllocMem();
   //initialize K vectors and reciprocal terms
   UpdateVectorsAndRecipTerms(true);
@@ -161,6 +185,8 @@ void Ewald::AllocMem()
   kzRef = new double*[BOXES_WITH_U_NB];
   hsqrRef = new double*[BOXES_WITH_U_NB];
   prefactRef = new double*[BOXES_WITH_U_NB];
+  kIdx = new int*[BOXES_WITH_U_NB];
+  kIdxRef = new int*[BOXES_WITH_U_NB];
 
   for(uint b = 0; b < BOXES_WITH_U_NB; b++) {
     RecipCountInit(b, currentAxes);
@@ -183,6 +209,8 @@ void Ewald::AllocMem()
     sumInew[b] = new double[imageTotal];
     sumRref[b] = new double[imageTotal];
     sumIref[b] = new double[imageTotal];
+    kIdx[b] = new int[3 * imageTotal];
+    kIdxRef[b] = new int[3 * imageTotal];
   }
 
 #ifdef GOMC_CUDA
@@ -191,6 +219,64 @@ void Ewald::AllocMem()
 }
 
 
+//Per-atom phase factors of the k-grid. For every axis d the slot holds
+//e^{i n u} for n = 0..phaseMax, with u = Dot(phaseAxis[d], r), built by
+//complex multiplication from a single sin and cos of u.
+void Ewald::PhaseSetup(XYZArray const& coords, const uint first,
+                       const uint length, const uint slot, const uint box,
+                       const bool ref) const
+{
+  const XYZ *axis = ref ? phaseAxisRef[box] : phaseAxis[box];
+  const int *nMax = ref ? phaseMaxRef[box] : phaseMax[box];
+  uint stride = nMax[0] + nMax[1] + nMax[2] + 3;
+  if(phaseR.size() < (slot + length) * stride) {
+    phaseR.resize((slot + length) * stride);
+    phaseI.resize((slot + length) * stride);
+  }
+
+  for(uint p = 0; p < length; p++) {
+    double *re = &phaseR[(slot + p) * stride];
+    double *im = &phaseI[(slot + p) * stride];
+    XYZ pos = coords[first + p];
+    for(uint d = 0; d < 3; d++) {
+      double u = Dot(axis[d], pos);
+      double cosU = cos(u), sinU = sin(u);
+      re[0] = 1.0;
+      im[0] = 0.0;
+      for(int n = 1; n <= nMax[d]; n++) {
+        re[n] = re[n - 1] * cosU - im[n - 1] * sinU;
+        im[n] = re[n - 1] * sinU + im[n - 1] * cosU;
+      }
+      re += nMax[d] + 1;
+      im += nMax[d] + 1;
+    }
+  }
+}
+
+//e^{i k.r} = e^{i nx ux} e^{i ny uy} e^{i nz uz}, nx is never negative and
+//a negative ny or nz is the conjugate of the stored factor
+void Ewald::PhaseOf(const uint i, const uint slot, const uint box,
+                    const bool ref, double &cosK, double &sinK) const
+{
+  const int *n = (ref ? kIdxRef[box] : kIdx[box]) + 3 * i;
+  const int *nMax = ref ? phaseMaxRef[box] : phaseMax[box];
+  uint offY = nMax[0] + 1;
+  uint offZ = offY + nMax[1] + 1;
+  uint stride = offZ + nMax[2] + 1;
+  const double *re = &phaseR[slot * stride];
+  const double *im = &phaseI[slot * stride];
+
+  double xr = re[n[0]], xi = im[n[0]];
+  double yr = re[offY + std::abs(n[1])];
+  double yi = (n[1] < 0 ? -im[offY - n[1]] : im[offY + n[1]]);
+  double zr = re[offZ + std::abs(n[2])];
+  double zi = (n[2] < 0 ? -im[offZ - n[2]] : im[offZ + n[2]]);
+  double xyr = xr * yr - xi * yi;
+  double xyi = xr * yi + xi * yr;
+  cosK = xyr * zr - xyi * zi;
+  sinK = xyr * zi + xyi * zr;
+}
+
 //calculate reciprocal terms for a box. Should be called only at
 //the start of the simulation to initialize the settings and when
 //testing a change in box dimensions, such as a volume transfer.
@@ -228,22 +314,20 @@ void Ewald::BoxReciprocalSetup(uint box, XYZArray const& molCoords)
                               sumInew[box], prefact[box], hsqr[box],
                               currentEnergyRecip[box], box);
 #else
-#ifdef _OPENMP
-    #pragma omp parallel default(none) shared(box)
-#endif
-    {
-      std::memset(sumRnew[box], 0.0, sizeof(double) * imageSize[box]);
-      std::memset(sumInew[box], 0.0, sizeof(double) * imageSize[box]);
-    }
+    std::memset(sumRnew[box], 0.0, sizeof(double) * imageSize[box]);
+    std::memset(sumInew[box], 0.0, sizeof(double) * imageSize[box]);
+    bool recurrence = phaseFactors;
 
     while (thisMol != end) {
       MoleculeKind const& thisKind = mols.GetKind(*thisMol);
       double lambdaCoef = GetLambdaCoef(*thisMol, box);
       uint start = mols.MolStart(*thisMol);
+      if(recurrence)
+        PhaseSetup(molCoords, start, thisKind.NumAtoms(), 0, box, false);
 
 #ifdef _OPENMP
       #pragma omp parallel for default(none) shared(box, lambdaCoef, molCoords, \
-      start, thisKind)
+      start, thisKind, recurrence)
 #endif
       for (int i = 0; i < (int) imageSize[box]; i++) {
         double sumReal = 0.0;
@@ -254,14 +338,20 @@ void Ewald::BoxReciprocalSetup(uint box, XYZArray const& molCoords)
           if(particleHasNoCharge[currentAtom]) {
             continue;
           }
-          double dotProduct = Dot(currentAtom, kx[box][i], ky[box][i],
-                                  kz[box][i], molCoords);
-
-          // TODO: sincos() can be used to optimize (GNU compiler only)
-          // Windows doesn't have sincos() function and
-          // Intel compiler automatically optimizes this part
-          sumReal += (thisKind.AtomCharge(j) * cos(dotProduct));
-          sumImaginary += (thisKind.AtomCharge(j) * sin(dotProduct));
+          double cosK, sinK;
+          if(recurrence) {
+            PhaseOf(i, j, box, false, cosK, sinK);
+          } else {
+            double dotProduct = Dot(currentAtom, kx[box][i], ky[box][i],
+                                    kz[box][i], molCoords);
+            // TODO: sincos() can be used to optimize (GNU compiler only)
+            // Windows doesn't have sincos() function and
+            // Intel compiler automatically optimizes this part
+            cosK = cos(dotProduct);
+            sinK = sin(dotProduct);
+          }
+          sumReal += (thisKind.AtomCharge(j) * cosK);
+          sumImaginary += (thisKind.AtomCharge(j) * sinK);
         }
         //we assume all atom charges are scaled with lambda
         sumRnew[box][i] += (lambdaCoef * sumReal);
@@ -312,22 +402,20 @@ void Ewald::BoxReciprocalSums(uint box, XYZArray const& molCoords)
                              chargeBox, imageSizeRef[box], sumRnew[box],
                              sumInew[box], currentEnergyRecip[box], box);
 #else
-#ifdef _OPENMP
-    #pragma omp parallel default(none) shared(box)
-#endif
-    {
-      std::memset(sumRnew[box], 0.0, sizeof(double) * imageSizeRef[box]);
-      std::memset(sumInew[box], 0.0, sizeof(double) * imageSizeRef[box]);
-    }
+    std::memset(sumRnew[box], 0.0, sizeof(double) * imageSizeRef[box]);
+    std::memset(sumInew[box], 0.0, sizeof(double) * imageSizeRef[box]);
+    bool recurrence = phaseFactors;
 
     while (thisMol != end) {
       MoleculeKind const& thisKind = mols.GetKind(*thisMol);
       double lambdaCoef = GetLambdaCoef(*thisMol, box);
       uint startAtom = mols.MolStart(*thisMol);
+      if(recurrence)
+        PhaseSetup(molCoords, startAtom, thisKind.NumAtoms(), 0, box, true);
 
 #ifdef _OPENMP
       #pragma omp parallel for default(none) shared(box, lambdaCoef, molCoords, \
-      startAtom, thisKind)
+      startAtom, thisKind, recurrence)
 #endif
       for (int i = 0; i < (int) imageSizeRef[box]; i++) {
         double sumReal = 0.0;
@@ -338,14 +426,20 @@ void Ewald::BoxReciprocalSums(uint box, XYZArray const& molCoords)
           if(particleHasNoCharge[currentAtom]) {
             continue;
           }
-          double dotProduct = Dot(currentAtom, kxRef[box][i], kyRef[box][i],
-                                  kzRef[box][i], molCoords);
-
-          // TODO: sincos() can be used to optimize (GNU compiler only)
-          // Windows doesn't have sincos() function and
-          // Intel compiler automatically optimizes this part
-          sumReal += (thisKind.AtomCharge(j) * cos(dotProduct));
-          sumImaginary += (thisKind.AtomCharge(j) * sin(dotProduct));
+          double cosK, sinK;
+          if(recurrence) {
+            PhaseOf(i, j, box, true, cosK, sinK);
+          } else {
+            double dotProduct = Dot(currentAtom, kxRef[box][i], kyRef[box][i],
+                                    kzRef[box][i], molCoords);
+            // TODO: sincos() can be used to optimize (GNU compiler only)
+            // Windows doesn't have sincos() function and
+            // Intel compiler automatically optimizes this part
+            cosK = cos(dotProduct);
+            sinK = sin(dotProduct);
+          }
+          sumReal += (thisKind.AtomCharge(j) * cosK);
+          sumImaginary += (thisKind.AtomCharge(j) * sinK);
         }
         //we assume all atom charges are scaled with lambda
         sumRnew[box][i] += (lambdaCoef * sumReal);
@@ -427,15 +521,26 @@ double Ewald::MolReciprocal(XYZArray const& molCoords,
                          cCoords, molCoords, MolCharge, imageSizeRef[box],
                          sumRnew[box], sumInew[box], energyRecipNew, box);
 #else
+    //Trig in float with double sums; Simulation recomputes the reference
+    //sums in double every mixedPrecisionFreq steps to bound the drift
+    const bool single = ff.mixedPrecision;
+    //new atoms in slots [0, length), old ones in [length, 2 * length)
+    const bool recurrence = phaseFactors;
+    if(recurrence) {
+      PhaseSetup(molCoords, 0, length, 0, box, true);
+      PhaseSetup(currentCoords, startAtom, length, length, box, true);
+    }
 #ifdef _OPENMP
 #if GCC_VERSION >= 90000
     #pragma omp parallel for default(none) shared(lambdaCoef, length, molCoords, \
-    startAtom, thisKind, box) \
-reduction(+:energyRecipNew)
+    startAtom, thisKind, box, single, recurrence) \
+reduction(+:energyRecipNew) \
+    if(parallel_grain::Parallel(imageSizeRef[box] * length))
 #else
     #pragma omp parallel for default(none) shared(lambdaCoef, length, molCoords, \
     startAtom, thisKind) \
-reduction(+:energyRecipNew)
+reduction(+:energyRecipNew) \
+    if(parallel_grain::Parallel(imageSizeRef[box] * length))
 #endif
 #endif
     for (int i = 0; i < (int) imageSizeRef[box]; i++) {
@@ -449,14 +554,29 @@ reduction(+:energyRecipNew)
         if(particleHasNoCharge[currentAtom]) {
           continue;
         }
-        double dotProductNew = Dot(p, kxRef[box][i], kyRef[box][i], kzRef[box][i], molCoords);
-        double dotProductOld = Dot(currentAtom, kxRef[box][i], kyRef[box][i], kzRef[box][i], currentCoords);
+        double cosNew, sinNew, cosOld, sinOld;
+        if(recurrence) {
+          PhaseOf(i, p, box, true, cosNew, sinNew);
+          PhaseOf(i, length + p, box, true, cosOld, sinOld);
+        } else {
+          double dotProductNew = Dot(p, kxRef[box][i], kyRef[box][i], kzRef[box][i], molCoords);
+          double dotProductOld = Dot(currentAtom, kxRef[box][i], kyRef[box][i], kzRef[box][i], currentCoords);
+          if(single) {
+            SinCosSingle(dotProductNew, sinNew, cosNew);
+            SinCosSingle(dotProductOld, sinOld, cosOld);
+          } else {
+            cosNew = cos(dotProductNew);
+            sinNew = sin(dotProductNew);
+            cosOld = cos(dotProductOld);
+            sinOld = sin(dotProductOld);
+          }
+        }
 
-        sumRealNew += (thisKind.AtomCharge(p) * cos(dotProductNew));
-        sumImaginaryNew += (thisKind.AtomCharge(p) * sin(dotProductNew));
+        sumRealNew += (thisKind.AtomCharge(p) * cosNew);
+        sumImaginaryNew += (thisKind.AtomCharge(p) * sinNew);
 
-        sumRealOld += (thisKind.AtomCharge(p) * cos(dotProductOld));
-        sumImaginaryOld += (thisKind.AtomCharge(p) * sin(dotProductOld));
+        sumRealOld += (thisKind.AtomCharge(p) * cosOld);
+        sumImaginaryOld += (thisKind.AtomCharge(p) * sinOld);
       }
 
       sumRnew[box][i] = sumRref[box][i] + lambdaCoef *
@@ -489,7 +609,7 @@ double Ewald::SwapDestRecip(const cbmc::TrialMol &newMol,
   if (box < BOXES_WITH_U_NB) {
     GOMC_EVENT_START(1, GomcProfileEvent::RECIP_SWAP_ENERGY);
     MoleculeKind const& thisKind = newMol.GetKind();
-    XYZArray molCoords = newMol.GetCoords();
+    XYZArray const& molCoords = newMol.GetCoords();
     uint length = thisKind.NumAtoms();
 #ifdef GOMC_CUDA
     bool insert = true;
@@ -503,13 +623,18 @@ double Ewald::SwapDestRecip(const cbmc::TrialMol &newMol,
                           insert, energyRecipNew, box);
 #else
     uint startAtom = mols.MolStart(molIndex);
+    const bool recurrence = phaseFactors;
+    if(recurrence)
+      PhaseSetup(molCoords, 0, length, 0, box, true);
 #ifdef _OPENMP
 #if GCC_VERSION >= 90000
     #pragma omp parallel for default(none) shared(length, molCoords, startAtom, \
-thisKind, box) reduction(+:energyRecipNew)
+thisKind, box, recurrence) reduction(+:energyRecipNew) \
+    if(parallel_grain::Parallel(imageSizeRef[box] * length))
 #else
     #pragma omp parallel for default(none) shared(length, molCoords, startAtom, \
-thisKind) reduction(+:energyRecipNew)
+thisKind) reduction(+:energyRecipNew) \
+    if(parallel_grain::Parallel(imageSizeRef[box] * length))
 #endif
 #endif
     for (int i = 0; i < (int) imageSizeRef[box]; i++) {
@@ -520,12 +645,19 @@ thisKind) reduction(+:energyRecipNew)
         if(particleHasNoCharge[startAtom + p]) {
           continue;
         }
-        double dotProductNew = Dot(p, kxRef[box][i],
-                                   kyRef[box][i], kzRef[box][i],
-                                   molCoords);
+        double cosNew, sinNew;
+        if(recurrence) {
+          PhaseOf(i, p, box, true, cosNew, sinNew);
+        } else {
+          double dotProductNew = Dot(p, kxRef[box][i],
+                                     kyRef[box][i], kzRef[box][i],
+                                     molCoords);
+          cosNew = cos(dotProductNew);
+          sinNew = sin(dotProductNew);
+        }
 
-        sumRealNew += (thisKind.AtomCharge(p) * cos(dotProductNew));
-        sumImaginaryNew += (thisKind.AtomCharge(p) * sin(dotProductNew));
+        sumRealNew += (thisKind.AtomCharge(p) * cosNew);
+        sumImaginaryNew += (thisKind.AtomCharge(p) * sinNew);
       }
 
       sumRnew[box][i] = sumRref[box][i] + sumRealNew;
@@ -566,15 +698,20 @@ double Ewald::ChangeLambdaRecip(XYZArray const& molCoords, const double lambdaOl
                                     sumRnew[box], sumInew[box], energyRecipNew,
                                     lambdaCoef, box);
 #else
+    const bool recurrence = phaseFactors;
+    if(recurrence)
+      PhaseSetup(molCoords, 0, length, 0, box, true);
 #ifdef _OPENMP
 #if GCC_VERSION >= 90000
     #pragma omp parallel for default(none) shared(lambdaCoef, length, molCoords, \
-    startAtom, thisKind, box) \
-reduction(+:energyRecipNew)
+    startAtom, thisKind, box, recurrence) \
+reduction(+:energyRecipNew) \
+    if(parallel_grain::Parallel(imageSizeRef[box] * length))
 #else
     #pragma omp parallel for default(none) shared(lambdaCoef, length, molCoords, \
     startAtom, thisKind) \
-reduction(+:energyRecipNew)
+reduction(+:energyRecipNew) \
+    if(parallel_grain::Parallel(imageSizeRef[box] * length))
 #endif
 #endif
     for (int i = 0; i < (int) imageSizeRef[box]; i++) {
@@ -585,12 +722,19 @@ reduction(+:energyRecipNew)
         if(particleHasNoCharge[startAtom + p]) {
           continue;
         }
-        double dotProductNew = Dot(p, kxRef[box][i],
-                                   kyRef[box][i], kzRef[box][i],
-                                   molCoords);
+        double cosNew, sinNew;
+        if(recurrence) {
+          PhaseOf(i, p, box, true, cosNew, sinNew);
+        } else {
+          double dotProductNew = Dot(p, kxRef[box][i],
+                                     kyRef[box][i], kzRef[box][i],
+                                     molCoords);
+          cosNew = cos(dotProductNew);
+          sinNew = sin(dotProductNew);
+        }
 
-        sumRealNew += thisKind.AtomCharge(p) * cos(dotProductNew);
-        sumImaginaryNew += thisKind.AtomCharge(p) * sin(dotProductNew);
+        sumRealNew += thisKind.AtomCharge(p) * cosNew;
+        sumImaginaryNew += thisKind.AtomCharge(p) * sinNew;
       }
 
       //sumRealNew;
@@ -620,18 +764,23 @@ void Ewald::ChangeRecip(Energy *energyDiff, Energy &dUdL_Coul,
   uint length = mols.GetKind(molIndex).NumAtoms();
   uint startAtom = mols.MolStart(molIndex);
   uint lambdaSize = lambda_Coul.size();
-  double *energyRecip = new double [lambdaSize];
-  std::fill_n(energyRecip, lambdaSize, 0.0);
+  lambdaRecip.assign(lambdaSize, 0.0);
+  double *energyRecip = &lambdaRecip[0];
+  bool recurrence = phaseFactors;
+  if(recurrence)
+    PhaseSetup(currentCoords, startAtom, length, 0, box, true);
 
 #if defined _OPENMP && _OPENMP >= 201511 // check if OpenMP version is 4.5
 #if GCC_VERSION >= 90000
   #pragma omp parallel for default(none) shared(lambda_Coul, lambdaSize, \
-  length, startAtom, box, iState) \
-reduction(+:energyRecip[:lambdaSize])
+  length, startAtom, box, iState, recurrence) \
+reduction(+:energyRecip[:lambdaSize]) \
+  if(parallel_grain::Parallel(imageSizeRef[box] * length))
 #else
   #pragma omp parallel for default(none) shared(lambda_Coul, lambdaSize, \
-  length, startAtom) \
-reduction(+:energyRecip[:lambdaSize])
+  length, startAtom, recurrence) \
+reduction(+:energyRecip[:lambdaSize]) \
+  if(parallel_grain::Parallel(imageSizeRef[box] * length))
 #endif
 #endif
   for (int i = 0; i < (int) imageSizeRef[box]; i++) {
@@ -643,10 +792,17 @@ reduction(+:energyRecip[:lambdaSize])
       if(particleHasNoCharge[currentAtom]) {
         continue;
       }
-      double dotProduct = Dot(p + startAtom, kxRef[box][i], kyRef[box][i], kzRef[box][i],
-                              currentCoords);
-      sumReal += particleCharge[currentAtom] * cos(dotProduct);
-      sumImaginary += particleCharge[currentAtom] * sin(dotProduct);
+      double cosK, sinK;
+      if(recurrence) {
+        PhaseOf(i, p, box, true, cosK, sinK);
+      } else {
+        double dotProduct = Dot(p + startAtom, kxRef[box][i], kyRef[box][i],
+                                kzRef[box][i], currentCoords);
+        cosK = cos(dotProduct);
+        sinK = sin(dotProduct);
+      }
+      sumReal += particleCharge[currentAtom] * cosK;
+      sumImaginary += particleCharge[currentAtom] * sinK;
     }
     for(uint s = 0; s < lambdaSize; s++) {
       //Calculate the energy of other state
@@ -666,7 +822,6 @@ reduction(+:energyRecip[:lambdaSize])
   //Calculate du/dl of Reciprocal for current state  with linear scaling
   //energy difference E(lambda =1) - E(lambda = 0)
   dUdL_Coul.recip += energyDiff[lambdaSize - 1].recip - energyDiff[0].recip;
-  delete [] energyRecip;
 }
 
 void Ewald::RecipInit(uint box, BoxDimensions const& boxAxes)
@@ -693,7 +848,7 @@ double Ewald::SwapSourceRecip(const cbmc::TrialMol &oldMol,
   if (box < BOXES_WITH_U_NB) {
     GOMC_EVENT_START(1, GomcProfileEvent::RECIP_SWAP_ENERGY);
     MoleculeKind const& thisKind = oldMol.GetKind();
-    XYZArray molCoords = oldMol.GetCoords();
+    XYZArray const& molCoords = oldMol.GetCoords();
     uint length = thisKind.NumAtoms();
 #ifdef GOMC_CUDA
     bool insert = false;
@@ -708,15 +863,20 @@ double Ewald::SwapSourceRecip(const cbmc::TrialMol &oldMol,
 
 #else
     uint startAtom = mols.MolStart(molIndex);
+    const bool recurrence = phaseFactors;
+    if(recurrence)
+      PhaseSetup(molCoords, 0, length, 0, box, true);
 #ifdef _OPENMP
 #if GCC_VERSION >= 90000
     #pragma omp parallel for default(none) shared(length, molCoords, startAtom, \
-    thisKind, box) \
-reduction(+:energyRecipNew)
+    thisKind, box, recurrence) \
+reduction(+:energyRecipNew) \
+    if(parallel_grain::Parallel(imageSizeRef[box] * length))
 #else
     #pragma omp parallel for default(none) shared(length, molCoords, startAtom, \
     thisKind) \
-reduction(+:energyRecipNew)
+reduction(+:energyRecipNew) \
+    if(parallel_grain::Parallel(imageSizeRef[box] * length))
 #endif
 #endif
     for (int i = 0; i < (int) imageSizeRef[box]; i++) {
@@ -728,12 +888,19 @@ reduction(+:energyRecipNew)
         if(particleHasNoCharge[currentAtom]) {
           continue;
         }
-        double dotProductNew = Dot(p, kxRef[box][i],
-                                   kyRef[box][i], kzRef[box][i],
-                                   molCoords);
+        double cosNew, sinNew;
+        if(recurrence) {
+          PhaseOf(i, p, box, true, cosNew, sinNew);
+        } else {
+          double dotProductNew = Dot(p, kxRef[box][i],
+                                     kyRef[box][i], kzRef[box][i],
+                                     molCoords);
+          cosNew = cos(dotProductNew);
+          sinNew = sin(dotProductNew);
+        }
 
-        sumRealNew += (thisKind.AtomCharge(p) * cos(dotProductNew));
-        sumImaginaryNew += (thisKind.AtomCharge(p) * sin(dotProductNew));
+        sumRealNew += (thisKind.AtomCharge(p) * cosNew);
+        sumImaginaryNew += (thisKind.AtomCharge(p) * sinNew);
 
       }
       sumRnew[box][i] = sumRref[box][i] - sumRealNew;
@@ -770,11 +937,26 @@ double Ewald::MolExchangeReciprocal(const std::vector<cbmc::TrialMol> &newMol,
     MoleculeKind const& thisKindOld = oldMol[0].GetKind();
     lengthNew = thisKindNew.NumAtoms();
     lengthOld = thisKindOld.NumAtoms();
+    //atoms of the new molecules first, then the ones of the old molecules
+    uint oldSlot = lengthNew * newMol.size();
+    bool recurrence = phaseFactors;
+    if(recurrence) {
+      for (uint m = 0; m < newMol.size(); m++) {
+        PhaseSetup(newMol[m].GetCoords(), 0, lengthNew, m * lengthNew, box,
+                   true);
+      }
+      for (uint m = 0; m < oldMol.size(); m++) {
+        PhaseSetup(oldMol[m].GetCoords(), 0, lengthOld,
+                   oldSlot + m * lengthOld, box, true);
+      }
+    }
 
 #ifdef _OPENMP
     #pragma omp parallel for default(none) shared(box, first_call, lengthNew, lengthOld, \
-    newMol, oldMol, thisKindNew, thisKindOld, molIndexNew, molIndexOld) \
-reduction(+:energyRecipNew)
+    newMol, oldMol, thisKindNew, thisKindOld, molIndexNew, molIndexOld, \
+    oldSlot, recurrence) \
+reduction(+:energyRecipNew) \
+    if(parallel_grain::Parallel(imageSizeRef[box] * (lengthNew * newMol.size() + lengthOld * oldMol.size())))
 #endif
     for (int i = 0; i < (int) imageSizeRef[box]; i++) {
       double sumRealNew = 0.0;
@@ -789,18 +971,23 @@ reduction(+:energyRecipNew)
           if(particleHasNoCharge[currentAtom]) {
             continue;
           }
-          double dotProductNew = Dot(p, kxRef[box][i], kyRef[box][i],
-                                     kzRef[box][i], newMol[m].GetCoords());
-
-          // TODO: Using GNU extension we could improve this part of the code
-          // by using sincos() function and merge sin() and cos() calculation
-          // However, this will not work with Visual studio
-          // Intel should automatically optimize this section by using
-          // internal functions like __svml_sincosf8..()
-          sumRealNew += (thisKindNew.AtomCharge(p) * lambdaCoef *
-                         cos(dotProductNew));
-          sumImaginaryNew += (thisKindNew.AtomCharge(p) * lambdaCoef *
-                              sin(dotProductNew));
+          double cosNew, sinNew;
+          if(recurrence) {
+            PhaseOf(i, m * lengthNew + p, box, true, cosNew, sinNew);
+          } else {
+            double dotProductNew = Dot(p, kxRef[box][i], kyRef[box][i],
+                                       kzRef[box][i], newMol[m].GetCoords());
+
+            // TODO: Using GNU extension we could improve this part of the code
+            // by using sincos() function and merge sin() and cos() calculation
+            // However, this will not work with Visual studio
+            // Intel should automatically optimize this section by using
+            // internal functions like __svml_sincosf8..()
+            cosNew = cos(dotProductNew);
+            sinNew = sin(dotProductNew);
+          }
+          sumRealNew += (thisKindNew.AtomCharge(p) * lambdaCoef * cosNew);
+          sumImaginaryNew += (thisKindNew.AtomCharge(p) * lambdaCoef * sinNew);
         }
       }
 
@@ -813,18 +1000,23 @@ reduction(+:energyRecipNew)
           if(particleHasNoCharge[currentAtom]) {
             continue;
           }
-          double dotProductOld = Dot(p, kxRef[box][i], kyRef[box][i],
-                                     kzRef[box][i], oldMol[m].GetCoords());
-
-          // TODO: Using GNU extension we could improve this part of the code
-          // by using sincos() function and merge sin() and cos() calculation
-          // However, this will not work with Visual studio
-          // Intel should automatically optimize this section by using
-          // internal functions like __svml_sincosf8..()
-          sumRealNew -= thisKindOld.AtomCharge(p) * lambdaCoef *
-                        cos(dotProductOld);
-          sumImaginaryNew -= thisKindOld.AtomCharge(p) * lambdaCoef *
-                             sin(dotProductOld);
+          double cosOld, sinOld;
+          if(recurrence) {
+            PhaseOf(i, oldSlot + m * lengthOld + p, box, true, cosOld, sinOld);
+          } else {
+            double dotProductOld = Dot(p, kxRef[box][i], kyRef[box][i],
+                                       kzRef[box][i], oldMol[m].GetCoords());
+
+            // TODO: Using GNU extension we could improve this part of the code
+            // by using sincos() function and merge sin() and cos() calculation
+            // However, this will not work with Visual studio
+            // Intel should automatically optimize this section by using
+            // internal functions like __svml_sincosf8..()
+            cosOld = cos(dotProductOld);
+            sinOld = sin(dotProductOld);
+          }
+          sumRealNew -= thisKindOld.AtomCharge(p) * lambdaCoef * cosOld;
+          sumImaginaryNew -= thisKindOld.AtomCharge(p) * lambdaCoef * sinOld;
         }
       }
 
@@ -908,6 +1100,12 @@ void Ewald::RecipInitOrth(uint box, BoxDimensions const& boxAxes)
   nky_max = int(ff.recip_rcut[box] * boxAxes.axis.Get(box).y / (2.0 * M_PI)) + 1;
   nkz_max = int(ff.recip_rcut[box] * boxAxes.axis.Get(box).z / (2.0 * M_PI)) + 1;
   kmax[box] = std::max(std::max(nkx_max, nky_max), std::max(nky_max, nkz_max));
+  phaseMax[box][0] = nkx_max;
+  phaseMax[box][1] = nky_max;
+  phaseMax[box][2] = nkz_max;
+  phaseAxis[box][0] = XYZ(constValue.x, 0.0, 0.0);
+  phaseAxis[box][1] = XYZ(0.0, constValue.y, 0.0);
+  phaseAxis[box][2] = XYZ(0.0, 0.0, constValue.z);
 
   for(x = 0; x <= nkx_max; x++) {
     if(x == 0.0)
@@ -934,6 +1132,9 @@ void Ewald::RecipInitOrth(uint box, BoxDimensions const& boxAxes)
           hsqr[box][counter] = ksqr;
           prefact[box][counter] = num::qqFact * exp(-ksqr * alpsqr4) /
                                   (ksqr * vol);
+          kIdx[box][3 * counter] = x;
+          kIdx[box][3 * counter + 1] = y;
+          kIdx[box][3 * counter + 2] = z;
           counter++;
         }
       }
@@ -968,6 +1169,13 @@ void Ewald::RecipInitNonOrth(uint box, BoxDimensions const& boxAxes)
   nky_max = int(ff.recip_rcut[box] * boxAxes.axis.Get(box).y / (2.0 * M_PI)) + 1;
   nkz_max = int(ff.recip_rcut[box] * boxAxes.axis.Get(box).z / (2.0 * M_PI)) + 1;
   kmax[box] = std::max(std::max(nkx_max, nky_max), std::max(nky_max, nkz_max));
+  phaseMax[box][0] = nkx_max;
+  phaseMax[box][1] = nky_max;
+  phaseMax[box][2] = nkz_max;
+  //columns of the reciprocal basis, since kX = Dot(cellB_Inv.Get(0), n)
+  phaseAxis[box][0] = XYZ(cellB_Inv.x[0], cellB_Inv.x[1], cellB_Inv.x[2]);
+  phaseAxis[box][1] = XYZ(cellB_Inv.y[0], cellB_Inv.y[1], cellB_Inv.y[2]);
+  phaseAxis[box][2] = XYZ(cellB_Inv.z[0], cellB_Inv.z[1], cellB_Inv.z[2]);
 
   for (x = 0; x <= nkx_max; x++) {
     if(x == 0.0)
@@ -994,6 +1202,9 @@ void Ewald::RecipInitNonOrth(uint box, BoxDimensions const& boxAxes)
           hsqr[box][counter] = ksqr;
           prefact[box][counter] = num::qqFact * exp(-ksqr * alpsqr4) /
                                   (ksqr * vol);
+          kIdx[box][3 * counter] = x;
+          kIdx[box][3 * counter + 1] = y;
+          kIdx[box][3 * counter + 2] = z;
           counter++;
         }
       }
@@ -1066,17 +1277,17 @@ void Ewald::RecipCountInit(uint box, BoxDimensions const& boxAxes)
 //back up reciprocal value to Ref (will be called during initialization)
 void Ewald::SetRecipRef(uint box)
 {
-#ifdef _OPENMP
-  #pragma omp parallel default(none) shared(box)
-#endif
-  {
-    std::memcpy(sumRref[box], sumRnew[box], sizeof(double) * imageSize[box]);
-    std::memcpy(sumIref[box], sumInew[box], sizeof(double) * imageSize[box]);
-    std::memcpy(kxRef[box], kx[box], sizeof(double) * imageSize[box]);
-    std::memcpy(kyRef[box], ky[box], sizeof(double) * imageSize[box]);
-    std::memcpy(kzRef[box], kz[box], sizeof(double) * imageSize[box]);
-    std::memcpy(hsqrRef[box], hsqr[box], sizeof(double) * imageSize[box]);
-    std::memcpy(prefactRef[box], prefact[box], sizeof(double) *imageSize[box]);
+  std::memcpy(sumRref[box], sumRnew[box], sizeof(double) * imageSize[box]);
+  std::memcpy(sumIref[box], sumInew[box], sizeof(double) * imageSize[box]);
+  std::memcpy(kxRef[box], kx[box], sizeof(double) * imageSize[box]);
+  std::memcpy(kyRef[box], ky[box], sizeof(double) * imageSize[box]);
+  std::memcpy(kzRef[box], kz[box], sizeof(double) * imageSize[box]);
+  std::memcpy(hsqrRef[box], hsqr[box], sizeof(double) * imageSize[box]);
+  std::memcpy(prefactRef[box], prefact[box], sizeof(double) *imageSize[box]);
+  std::memcpy(kIdxRef[box], kIdx[box], sizeof(int) * 3 * imageSize[box]);
+  for(uint d = 0; d < 3; d++) {
+    phaseAxisRef[box][d] = phaseAxis[box][d];
+    phaseMaxRef[box][d] = phaseMax[box][d];
   }
 #ifdef GOMC_CUDA
   CopyCurrentToRefCUDA(ff.particles->getCUDAVars(), box, imageSize[box]);
@@ -1481,13 +1692,8 @@ void Ewald::CopyRecip(uint box)
   if (box >= BOXES_WITH_U_NB)
     return;
 
-#ifdef _OPENMP
-  #pragma omp parallel default(none) shared(box)
-#endif
-  {
-    std::memcpy(sumRnew[box], sumRref[box], sizeof(double) * imageSizeRef[box]);
-    std::memcpy(sumInew[box], sumIref[box], sizeof(double) * imageSizeRef[box]);
-  }
+  std::memcpy(sumRnew[box], sumRref[box], sizeof(double) * imageSizeRef[box]);
+  std::memcpy(sumInew[box], sumIref[box], sizeof(double) * imageSizeRef[box]);
 #ifdef GOMC_CUDA
   CopyRefToNewCUDA(ff.particles->getCUDAVars(), box, imageSizeRef[box]);
 #endif
@@ -1514,6 +1720,12 @@ void Ewald::UpdateRecipVec(uint box)
   hsqr[box] = tempHsqr;
   prefact[box] = tempPrefact;
 
+  std::swap(kIdx[box], kIdxRef[box]);
+  for(uint d = 0; d < 3; d++) {
+    std::swap(phaseAxis[box][d], phaseAxisRef[box][d]);
+    std::swap(phaseMax[box][d], phaseMaxRef[box][d]);
+  }
+
   imageSizeRef[box] = imageSize[box];
 
 #ifdef GOMC_CUDA
@@ -212,6 +212,29 @@ protected:
   double **kz, **kzRef;
   double **hsqr, **hsqrRef;
   double **prefact, **prefactRef;
+  //integer k-grid index (x, y, z) of each k-vector. With EwaldRecurrence
+  //k.r is the sum over the axes d of n_d * Dot(phaseAxis[d], r), so the
+  //phase of every k-vector is a product of per-atom phase factors
+  int **kIdx, **kIdxRef;
+  XYZ phaseAxis[BOXES_WITH_U_NB][3], phaseAxisRef[BOXES_WITH_U_NB][3];
+  //largest grid index of each axis
+  int phaseMax[BOXES_WITH_U_NB][3], phaseMaxRef[BOXES_WITH_U_NB][3];
+  //e^{i n u} of each axis for the atoms of PhaseSetup, kept between calls
+  mutable std::vector<double> phaseR, phaseI;
+
+  //structure factors are built from the per-atom factors of PhaseSetup
+  //instead of a sin and cos for every atom and k-vector
+  bool phaseFactors;
+
+  //build the phase factors of atoms [first, first + length) of coords in
+  //slots [slot, slot + length), for the accepted (ref) or the trial k-grid
+  virtual void PhaseSetup(XYZArray const& coords, const uint first,
+                          const uint length, const uint slot, const uint box,
+                          const bool ref) const;
+
+  //cos and sin of k.r for k-vector i and the atom in slot
+  void PhaseOf(const uint i, const uint slot, const uint box, const bool ref,
+               double &cosK, double &sinK) const;
 
 
   std::vector<int> particleKind;
@@ -229,6 +252,9 @@ protected:
   std::vector<double> particleCharge;
   // which atoms don't have charge
   std::vector<bool> particleHasNoCharge;
+  // reciprocal energy of every lambda state in ChangeRecip, kept between
+  // calls so they do not allocate
+  mutable std::vector<double> lambdaRecip;
 
 };
 
@@ -6,6 +6,7 @@ along with this program, also can be found at <https://opensource.org/licenses/M
 ********************************************************************************/
 #include "EwaldCached.h"
 #include "StaticVals.h"
+#include "ParallelGrain.h"
 #include "GOMCEventsProfile.h"
 
 using namespace geom;
@@ -100,13 +101,8 @@ void EwaldCached::BoxReciprocalSetup(uint box, XYZArray const& molCoords)
     MoleculeLookup::box_iterator thisMol = molLookup.BoxBegin(box);
     MoleculeLookup::box_iterator end = molLookup.BoxEnd(box);
 
-#ifdef _OPENMP
-    #pragma omp parallel default(none) shared(box)
-#endif
-    {
-      std::memset(sumRnew[box], 0.0, sizeof(double) * imageSize[box]);
-      std::memset(sumInew[box], 0.0, sizeof(double) * imageSize[box]);
-    }
+    std::memset(sumRnew[box], 0.0, sizeof(double) * imageSize[box]);
+    std::memset(sumInew[box], 0.0, sizeof(double) * imageSize[box]);
 
     while (thisMol != end) {
       MoleculeKind const& thisKind = mols.GetKind(*thisMol);
@@ -157,13 +153,8 @@ void EwaldCached::BoxReciprocalSums(uint box, XYZArray const& molCoords)
     MoleculeLookup::box_iterator thisMol = molLookup.BoxBegin(box);
     MoleculeLookup::box_iterator end = molLookup.BoxEnd(box);
 
-#ifdef _OPENMP
-    #pragma omp parallel default(none) shared(box)
-#endif
-    {
-      std::memset(sumRnew[box], 0.0, sizeof(double) * imageSizeRef[box]);
-      std::memset(sumInew[box], 0.0, sizeof(double) * imageSizeRef[box]);
-    }
+    std::memset(sumRnew[box], 0.0, sizeof(double) * imageSizeRef[box]);
+    std::memset(sumInew[box], 0.0, sizeof(double) * imageSizeRef[box]);
 
     while (thisMol != end) {
       MoleculeKind const& thisKind = mols.GetKind(*thisMol);
@@ -259,11 +250,13 @@ double EwaldCached::MolReciprocal(XYZArray const& molCoords,
 #if GCC_VERSION >= 90000
     #pragma omp parallel for default(none) shared(lambdaCoef, length, molCoords, \
     startAtom, thisKind, box, molIndex) \
-reduction(+:energyRecipNew)
+reduction(+:energyRecipNew) \
+    if(parallel_grain::Parallel(imageSizeRef[box] * length))
 #else
     #pragma omp parallel for default(none) shared(lambdaCoef, length, molCoords, \
     startAtom, thisKind) \
-reduction(+:energyRecipNew)
+reduction(+:energyRecipNew) \
+    if(parallel_grain::Parallel(imageSizeRef[box] * length))
 #endif
 #endif
     for (int i = 0; i < (int) imageSizeRef[box]; i++) {
@@ -313,21 +306,12 @@ double EwaldCached::SwapDestRecip(const cbmc::TrialMol &newMol,
   double energyRecipNew = 0.0;
   double energyRecipOld = 0.0;
 
-#ifdef _OPENMP
-#if GCC_VERSION >= 90000
-  #pragma omp parallel default(none) shared(molIndex)
-#else
-  #pragma omp parallel default(none)
-#endif
-#endif
-  {
-    std::memcpy(cosMolRestore, cosMolRef[molIndex], sizeof(double)*imageTotal);
-    std::memcpy(sinMolRestore, sinMolRef[molIndex], sizeof(double)*imageTotal);
-  }
+  std::memcpy(cosMolRestore, cosMolRef[molIndex], sizeof(double)*imageTotal);
+  std::memcpy(sinMolRestore, sinMolRef[molIndex], sizeof(double)*imageTotal);
 
   if (box < BOXES_WITH_U_NB) {
     MoleculeKind const& thisKind = newMol.GetKind();
-    XYZArray molCoords = newMol.GetCoords();
+    XYZArray const& molCoords = newMol.GetCoords();
     uint length = thisKind.NumAtoms();
     uint startAtom = mols.MolStart(molIndex);
 
@@ -335,11 +319,13 @@ double EwaldCached::SwapDestRecip(const cbmc::TrialMol &newMol,
 #if GCC_VERSION >= 90000
     #pragma omp parallel for default(none) shared(length, molCoords, startAtom, \
     thisKind, box, molIndex) \
-reduction(+:energyRecipNew)
+reduction(+:energyRecipNew) \
+    if(parallel_grain::Parallel(imageSizeRef[box] * length))
 #else
     #pragma omp parallel for default(none) shared(length, molCoords, startAtom, \
     thisKind) \
-reduction(+:energyRecipNew)
+reduction(+:energyRecipNew) \
+    if(parallel_grain::Parallel(imageSizeRef[box] * length))
 #endif
 #endif
     for (int i = 0; i < (int) imageSizeRef[box]; i++) {
@@ -389,9 +375,11 @@ double EwaldCached::SwapSourceRecip(const cbmc::TrialMol &oldMol,
     GOMC_EVENT_START(1, GomcProfileEvent::RECIP_SWAP_ENERGY);
 #ifdef _OPENMP
 #if GCC_VERSION >= 90000
-    #pragma omp parallel for default(none) shared(box) reduction(+:energyRecipNew)
+    #pragma omp parallel for default(none) shared(box) reduction(+:energyRecipNew) \
+    if(parallel_grain::Parallel(imageSizeRef[box]))
 #else
-    #pragma omp parallel for default(none) reduction(+:energyRecipNew)
+    #pragma omp parallel for default(none) reduction(+:energyRecipNew) \
+    if(parallel_grain::Parallel(imageSizeRef[box]))
 #endif
 #endif
     for (int i = 0; i < (int) imageSizeRef[box]; i++) {
@@ -442,17 +430,19 @@ void EwaldCached::ChangeRecip(Energy *energyDiff, Energy &dUdL_Coul,
 {
   //Need to implement GPU
   uint lambdaSize = lambda_Coul.size();
-  double *energyRecip = new double [lambdaSize];
-  std::fill_n(energyRecip, lambdaSize, 0.0);
+  lambdaRecip.assign(lambdaSize, 0.0);
+  double *energyRecip = &lambdaRecip[0];
 
 #if defined _OPENMP && _OPENMP >= 201511 // check if OpenMP version is 4.5
 #if GCC_VERSION >= 90000
   #pragma omp parallel for default(none) shared(lambda_Coul, lambdaSize, box, \
   iState, molIndex) \
-reduction(+:energyRecip[:lambdaSize])
+reduction(+:energyRecip[:lambdaSize]) \
+  if(parallel_grain::Parallel(imageSizeRef[box] * lambdaSize))
 #else
   #pragma omp parallel for default(none) shared(lambda_Coul, lambdaSize) \
-  reduction(+:energyRecip[:lambdaSize])
+  reduction(+:energyRecip[:lambdaSize]) \
+  if(parallel_grain::Parallel(imageSizeRef[box] * lambdaSize))
 #endif
 #endif
   for (uint i = 0; i < imageSizeRef[box]; i++) {
@@ -474,7 +464,6 @@ reduction(+:energyRecip[:lambdaSize])
   //Calculate du/dl of Reciprocal for current state
   //energy difference E(lambda =1) - E(lambda = 0)
   dUdL_Coul.recip += energyDiff[lambdaSize - 1].recip - energyDiff[0].recip;
-  delete [] energyRecip;
 }
 
 //restore cosMol and sinMol
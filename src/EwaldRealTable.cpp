@@ -0,0 +1,123 @@
+/*******************************************************************************
+GPU OPTIMIZED MONTE CARLO (GOMC) 2.75
+Copyright (C) 2022 GOMC Group
+A copy of the MIT License can be found in License.txt
+along with this program, also can be found at <https://opensource.org/licenses/MIT>.
+********************************************************************************/
+#include "EwaldRealTable.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace
+{
+//Smallest and largest number of mantissa bits tried for a table
+const int MIN_BITS = 4;
+const int MAX_BITS = 16;
+
+//Energy and virial terms at r^2 = distSq and their derivatives in r^2
+void Exact(const double distSq, const double alpha, double & en,
+           double & vir, double & dEn, double & dVir)
+{
+  double dist = sqrt(distSq);
+  // M_2_SQRTPI is 2/sqrt(PI)
+  double expTerm = alpha * M_2_SQRTPI * exp(-alpha * alpha * distSq);
+  en = erfc(alpha * dist) / dist;
+  vir = (en + expTerm) / distSq;
+  dEn = -0.5 * vir;
+  dVir = -(1.5 * vir + alpha * alpha * expTerm) / distSq;
+}
+
+//Cubic Hermite coefficients in powers of (r^2 - s0) for the interval
+//[s0, s0 + h] from the values and derivatives at both ends
+void Hermite(double *c, const double h, const double f0, const double f1,
+             const double d0, const double d1)
+{
+  double slope = (f1 - f0) / h;
+  c[0] = f0;
+  c[1] = d0;
+  c[2] = (3.0 * slope - 2.0 * d0 - d1) / h;
+  c[3] = (d0 + d1 - 2.0 * slope) / (h * h);
+}
+
+double Eval(const double *c, const double d)
+{
+  return c[0] + d * (c[1] + d * (c[2] + d * c[3]));
+}
+}
+
+EwaldRealTable::EwaldRealTable()
+{
+  for(uint b = 0; b < BOX_TOTAL; b++) {
+    table[b].start = 0.0;
+    table[b].end = 0.0;
+    table[b].shift = 0;
+    table[b].base = 0;
+    table[b].mask = 0;
+  }
+}
+
+void EwaldRealTable::Init(const uint b, const double alpha,
+                          const double rCutLow, const double rCutCoulomb,
+                          const double accuracy)
+{
+  Spline & s = table[b];
+  //1/r makes the table very fine close to zero, so short distances are
+  //always computed directly
+  double rStart = std::max(rCutLow, 1.0);
+  s.start = rStart * rStart;
+  s.end = rCutCoulomb * rCutCoulomb;
+  s.energy.clear();
+  s.virial.clear();
+  if(s.end <= s.start)
+    return;
+
+  int mantissaBits = MIN_BITS;
+  double error = Fill(s, mantissaBits, alpha);
+  while(error > accuracy && mantissaBits < MAX_BITS) {
+    mantissaBits++;
+    error = Fill(s, mantissaBits, alpha);
+  }
+
+  if(error > accuracy) {
+    printf("Warning: Box %d Ewald real space table reached %d mantissa bits "
+           "with relative error %1.3E, above the requested %1.3E!\n", b,
+           mantissaBits, error, accuracy);
+  }
+  printf("%s %-d %-27s %lu points, error %1.3E\n", "Info: Box ", b,
+         " Ewald real space table", s.energy.size() / 4, error);
+}
+
+double EwaldRealTable::Fill(Spline & s, const int mantissaBits,
+                            const double alpha) const
+{
+  s.shift = 52 - mantissaBits;
+  s.mask = ~((uint64_t(1) << s.shift) - 1);
+  s.base = Bits(s.start) >> s.shift;
+  //start of the table on the first interval boundary below RcutLow
+  s.start = FromBits(s.base << s.shift);
+  uint n = (uint)((Bits(s.end) >> s.shift) - s.base + 1);
+  s.energy.resize(4 * n);
+  s.virial.resize(4 * n);
+
+  double error = 0.0;
+  for(uint i = 0; i < n; i++) {
+    double s0 = FromBits((s.base + i) << s.shift);
+    double s1 = FromBits((s.base + i + 1) << s.shift);
+    double h = s1 - s0;
+    double en0, vir0, dEn0, dVir0, en1, vir1, dEn1, dVir1;
+    Exact(s0, alpha, en0, vir0, dEn0, dVir0);
+    Exact(s1, alpha, en1, vir1, dEn1, dVir1);
+    Hermite(&s.energy[4 * i], h, en0, en1, dEn0, dEn1);
+    Hermite(&s.virial[4 * i], h, vir0, vir1, dVir0, dVir1);
+
+    for(uint k = 1; k < 4; k++) {
+      double d = 0.25 * k * h;
+      double en, vir, dEn, dVir;
+      Exact(s0 + d, alpha, en, vir, dEn, dVir);
+      error = std::max(error, std::abs(Eval(&s.energy[4 * i], d) - en) / en);
+      error = std::max(error, std::abs(Eval(&s.virial[4 * i], d) - vir) / vir);
+    }
+  }
+  return error;
+}
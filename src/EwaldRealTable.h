@@ -0,0 +1,126 @@
+/*******************************************************************************
+GPU OPTIMIZED MONTE CARLO (GOMC) 2.75
+Copyright (C) 2022 GOMC Group
+A copy of the MIT License can be found in License.txt
+along with this program, also can be found at <https://opensource.org/licenses/MIT>.
+********************************************************************************/
+#ifndef EWALD_REAL_TABLE_H
+#define EWALD_REAL_TABLE_H
+
+#include "BasicTypes.h" //For uint
+#include "EnsemblePreprocessor.h" //For BOX_TOTAL
+#include <cstring>
+#include <stdint.h>
+#include <vector>
+
+//Tabulated real space Ewald terms, as cubic splines in r^2 so no sqrt is
+//needed for the lookup:
+//  energy(r^2) = erfc(alpha * r) / r
+//  virial(r^2) = (erfc(alpha * r) / r + 2 * alpha / sqrt(PI) *
+//                 exp(-alpha^2 * r^2)) / r^2
+//The intervals are found from the bits of r^2: the exponent and the top
+//mantissa bits give the index, so every power of two range of r^2 has the
+//same number of intervals and the spacing grows with r^2 like the length
+//scale of the functions. One table per box, from max(RcutLow, 1 A)^2 to
+//RcutCoulomb^2. Mantissa bits are added until the relative error of both
+//functions is below the requested accuracy. Distances outside of the table
+//return false, and the caller evaluates erfc and exp directly.
+class EwaldRealTable
+{
+public:
+  EwaldRealTable();
+
+  //Builds the table of box b
+  void Init(const uint b, const double alpha, const double rCutLow,
+            const double rCutCoulomb, const double accuracy);
+
+  bool Enabled(const uint b) const
+  {
+    return !table[b].energy.empty();
+  }
+
+  bool Energy(double & en, const double distSq, const uint b) const
+  {
+    return Lookup(en, table[b].energy, distSq, b);
+  }
+
+  bool Virial(double & vir, const double distSq, const uint b) const
+  {
+    return Lookup(vir, table[b].virial, distSq, b);
+  }
+
+  //Raw spline data for the SIMD pair kernel. For r^2 in the table, interval
+  //i = (bits(r^2) >> Shift) - Base starts at bits(r^2) & Mask and has four
+  //coefficients at 4 * i, in increasing power of r^2 - start of interval.
+  const double* EnergyCoef(const uint b) const
+  {
+    return &table[b].energy[0];
+  }
+  const double* VirialCoef(const uint b) const
+  {
+    return &table[b].virial[0];
+  }
+  double Start(const uint b) const
+  {
+    return table[b].start;
+  }
+  double End(const uint b) const
+  {
+    return table[b].end;
+  }
+  int Shift(const uint b) const
+  {
+    return table[b].shift;
+  }
+  uint64_t Base(const uint b) const
+  {
+    return table[b].base;
+  }
+  uint64_t Mask(const uint b) const
+  {
+    return table[b].mask;
+  }
+
+private:
+  struct Spline {
+    double start, end;
+    int shift;
+    uint64_t base, mask;
+    std::vector<double> energy, virial;
+  };
+
+  static uint64_t Bits(const double x)
+  {
+    uint64_t i;
+    std::memcpy(&i, &x, sizeof(double));
+    return i;
+  }
+
+  static double FromBits(const uint64_t i)
+  {
+    double x;
+    std::memcpy(&x, &i, sizeof(double));
+    return x;
+  }
+
+  bool Lookup(double & val, std::vector<double> const& coef,
+              const double distSq, const uint b) const
+  {
+    Spline const& s = table[b];
+    if(distSq < s.start || distSq >= s.end)
+      return false;
+    uint64_t bits = Bits(distSq);
+    const double *c = &coef[4 * ((bits >> s.shift) - s.base)];
+    double d = distSq - FromBits(bits & s.mask);
+    val = c[0] + d * (c[1] + d * (c[2] + d * c[3]));
+    return true;
+  }
+
+  //Fills the coefficients with the given number of mantissa bits, returns
+  //the largest relative error of the two functions between the points
+  double Fill(Spline & s, const int mantissaBits, const double alpha) const;
+
+  Spline table[BOX_TOTAL];
+};
+
+#endif /*EWALD_REAL_TABLE_H*/
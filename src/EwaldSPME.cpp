@@ -0,0 +1,481 @@
+/*******************************************************************************
+GPU OPTIMIZED MONTE CARLO (GOMC) 2.75
+Copyright (C) 2022 GOMC Group
+A copy of the MIT License can be found in License.txt
+along with this program, also can be found at <https://opensource.org/licenses/MIT>.
+********************************************************************************/
+#include "EwaldSPME.h"
+#include "System.h"                 //For init
+#include "StaticVals.h"             //For init
+#include "Coordinates.h"
+#include "BoxDimensions.h"
+#include "GeomLib.h"
+#include "NumLib.h"
+#include "GOMCEventsProfile.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace geom;
+
+namespace
+{
+//Mesh points per k-vector along an axis, before rounding up to a power of two
+const double MESH_SCALE = 1.25;
+
+//Cardinal B-spline weights M_n(w + j) for j = 0 .. n - 1 and 0 <= w < 1,
+//from M_n(x) = (x M_{n-1}(x) + (n - x) M_{n-1}(x - 1)) / (n - 1), and
+//their derivatives M_n'(x) = M_{n-1}(x) - M_{n-1}(x - 1) if dTheta is set
+void BSpline(const uint n, const double w, double *theta, double *dTheta)
+{
+  theta[0] = w;
+  theta[1] = 1.0 - w;
+  for(uint k = 3; k <= n; k++) {
+    if(k == n && dTheta != NULL) {
+      dTheta[0] = theta[0];
+      for(uint j = 1; j < n - 1; j++)
+        dTheta[j] = theta[j] - theta[j - 1];
+      dTheta[n - 1] = -theta[n - 2];
+    }
+    double div = 1.0 / (k - 1);
+    theta[k - 1] = div * (1.0 - w) * theta[k - 2];
+    for(uint j = k - 2; j > 0; j--)
+      theta[j] = div * ((w + j) * theta[j] + (k - w - j) * theta[j - 1]);
+    theta[0] = div * w * theta[0];
+  }
+}
+}
+
+EwaldSPME::EwaldSPME(StaticVals & stat, System & sys) : Ewald(stat, sys)
+{
+  phaseFactors = true;
+  order = 0;
+}
+
+void EwaldSPME::Init()
+{
+  //The spline error of a structure factor falls off as (m / K)^order. The
+  //order grows with the digits of Tolerance, which already set alpha and
+  //the reciprocal cutoff, so the mesh error stays below the Ewald
+  //truncation error
+  int digits = (int) ceil(-log10(ff.tolerance));
+  order = (uint) std::max(4, std::min(digits + 3, (int) MAX_ORDER));
+  Ewald::Init();
+
+  for(uint b = 0; b < BOXES_WITH_U_NB; b++) {
+    printf("Box: %d, SPME mesh: %u x %u x %u, B-spline order: %u\n", b,
+           meshAxisRef[b][0].size, meshAxisRef[b][1].size,
+           meshAxisRef[b][2].size, order);
+  }
+}
+
+void EwaldSPME::SetMeshAxis(MeshAxis &axis, const uint size) const
+{
+  if(axis.size == size)
+    return;
+
+  axis.size = size;
+  axis.bR.resize(size);
+  axis.bI.resize(size);
+  axis.cosT.resize(size);
+  axis.sinT.resize(size);
+  for(uint t = 0; t < size; t++) {
+    double angle = 2.0 * M_PI * t / size;
+    axis.cosT[t] = cos(angle);
+    axis.sinT[t] = sin(angle);
+  }
+
+  //b(m) = 1 / sum_l M(l) e^{-2 PI i m l / K}, over the integer points l
+  //where the spline is not zero
+  double theta[MAX_ORDER];
+  BSpline(order, 0.0, theta, NULL);
+  for(uint m = 0; m < size; m++) {
+    double re = 0.0, im = 0.0;
+    for(uint l = 1; l < order; l++) {
+      uint t = (m * l) & (size - 1);
+      re += theta[l] * axis.cosT[t];
+      im -= theta[l] * axis.sinT[t];
+    }
+    double den = re * re + im * im;
+    if(den < 1.0e-10) {
+      axis.bR[m] = 0.0;
+      axis.bI[m] = 0.0;
+    } else {
+      axis.bR[m] = re / den;
+      axis.bI[m] = -im / den;
+    }
+  }
+}
+
+void EwaldSPME::RecipInit(uint box, BoxDimensions const& boxAxes)
+{
+  Ewald::RecipInit(box, boxAxes);
+  //more than 2 * phaseMax + 1 points, so m and -m are different mesh points
+  for(uint d = 0; d < 3; d++) {
+    uint size = (uint) ceil(MESH_SCALE * (2 * phaseMax[box][d] + 1));
+    SetMeshAxis(meshAxis[box][d], FFT3D::NextPowerOfTwo(size));
+  }
+}
+
+void EwaldSPME::AtomSpline(XYZ const& pos, const uint box, const bool ref,
+                           int *k0, double (*theta)[MAX_ORDER],
+                           double (*dTheta)[MAX_ORDER]) const
+{
+  const MeshAxis *axis = ref ? meshAxisRef[box] : meshAxis[box];
+  const XYZ *pAxis = ref ? phaseAxisRef[box] : phaseAxis[box];
+  for(uint d = 0; d < 3; d++) {
+    //Dot(phaseAxis, pos) is 2 PI times the fractional coordinate
+    double u = axis[d].size * Dot(pAxis[d], pos) * (0.5 * M_1_PI);
+    double lower = floor(u);
+    k0[d] = (int) lower;
+    BSpline(order, u - lower, theta[d], dTheta == NULL ? NULL : dTheta[d]);
+  }
+}
+
+void EwaldSPME::PhaseSetup(XYZArray const& coords, const uint first,
+                           const uint length, const uint slot, const uint box,
+                           const bool ref) const
+{
+  const MeshAxis *axis = ref ? meshAxisRef[box] : meshAxis[box];
+  const int *nMax = ref ? phaseMaxRef[box] : phaseMax[box];
+  uint stride = nMax[0] + nMax[1] + nMax[2] + 3;
+  if(phaseR.size() < (slot + length) * stride) {
+    phaseR.resize((slot + length) * stride);
+    phaseI.resize((slot + length) * stride);
+  }
+
+  int k0[3];
+  double theta[3][MAX_ORDER];
+  uint point[MAX_ORDER], step[MAX_ORDER];
+  for(uint p = 0; p < length; p++) {
+    double *re = &phaseR[(slot + p) * stride];
+    double *im = &phaseI[(slot + p) * stride];
+    AtomSpline(coords[first + p], box, ref, k0, theta, NULL);
+    for(uint d = 0; d < 3; d++) {
+      MeshAxis const& ax = axis[d];
+      uint mask = ax.size - 1;
+      //e^{2 PI i n g / K} of mesh point g = k0 - j is entry n * g of the table
+      for(uint j = 0; j < order; j++) {
+        point[j] = 0;
+        step[j] = (uint) (k0[d] - (int) j) & mask;
+      }
+      for(int n = 0; n <= nMax[d]; n++) {
+        double sumR = 0.0, sumI = 0.0;
+        for(uint j = 0; j < order; j++) {
+          sumR += theta[d][j] * ax.cosT[point[j]];
+          sumI += theta[d][j] * ax.sinT[point[j]];
+          point[j] = (point[j] + step[j]) & mask;
+        }
+        re[n] = ax.bR[n] * sumR - ax.bI[n] * sumI;
+        im[n] = ax.bR[n] * sumI + ax.bI[n] * sumR;
+      }
+      re += nMax[d] + 1;
+      im += nMax[d] + 1;
+    }
+  }
+}
+
+void EwaldSPME::MeshSums(uint box, XYZArray const& molCoords, const bool ref)
+{
+  const MeshAxis *axis = ref ? meshAxisRef[box] : meshAxis[box];
+  uint size0 = axis[0].size, size1 = axis[1].size, size2 = axis[2].size;
+  uint mask0 = size0 - 1, mask1 = size1 - 1, mask2 = size2 - 1;
+  fft.Resize(size0, size1, size2);
+  grid.assign(fft.Size(), std::complex<double>(0.0, 0.0));
+
+  int k0[3];
+  double theta[3][MAX_ORDER];
+  MoleculeLookup::box_iterator thisMol = molLookup.BoxBegin(box);
+  MoleculeLookup::box_iterator end = molLookup.BoxEnd(box);
+  while (thisMol != end) {
+    double lambdaCoef = GetLambdaCoef(*thisMol, box);
+    uint start = mols.MolStart(*thisMol);
+    uint length = mols.GetKind(*thisMol).NumAtoms();
+    for (uint atom = start; atom < start + length; atom++) {
+      if(particleHasNoCharge[atom]) {
+        continue;
+      }
+      //we assume all atom charges are scaled with lambda
+      double charge = particleCharge[atom] * lambdaCoef;
+      AtomSpline(molCoords[atom], box, ref, k0, theta, NULL);
+      for(uint j0 = 0; j0 < order; j0++) {
+        uint g0 = (uint) (k0[0] - (int) j0) & mask0;
+        double w0 = charge * theta[0][j0];
+        for(uint j1 = 0; j1 < order; j1++) {
+          uint g1 = (uint) (k0[1] - (int) j1) & mask1;
+          double w01 = w0 * theta[1][j1];
+          std::complex<double> *row = &grid[(g0 * size1 + g1) * size2];
+          for(uint j2 = 0; j2 < order; j2++) {
+            uint g2 = (uint) (k0[2] - (int) j2) & mask2;
+            row[g2] += w01 * theta[2][j2];
+          }
+        }
+      }
+    }
+    thisMol++;
+  }
+
+  fft.Transform(&grid[0], 1);
+
+  const int *n = ref ? kIdxRef[box] : kIdx[box];
+  int count = (int) (ref ? imageSizeRef[box] : imageSize[box]);
+#ifdef _OPENMP
+  #pragma omp parallel for default(none) shared(axis, box, count, mask0, \
+  mask1, mask2, n, size1, size2)
+#endif
+  for (int i = 0; i < count; i++) {
+    uint m0 = (uint) n[3 * i] & mask0;
+    uint m1 = (uint) n[3 * i + 1] & mask1;
+    uint m2 = (uint) n[3 * i + 2] & mask2;
+    std::complex<double> modulus =
+      std::complex<double>(axis[0].bR[m0], axis[0].bI[m0]) *
+      std::complex<double>(axis[1].bR[m1], axis[1].bI[m1]) *
+      std::complex<double>(axis[2].bR[m2], axis[2].bI[m2]);
+    std::complex<double> sum = modulus * grid[(m0 * size1 + m1) * size2 + m2];
+    sumRnew[box][i] = sum.real();
+    sumInew[box][i] = sum.imag();
+  }
+}
+
+//The gradient of E = sum_m prefact(m) |S(m)|^2 for the charge spread on
+//mesh point g is phi(g) = 2 Re sum_m prefact(m) conj(S(m)) b(m) e^{2 PI i m.g / K},
+//the transform of a mesh holding that term at m and its conjugate at -m
+void EwaldSPME::PotentialMesh(uint box, const double *sumR,
+                              const double *sumI) const
+{
+  const MeshAxis *axis = meshAxisRef[box];
+  uint size0 = axis[0].size, size1 = axis[1].size, size2 = axis[2].size;
+  uint mask0 = size0 - 1, mask1 = size1 - 1, mask2 = size2 - 1;
+  fft.Resize(size0, size1, size2);
+  grid.assign(fft.Size(), std::complex<double>(0.0, 0.0));
+
+  const int *n = kIdxRef[box];
+  for (uint i = 0; i < imageSizeRef[box]; i++) {
+    uint m0 = (uint) n[3 * i] & mask0;
+    uint m1 = (uint) n[3 * i + 1] & mask1;
+    uint m2 = (uint) n[3 * i + 2] & mask2;
+    std::complex<double> modulus =
+      std::complex<double>(axis[0].bR[m0], axis[0].bI[m0]) *
+      std::complex<double>(axis[1].bR[m1], axis[1].bI[m1]) *
+      std::complex<double>(axis[2].bR[m2], axis[2].bI[m2]);
+    std::complex<double> term = prefactRef[box][i] * modulus *
+                                std::complex<double>(sumR[i], -sumI[i]);
+    grid[(m0 * size1 + m1) * size2 + m2] += term;
+    uint neg0 = (uint) (-n[3 * i]) & mask0;
+    uint neg1 = (uint) (-n[3 * i + 1]) & mask1;
+    uint neg2 = (uint) (-n[3 * i + 2]) & mask2;
+    grid[(neg0 * size1 + neg1) * size2 + neg2] += std::conj(term);
+  }
+
+  fft.Transform(&grid[0], 1);
+}
+
+XYZ EwaldSPME::MeshGradient(XYZ const& pos, const uint box) const
+{
+  const MeshAxis *axis = meshAxisRef[box];
+  uint size1 = axis[1].size, size2 = axis[2].size;
+  uint mask0 = axis[0].size - 1, mask1 = size1 - 1, mask2 = size2 - 1;
+  int k0[3];
+  double theta[3][MAX_ORDER], dTheta[3][MAX_ORDER];
+  AtomSpline(pos, box, true, k0, theta, dTheta);
+
+  double grad0 = 0.0, grad1 = 0.0, grad2 = 0.0;
+  for(uint j0 = 0; j0 < order; j0++) {
+    uint g0 = (uint) (k0[0] - (int) j0) & mask0;
+    for(uint j1 = 0; j1 < order; j1++) {
+      uint g1 = (uint) (k0[1] - (int) j1) & mask1;
+      const std::complex<double> *row = &grid[(g0 * size1 + g1) * size2];
+      double sum = 0.0, dSum = 0.0;
+      for(uint j2 = 0; j2 < order; j2++) {
+        double phi = row[(uint) (k0[2] - (int) j2) & mask2].real();
+        sum += phi * theta[2][j2];
+        dSum += phi * dTheta[2][j2];
+      }
+      grad0 += dTheta[0][j0] * theta[1][j1] * sum;
+      grad1 += theta[0][j0] * dTheta[1][j1] * sum;
+      grad2 += theta[0][j0] * theta[1][j1] * dSum;
+    }
+  }
+
+  //mesh position u_d = size_d * Dot(phaseAxis_d, pos) / (2 PI)
+  XYZ grad = phaseAxisRef[box][0] * (grad0 * axis[0].size);
+  grad += phaseAxisRef[box][1] * (grad1 * axis[1].size);
+  grad += phaseAxisRef[box][2] * (grad2 * axis[2].size);
+  return grad * (0.5 * M_1_PI);
+}
+
+void EwaldSPME::BoxReciprocalSetup(uint box, XYZArray const& molCoords)
+{
+  if (box < BOXES_WITH_U_NB) {
+    GOMC_EVENT_START(1, GomcProfileEvent::RECIP_BOX_SETUP);
+    MeshSums(box, molCoords, false);
+    GOMC_EVENT_STOP(1, GomcProfileEvent::RECIP_BOX_SETUP);
+  }
+}
+
+void EwaldSPME::BoxReciprocalSums(uint box, XYZArray const& molCoords)
+{
+  if (box < BOXES_WITH_U_NB) {
+    GOMC_EVENT_START(1, GomcProfileEvent::RECIP_BOX_SETUP);
+    MeshSums(box, molCoords, true);
+    GOMC_EVENT_STOP(1, GomcProfileEvent::RECIP_BOX_SETUP);
+  }
+}
+
+//The mesh tables only depend on the mesh size, so they are copied only
+//when it changed
+void EwaldSPME::SetRecipRef(uint box)
+{
+  Ewald::SetRecipRef(box);
+  for(uint d = 0; d < 3; d++) {
+    if(meshAxisRef[box][d].size != meshAxis[box][d].size)
+      meshAxisRef[box][d] = meshAxis[box][d];
+  }
+}
+
+void EwaldSPME::UpdateRecipVec(uint box)
+{
+  Ewald::UpdateRecipVec(box);
+  for(uint d = 0; d < 3; d++) {
+    std::swap(meshAxis[box][d], meshAxisRef[box][d]);
+  }
+}
+
+Virial EwaldSPME::VirialReciprocal(Virial& virial, uint box) const
+{
+  Virial tempVir = virial;
+  if (box >= BOXES_WITH_U_NB)
+    return tempVir;
+
+  GOMC_EVENT_START(1, GomcProfileEvent::RECIP_BOX_VIRIAL);
+  double wT11 = 0.0, wT12 = 0.0, wT13 = 0.0;
+  double wT22 = 0.0, wT23 = 0.0, wT33 = 0.0;
+
+  double constVal = 1.0 / (4.0 * ff.alphaSq[box]);
+
+#ifdef _OPENMP
+  #pragma omp parallel for default(none) shared(box, constVal) reduction(+:wT11, wT22, wT33)
+#endif
+  for (int i = 0; i < (int) imageSizeRef[box]; i++) {
+    double factor = prefactRef[box][i] * (sumRref[box][i] * sumRref[box][i] +
+                                          sumIref[box][i] * sumIref[box][i]);
+
+    wT11 += factor * (1.0 - 2.0 * (constVal + 1.0 / hsqrRef[box][i]) *
+                      kxRef[box][i] * kxRef[box][i]);
+
+    wT22 += factor * (1.0 - 2.0 * (constVal + 1.0 / hsqrRef[box][i]) *
+                      kyRef[box][i] * kyRef[box][i]);
+
+    wT33 += factor * (1.0 - 2.0 * (constVal + 1.0 / hsqrRef[box][i]) *
+                      kzRef[box][i] * kzRef[box][i]);
+  }
+
+  //Intramolecular part, the gradient of each atom dotted with its distance
+  //to the molecule COM
+  PotentialMesh(box, sumRref[box], sumIref[box]);
+  MoleculeLookup::box_iterator thisMol = molLookup.BoxBegin(box),
+                               end = molLookup.BoxEnd(box);
+  while (thisMol != end) {
+    uint length = mols.GetKind(*thisMol).NumAtoms();
+    uint startAtom = mols.MolStart(*thisMol);
+    XYZ comC = currentCOM.Get(*thisMol);
+    double lambdaCoef = GetLambdaCoef(*thisMol, box);
+
+    for (uint atom = startAtom; atom < startAtom + length; atom++) {
+      if(particleHasNoCharge[atom]) {
+        continue;
+      }
+      // need to unwrap the atom coordinate
+      XYZ atomC = currentCoords.Get(atom);
+      currentAxes.UnwrapPBC(atomC, box, comC);
+      XYZ diffC = atomC - comC;
+      //scale the charge with lambda for Free energy calc
+      double charge = particleCharge[atom] * lambdaCoef;
+      XYZ grad = MeshGradient(currentCoords.Get(atom), box) * charge;
+
+      wT11 += grad.x * diffC.x;
+      wT22 += grad.y * diffC.y;
+      wT33 += grad.z * diffC.z;
+    }
+    ++thisMol;
+  }
+
+  // set the all tensor values
+  tempVir.recipTens[0][0] = wT11;
+  tempVir.recipTens[0][1] = wT12;
+  tempVir.recipTens[0][2] = wT13;
+
+  tempVir.recipTens[1][0] = wT12;
+  tempVir.recipTens[1][1] = wT22;
+  tempVir.recipTens[1][2] = wT23;
+
+  tempVir.recipTens[2][0] = wT13;
+  tempVir.recipTens[2][1] = wT23;
+  tempVir.recipTens[2][2] = wT33;
+
+  // setting virial of reciprocal space
+  tempVir.recip = wT11 + wT22 + wT33;
+  GOMC_EVENT_STOP(1, GomcProfileEvent::RECIP_BOX_VIRIAL);
+
+  return tempVir;
+}
+
+//calculate reciprocal force term for a box with molCoords, which are the
+//coordinates sumRnew and sumInew were computed for
+void EwaldSPME::BoxForceReciprocal(XYZArray const& molCoords,
+                                   XYZArray& atomForceRec,
+                                   XYZArray& molForceRec,
+                                   uint box)
+{
+  if(multiParticleEnabled && (box < BOXES_WITH_U_NB)) {
+    GOMC_EVENT_START(1, GomcProfileEvent::RECIP_BOX_FORCE);
+    // M_2_SQRTPI is 2/sqrt(PI)
+    double constValue = ff.alpha[box] * M_2_SQRTPI;
+    PotentialMesh(box, sumRnew[box], sumInew[box]);
+
+    MoleculeLookup::box_iterator thisMol = molLookup.BoxBegin(box);
+    MoleculeLookup::box_iterator end = molLookup.BoxEnd(box);
+
+    while(thisMol != end) {
+      uint molIndex = *thisMol;
+      uint length, start, p;
+      double distSq;
+      XYZ distVect;
+      molForceRec.Set(molIndex, 0.0, 0.0, 0.0);
+      length = mols.GetKind(molIndex).NumAtoms();
+      start = mols.MolStart(molIndex);
+      double lambdaCoef = GetLambdaCoef(molIndex, box);
+
+      for(p = start; p < start + length; p++) {
+        double X = 0.0, Y = 0.0, Z = 0.0;
+
+        if(!particleHasNoCharge[p]) {
+          // subtract the intra forces(correction)
+          for(uint j = start; j < start + length; j++) {
+            //no self term in force
+            if(p != j) {
+              currentAxes.InRcut(distSq, distVect, molCoords, p, j, box);
+              double dist = sqrt(distSq);
+              double expConstValue = exp(-1.0 * ff.alphaSq[box] * distSq);
+              double qiqj = particleCharge[p] * particleCharge[j] * num::qqFact;
+              double intraForce = qiqj * lambdaCoef * lambdaCoef / distSq;
+              intraForce *= ((erf(ff.alpha[box] * dist) / dist) -
+                             constValue * expConstValue);
+              X -= intraForce * distVect.x;
+              Y -= intraForce * distVect.y;
+              Z -= intraForce * distVect.z;
+            }
+          }
+          XYZ grad = MeshGradient(molCoords.Get(p), box) *
+                     (particleCharge[p] * lambdaCoef);
+          X -= grad.x;
+          Y -= grad.y;
+          Z -= grad.z;
+        }
+        atomForceRec.Set(p, X, Y, Z);
+        molForceRec.Add(molIndex, X, Y, Z);
+      }
+      thisMol++;
+    }
+    GOMC_EVENT_STOP(1, GomcProfileEvent::RECIP_BOX_FORCE);
+  }
+}
@@ -0,0 +1,108 @@
+/*******************************************************************************
+GPU OPTIMIZED MONTE CARLO (GOMC) 2.75
+Copyright (C) 2022 GOMC Group
+A copy of the MIT License can be found in License.txt
+along with this program, also can be found at <https://opensource.org/licenses/MIT>.
+********************************************************************************/
+#ifndef EWALDSPME_H
+#define EWALDSPME_H
+
+#include "Ewald.h"
+#include "FFT3D.h"
+#include <complex>
+#include <vector>
+
+//
+//    Smooth particle mesh Ewald (Essmann et al., J. Chem. Phys. 103, 8577).
+//    The k-vectors, prefactors and structure factor sums are the ones of
+//    Ewald, but a structure factor is
+//      S(m) = b1(m1) b2(m2) b3(m3) * sum_g Q(g) e^{2 PI i m.g / K},
+//    where the charges are spread on a mesh Q of K1 x K2 x K3 points with
+//    cardinal B-splines and b are the B-spline moduli.
+//    Whole box sums, forces and the virial use a 3D FFT of the mesh, so they
+//    scale as N + K log K instead of N * K. Single molecule changes keep the
+//    k-space sums of Ewald with the per-atom spline factors of PhaseSetup,
+//    which are the same terms the mesh adds up for that atom.
+//
+
+class EwaldSPME : public Ewald
+{
+public:
+
+  EwaldSPME(StaticVals & stat, System & sys);
+
+  virtual void Init();
+
+  //initialize term used for ewald calculation and the mesh of the box
+  virtual void RecipInit(uint box, BoxDimensions const& boxAxes);
+
+  //compute reciprocal term for a box with a new volume
+  virtual void BoxReciprocalSetup(uint box, XYZArray const& molCoords);
+
+  //compute reciprocal term for a box when not testing a volume change
+  virtual void BoxReciprocalSums(uint box, XYZArray const& molCoords);
+
+  //calculate reciprocal force term for a box
+  virtual Virial VirialReciprocal(Virial& virial, uint box) const;
+
+  //back up reciprocal value to Ref (will be called during initialization)
+  virtual void SetRecipRef(uint box);
+
+  //update kx, ky, kz, hsqr, prefact and the mesh
+  virtual void UpdateRecipVec(uint box);
+
+  //calculate reciprocal force term for a box with molCoords
+  virtual void BoxForceReciprocal(XYZArray const& molCoords,
+                                  XYZArray& atomForceRec,
+                                  XYZArray& molForceRec,
+                                  uint box);
+
+protected:
+  //spline factors of every axis, b(n) sum_j M(w + j) e^{2 PI i n (k0 - j) / K}
+  virtual void PhaseSetup(XYZArray const& coords, const uint first,
+                          const uint length, const uint slot, const uint box,
+                          const bool ref) const;
+
+private:
+  //largest B-spline order
+  static const uint MAX_ORDER = 12;
+
+  //mesh points and tables of one axis of the mesh
+  struct MeshAxis {
+    uint size;
+    //B-spline modulus b(m) for m = 0 .. size - 1
+    std::vector<double> bR, bI;
+    //e^{2 PI i t / size} for t = 0 .. size - 1
+    std::vector<double> cosT, sinT;
+    MeshAxis() : size(0) {}
+  };
+
+  //builds the tables of axis for a mesh of size points
+  void SetMeshAxis(MeshAxis &axis, const uint size) const;
+
+  //mesh position u, first mesh point k0 and spline weights of pos along
+  //each axis
+  void AtomSpline(XYZ const& pos, const uint box, const bool ref, int *k0,
+                  double (*theta)[MAX_ORDER],
+                  double (*dTheta)[MAX_ORDER]) const;
+
+  //spreads the charges of the box on the mesh and sets sumRnew and sumInew
+  void MeshSums(uint box, XYZArray const& molCoords, const bool ref);
+
+  //fills the mesh with the potential of the structure factors sumR, sumI
+  //at the Ref k-vectors
+  void PotentialMesh(uint box, const double *sumR, const double *sumI) const;
+
+  //gradient of the reciprocal energy for a unit charge at pos, from the
+  //potential mesh
+  XYZ MeshGradient(XYZ const& pos, const uint box) const;
+
+  //B-spline order, from Tolerance
+  uint order;
+
+  MeshAxis meshAxis[BOXES_WITH_U_NB][3], meshAxisRef[BOXES_WITH_U_NB][3];
+  mutable FFT3D fft;
+  mutable std::vector<std::complex<double> > grid;
+};
+
+#endif /*EWALDSPME_H*/
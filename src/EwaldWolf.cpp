@@ -0,0 +1,329 @@
+/*******************************************************************************
+GPU OPTIMIZED MONTE CARLO (GOMC) 2.75
+Copyright (C) 2022 GOMC Group
+A copy of the MIT License can be found in License.txt
+along with this program, also can be found at <https://opensource.org/licenses/MIT>.
+********************************************************************************/
+#include "EwaldWolf.h"
+#include "EnergyTypes.h"            //Energy structs
+#include "System.h"                 //For init
+#include "StaticVals.h"             //For init
+#include "Forcefield.h"
+#include "MoleculeKind.h"
+#include "Coordinates.h"
+#include "BoxDimensions.h"
+#include "TrialMol.h"
+#include "NumLib.h"
+#include "GOMCEventsProfile.h"
+
+EwaldWolf::EwaldWolf(StaticVals & stat, System & sys) :
+  NoEwald(stat, sys) {}
+
+void EwaldWolf::Init()
+{
+  for(uint m = 0; m < mols.count; ++m) {
+    const MoleculeKind& molKind = mols.GetKind(m);
+    for(uint a = 0; a < molKind.NumAtoms(); ++a) {
+      particleKind.push_back(molKind.AtomKind(a));
+      particleMol.push_back(m);
+      particleCharge.push_back(molKind.AtomCharge(a));
+      if(std::abs(molKind.AtomCharge(a)) < 0.000000001) {
+        particleHasNoCharge.push_back(true);
+      } else {
+        particleHasNoCharge.push_back(false);
+      }
+    }
+  }
+
+  for(uint b = 0; b < BOXES_WITH_U_NB; ++b) {
+    printf("Box: %d, Wolf alpha: %.6f, energy shift: %.6E, force shift: %.6E\n",
+           b, ff.alpha[b], ff.wolfShift[b], ff.wolfForceShift[b]);
+  }
+}
+
+double EwaldWolf::PairCorrection(const double distSq, const uint box) const
+{
+  double dist = sqrt(distSq);
+  double correction = -erf(ff.alpha[box] * dist) / dist;
+  if(distSq < ff.rCutCoulombSq[box]) {
+    correction += ff.wolfForceShift[box] * (dist - ff.rCutCoulomb[box]) -
+                  ff.wolfShift[box];
+  }
+  return correction;
+}
+
+double EwaldWolf::SelfCoef(const uint box) const
+{
+  // M_2_SQRTPI is 2/sqrt(PI), so need to multiply by 0.5 to get sqrt(PI)
+  return (0.5 * ff.wolfShift[box] + ff.alpha[box] * M_2_SQRTPI * 0.5) *
+         num::qqFact;
+}
+
+//calculate self term for a box, using system lambda
+double EwaldWolf::BoxSelf(uint box) const
+{
+  if (box >= BOXES_WITH_U_NB)
+    return 0.0;
+
+  GOMC_EVENT_START(1, GomcProfileEvent::SELF_BOX);
+  double self = 0.0;
+  double molSelfEnergy;
+  uint i, j, length, molNum;
+  double lambdaCoef = 1.0;
+
+  for (i = 0; i < mols.GetKindsCount(); i++) {
+    MoleculeKind const& thisKind = mols.kinds[i];
+    length = thisKind.NumAtoms();
+    molNum = molLookup.NumKindInBox(i, box);
+    molSelfEnergy = 0.0;
+    if(lambdaRef.KindIsFractional(i, box)) {
+      //If a molecule is fractional, we subtract the fractional molecule and
+      // add it later
+      --molNum;
+      //returns lambda and not sqrt(lambda)
+      lambdaCoef = lambdaRef.GetLambdaCoulomb(i, box);
+    }
+
+    for (j = 0; j < length; j++) {
+      molSelfEnergy += (thisKind.AtomCharge(j) * thisKind.AtomCharge(j));
+    }
+    self += (molSelfEnergy * molNum);
+    if(lambdaRef.KindIsFractional(i, box)) {
+      //Add the fractional molecule part
+      self += (molSelfEnergy * lambdaCoef);
+    }
+  }
+
+  self *= -1.0 * SelfCoef(box);
+  GOMC_EVENT_STOP(1, GomcProfileEvent::SELF_BOX);
+  return self;
+}
+
+//calculate the intramolecular correction force, the only force term
+//besides the pair kernels
+void EwaldWolf::BoxForceReciprocal(XYZArray const& molCoords,
+                                   XYZArray& atomForceRec,
+                                   XYZArray& molForceRec,
+                                   uint box)
+{
+  if(!multiParticleEnabled || box >= BOXES_WITH_U_NB)
+    return;
+
+  GOMC_EVENT_START(1, GomcProfileEvent::RECIP_BOX_FORCE);
+  // M_2_SQRTPI is 2/sqrt(PI)
+  double constValue = ff.alpha[box] * M_2_SQRTPI;
+  MoleculeLookup::box_iterator thisMol = molLookup.BoxBegin(box);
+  MoleculeLookup::box_iterator end = molLookup.BoxEnd(box);
+
+  while(thisMol != end) {
+    uint molIndex = *thisMol;
+    uint length, start, p;
+    double distSq;
+    XYZ distVect;
+    molForceRec.Set(molIndex, 0.0, 0.0, 0.0);
+    length = mols.GetKind(molIndex).NumAtoms();
+    start = mols.MolStart(molIndex);
+    double lambdaCoef = GetLambdaCoef(molIndex, box);
+
+    for(p = start; p < start + length; p++) {
+      double X = 0.0, Y = 0.0, Z = 0.0;
+
+      if(!particleHasNoCharge[p]) {
+        for(uint j = start; j < start + length; j++) {
+          //no self term in force
+          if(p != j) {
+            currentAxes.InRcut(distSq, distVect, molCoords, p, j, box);
+            double dist = sqrt(distSq);
+            double expConstValue = exp(-1.0 * ff.alphaSq[box] * distSq);
+            double qiqj = particleCharge[p] * particleCharge[j] * num::qqFact *
+                          lambdaCoef * lambdaCoef;
+            double intraForce = qiqj / distSq *
+                                ((erf(ff.alpha[box] * dist) / dist) -
+                                 constValue * expConstValue);
+            if(distSq < ff.rCutCoulombSq[box])
+              intraForce += qiqj * ff.wolfForceShift[box] / dist;
+            X -= intraForce * distVect.x;
+            Y -= intraForce * distVect.y;
+            Z -= intraForce * distVect.z;
+          }
+        }
+      }
+      atomForceRec.Set(p, X, Y, Z);
+      molForceRec.Add(molIndex, X, Y, Z);
+    }
+    thisMol++;
+  }
+  GOMC_EVENT_STOP(1, GomcProfileEvent::RECIP_BOX_FORCE);
+}
+
+//calculate correction term for a molecule, with system lambda
+double EwaldWolf::MolCorrection(uint molIndex, uint box) const
+{
+  if (box >= BOXES_WITH_U_NB)
+    return 0.0;
+
+  GOMC_EVENT_START(1, GomcProfileEvent::CORR_MOL);
+  double distSq;
+  double correction = 0.0;
+  XYZ virComponents;
+
+  MoleculeKind& thisKind = mols.kinds[mols.kIndex[molIndex]];
+  uint atomSize = thisKind.NumAtoms();
+  uint start = mols.MolStart(molIndex);
+  double lambdaCoef = GetLambdaCoef(molIndex, box);
+
+  for (uint i = 0; i < atomSize; i++) {
+    if(particleHasNoCharge[start + i]) {
+      continue;
+    }
+    for (uint j = i + 1; j < atomSize; j++) {
+      currentAxes.InRcut(distSq, virComponents, currentCoords,
+                         start + i, start + j, box);
+      correction += (thisKind.AtomCharge(i) * thisKind.AtomCharge(j) *
+                     PairCorrection(distSq, box));
+    }
+  }
+
+  GOMC_EVENT_STOP(1, GomcProfileEvent::CORR_MOL);
+  return num::qqFact * correction * lambdaCoef * lambdaCoef;
+}
+
+//calculate correction term for a molecule with lambda = 1
+double EwaldWolf::SwapCorrection(const cbmc::TrialMol& trialMol) const
+{
+  uint box = trialMol.GetBox();
+  if (box >= BOXES_WITH_U_NB)
+    return 0.0;
+
+  GOMC_EVENT_START(1, GomcProfileEvent::CORR_SWAP);
+  double distSq;
+  double correction = 0.0;
+  XYZ virComponents;
+  const MoleculeKind& thisKind = trialMol.GetKind();
+  uint atomSize = thisKind.NumAtoms();
+
+  for (uint i = 0; i < atomSize; i++) {
+    for (uint j = i + 1; j < atomSize; j++) {
+      currentAxes.InRcut(distSq, virComponents, trialMol.GetCoords(),
+                         i, j, box);
+      correction += (thisKind.AtomCharge(i) * thisKind.AtomCharge(j) *
+                     PairCorrection(distSq, box));
+    }
+  }
+  GOMC_EVENT_STOP(1, GomcProfileEvent::CORR_SWAP);
+  return num::qqFact * correction;
+}
+
+//calculate correction term for a molecule with system lambda
+double EwaldWolf::SwapCorrection(const cbmc::TrialMol& trialMol,
+                                 const uint molIndex) const
+{
+  uint box = trialMol.GetBox();
+  if (box >= BOXES_WITH_U_NB)
+    return 0.0;
+
+  GOMC_EVENT_START(1, GomcProfileEvent::CORR_SWAP);
+  double distSq;
+  double correction = 0.0;
+  XYZ virComponents;
+  const MoleculeKind& thisKind = trialMol.GetKind();
+  uint atomSize = thisKind.NumAtoms();
+  uint start = mols.MolStart(molIndex);
+  double lambdaCoef = GetLambdaCoef(molIndex, box);
+
+  for (uint i = 0; i < atomSize; i++) {
+    if(particleHasNoCharge[start + i]) {
+      continue;
+    }
+    for (uint j = i + 1; j < atomSize; j++) {
+      currentAxes.InRcut(distSq, virComponents, trialMol.GetCoords(),
+                         i, j, box);
+      correction += (thisKind.AtomCharge(i) * thisKind.AtomCharge(j) *
+                     PairCorrection(distSq, box));
+    }
+  }
+  GOMC_EVENT_STOP(1, GomcProfileEvent::CORR_SWAP);
+  return num::qqFact * correction * lambdaCoef * lambdaCoef;
+}
+
+//It's called if we transfer one molecule from one box to another
+double EwaldWolf::SwapSelf(const cbmc::TrialMol& trialMol) const
+{
+  uint box = trialMol.GetBox();
+  if (box >= BOXES_WITH_U_NB)
+    return 0.0;
+
+  GOMC_EVENT_START(1, GomcProfileEvent::SELF_SWAP);
+  MoleculeKind const& thisKind = trialMol.GetKind();
+  uint atomSize = thisKind.NumAtoms();
+  double en_self = 0.0;
+
+  for (uint i = 0; i < atomSize; i++) {
+    en_self -= (thisKind.AtomCharge(i) * thisKind.AtomCharge(i));
+  }
+  GOMC_EVENT_STOP(1, GomcProfileEvent::SELF_SWAP);
+  return en_self * SelfCoef(box);
+}
+
+//It's called in free energy calculation to calculate the change in
+// self energy in all lambda states
+void EwaldWolf::ChangeSelf(Energy *energyDiff, Energy &dUdL_Coul,
+                           const std::vector<double> &lambda_Coul,
+                           const uint iState, const uint molIndex,
+                           const uint box) const
+{
+  uint atomSize = mols.GetKind(molIndex).NumAtoms();
+  uint start = mols.MolStart(molIndex);
+  uint lambdaSize = lambda_Coul.size();
+  double coefDiff, en_self = 0.0;
+  //Calculate the self energy with lambda = 1
+  for (uint i = 0; i < atomSize; i++) {
+    en_self += (particleCharge[i + start] * particleCharge[i + start]);
+  }
+  en_self *= -1.0 * SelfCoef(box);
+
+  //Calculate the energy difference for each lambda state
+  for (uint s = 0; s < lambdaSize; s++) {
+    coefDiff = lambda_Coul[s] - lambda_Coul[iState];
+    energyDiff[s].self += coefDiff * en_self;
+  }
+  //Calculate du/dl of self for current state, for linear scaling
+  dUdL_Coul.self += en_self;
+}
+
+//It's called in free energy calculation to calculate the change in
+// correction energy in all lambda states
+void EwaldWolf::ChangeCorrection(Energy *energyDiff, Energy &dUdL_Coul,
+                                 const std::vector<double> &lambda_Coul,
+                                 const uint iState, const uint molIndex,
+                                 const uint box) const
+{
+  uint atomSize = mols.GetKind(molIndex).NumAtoms();
+  uint start = mols.MolStart(molIndex);
+  uint lambdaSize = lambda_Coul.size();
+  double coefDiff, distSq, correction = 0.0;
+  XYZ virComponents;
+
+  //Calculate the correction energy with lambda = 1
+  for (uint i = 0; i < atomSize; i++) {
+    if(particleHasNoCharge[start + i]) {
+      continue;
+    }
+
+    for (uint j = i + 1; j < atomSize; j++) {
+      distSq = 0.0;
+      currentAxes.InRcut(distSq, virComponents, currentCoords,
+                         start + i, start + j, box);
+      correction += (particleCharge[i + start] * particleCharge[j + start] *
+                     PairCorrection(distSq, box));
+    }
+  }
+  correction *= num::qqFact;
+  //Calculate the energy difference for each lambda state
+  for (uint s = 0; s < lambdaSize; s++) {
+    coefDiff = lambda_Coul[s] - lambda_Coul[iState];
+    energyDiff[s].correction += coefDiff * correction;
+  }
+  //Calculate du/dl of correction for current state, for linear scaling
+  dUdL_Coul.correction += correction;
+}
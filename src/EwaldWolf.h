@@ -0,0 +1,78 @@
+/*******************************************************************************
+GPU OPTIMIZED MONTE CARLO (GOMC) 2.75
+Copyright (C) 2022 GOMC Group
+A copy of the MIT License can be found in License.txt
+along with this program, also can be found at <https://opensource.org/licenses/MIT>.
+********************************************************************************/
+#ifndef EWALDWOLF_H
+#define EWALDWOLF_H
+
+#include "NoEwald.h"
+
+//
+//    Wolf summation (Wolf et al., J. Chem. Phys. 110, 8254) and its damped
+//    shifted force form DSF (Fennell and Gezelter, J. Chem. Phys. 124,
+//    234104). The pair term is the Ewald real space term shifted to zero at
+//    RcutCoulomb,
+//      Wolf: erfc(a r) / r - erfc(a Rc) / Rc
+//      DSF:  erfc(a r) / r - erfc(a Rc) / Rc + F(Rc) (r - Rc),
+//    which the pair kernels add on top of the real space term (see
+//    FFParticle::WolfEnergy). There is no reciprocal space: this class only
+//    keeps the self term
+//      -(erfc(a Rc) / (2 Rc) + a / sqrt(PI)) sum q^2
+//    and the intramolecular correction, where every pair of a molecule gets
+//    -erf(a r) / r as in Ewald plus the shift of the pair term.
+//
+
+class EwaldWolf : public NoEwald
+{
+public:
+
+  EwaldWolf(StaticVals & stat, System & sys);
+
+  virtual void Init();
+
+  //calculate self term for a box
+  virtual double BoxSelf(uint box) const;
+
+  //calculate intramolecular correction force term for a box with molCoords
+  virtual void BoxForceReciprocal(XYZArray const& molCoords,
+                                  XYZArray& atomForceRec, XYZArray& molForceRec,
+                                  uint box);
+
+  //calculate correction term for a molecule
+  virtual double MolCorrection(uint molIndex, uint box) const;
+
+  //calculate self term after swap move
+  virtual double SwapSelf(const cbmc::TrialMol& trialMol) const;
+
+  //calculate correction term after swap move with lambda = 1
+  virtual double SwapCorrection(const cbmc::TrialMol& trialMol) const;
+
+  //calculate correction term after swap move, with system lambda
+  virtual double SwapCorrection(const cbmc::TrialMol& trialMol,
+                                const uint molIndex) const;
+
+  //It's called in free energy calculation to calculate the change in
+  // self energy in all lambda states
+  virtual void ChangeSelf(Energy *energyDiff, Energy &dUdL_Coul,
+                          const std::vector<double> &lambda_Coul,
+                          const uint iState, const uint molIndex,
+                          const uint box) const;
+
+  //It's called in free energy calculation to calculate the change in
+  // correction energy in all lambda states
+  virtual void ChangeCorrection(Energy *energyDiff, Energy &dUdL_Coul,
+                                const std::vector<double> &lambda_Coul,
+                                const uint iState, const uint molIndex,
+                                const uint box) const;
+
+private:
+  //correction of a pair of the same molecule with unit charge product
+  double PairCorrection(const double distSq, const uint box) const;
+
+  //self energy of a unit charge
+  double SelfCoef(const uint box) const;
+};
+
+#endif /*EWALDWOLF_H*/
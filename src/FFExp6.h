@@ -90,6 +90,12 @@ public:
                                   const uint kind2, const double qi_qj_Fact,
                                   const double lambda, uint b) const;
 
+  //!Exp6 potential has no SIMD kernel, uses the scalar one
+  virtual bool GetSimdParams(simd::PairParams &par) const
+  {
+    return false;
+  }
+
   double *expConst, *expConst_1_4, *rMin, *rMin_1_4, *rMaxSq, *rMaxSq_1_4;
 
 protected:
@@ -201,16 +207,15 @@ inline double FF_EXP6::CalcEn(const double distSq, const uint kind1,
   }
   if(lambda >= 0.999999) {
     //save computation time
-    return CalcEn(distSq, index);
+    return FF_EXP6::CalcEn(distSq, index);
   }
-  double sigma6 = sigmaSq[index] * sigmaSq[index] * sigmaSq[index];
-  sigma6 = std::max(sigma6, forcefield.sc_sigma_6);
+  double sigma6 = pairs[index].sigma6;
   double dist6 = distSq * distSq * distSq;
   double lambdaCoef = forcefield.sc_alpha * pow((1.0 - lambda), forcefield.sc_power);
   double softDist6 = lambdaCoef * sigma6 + dist6;
   double softRsq = cbrt(softDist6);
 
-  double en = lambda * CalcEn(softRsq, index);
+  double en = lambda * FF_EXP6::CalcEn(softRsq, index);
   return en;
 }
 
@@ -239,17 +244,16 @@ inline double FF_EXP6::CalcVir(const double distSq, const uint kind1,
   }
   if(lambda >= 0.999999) {
     //save computation time
-    return CalcVir(distSq, index);
+    return FF_EXP6::CalcVir(distSq, index);
   }
-  double sigma6 = sigmaSq[index] * sigmaSq[index] * sigmaSq[index];
-  sigma6 = std::max(sigma6, forcefield.sc_sigma_6);
+  double sigma6 = pairs[index].sigma6;
   double dist6 = distSq * distSq * distSq;
   double lambdaCoef = forcefield.sc_alpha * pow((1.0 - lambda), forcefield.sc_power);
   double softDist6 = lambdaCoef * sigma6 + dist6;
   double softRsq = cbrt(softDist6);
   double correction = distSq / softRsq;
   //We need to fix the return value from calcVir
-  double vir = lambda * correction * correction * CalcVir(softRsq, index);
+  double vir = lambda * correction * correction * FF_EXP6::CalcVir(softRsq, index);
   return vir;
 }
 
@@ -280,20 +284,19 @@ inline double FF_EXP6::CalcCoulomb(const double distSq,
 
   if(lambda >= 0.999999) {
     //save computation time
-    return CalcCoulomb(distSq, qi_qj_Fact, b);
+    return FF_EXP6::CalcCoulomb(distSq, qi_qj_Fact, b);
   }
   double en = 0.0;
   if(forcefield.sc_coul) {
     uint index = FlatIndex(kind1, kind2);
-    double sigma6 = sigmaSq[index] * sigmaSq[index] * sigmaSq[index];
-    sigma6 = std::max(sigma6, forcefield.sc_sigma_6);
+    double sigma6 = pairs[index].sigma6;
     double dist6 = distSq * distSq * distSq;
     double lambdaCoef = forcefield.sc_alpha * pow((1.0 - lambda), forcefield.sc_power);
     double softDist6 = lambdaCoef * sigma6 + dist6;
     double softRsq = cbrt(softDist6);
-    en = lambda * CalcCoulomb(softRsq, qi_qj_Fact, b);
+    en = lambda * FF_EXP6::CalcCoulomb(softRsq, qi_qj_Fact, b);
   } else {
-    en = lambda * CalcCoulomb(distSq, qi_qj_Fact, b);
+    en = lambda * FF_EXP6::CalcCoulomb(distSq, qi_qj_Fact, b);
   }
   return en;
 }
@@ -303,9 +306,13 @@ inline double FF_EXP6::CalcCoulomb(const double distSq,
                                    const uint b) const
 {
   if(forcefield.ewald) {
+    double table;
+    if(forcefield.ewaldTable.Energy(table, distSq, b))
+      return qi_qj_Fact * table + qi_qj_Fact * WolfEnergy(distSq, b);
     double dist = sqrt(distSq);
     double val = forcefield.alpha[b] * dist;
-    return qi_qj_Fact * erfc(val) / dist;
+    return qi_qj_Fact * erfc(val) / dist +
+           qi_qj_Fact * WolfEnergy(distSq, b);
   } else {
     double dist = sqrt(distSq);
     return qi_qj_Fact / dist;
@@ -324,22 +331,21 @@ inline double FF_EXP6::CalcCoulombVir(const double distSq,
 
   if(lambda >= 0.999999) {
     //save computation time
-    return CalcCoulombVir(distSq, qi_qj, b);
+    return FF_EXP6::CalcCoulombVir(distSq, qi_qj, b);
   }
   double vir = 0.0;
   if(forcefield.sc_coul) {
     uint index = FlatIndex(kind1, kind2);
-    double sigma6 = sigmaSq[index] * sigmaSq[index] * sigmaSq[index];
-    sigma6 = std::max(sigma6, forcefield.sc_sigma_6);
+    double sigma6 = pairs[index].sigma6;
     double dist6 = distSq * distSq * distSq;
     double lambdaCoef = forcefield.sc_alpha * pow((1.0 - lambda), forcefield.sc_power);
     double softDist6 = lambdaCoef * sigma6 + dist6;
     double softRsq = cbrt(softDist6);
     double correction = distSq / softRsq;
     //We need to fix the return value from calcVir
-    vir = lambda * correction * correction * CalcCoulombVir(softRsq, qi_qj, b);
+    vir = lambda * correction * correction * FF_EXP6::CalcCoulombVir(softRsq, qi_qj, b);
   } else {
-    vir = lambda * CalcCoulombVir(distSq, qi_qj, b);
+    vir = lambda * FF_EXP6::CalcCoulombVir(distSq, qi_qj, b);
   }
   return vir;
 }
@@ -348,12 +354,16 @@ inline double FF_EXP6::CalcCoulombVir(const double distSq, const double qi_qj,
                                       const uint b) const
 {
   if(forcefield.ewald) {
+    double table;
+    if(forcefield.ewaldTable.Virial(table, distSq, b))
+      return qi_qj * table + qi_qj * WolfVirial(distSq, b);
     double dist = sqrt(distSq);
     // M_2_SQRTPI is 2/sqrt(PI)
     double constValue = forcefield.alpha[b] * M_2_SQRTPI;
     double expConstValue = exp(-1.0 * forcefield.alphaSq[b] * distSq);
     double temp = erfc(forcefield.alpha[b] * dist);
-    return qi_qj * (temp / dist + constValue * expConstValue) / distSq;
+    return qi_qj * (temp / dist + constValue * expConstValue) / distSq +
+           qi_qj * WolfVirial(distSq, b);
   } else {
     double dist = sqrt(distSq);
     return qi_qj / (distSq * dist);
@@ -437,15 +447,14 @@ inline double FF_EXP6::CalcdEndL(const double distSq, const uint kind1,
     return 0.0;
 
   uint index = FlatIndex(kind1, kind2);
-  double sigma6 = sigmaSq[index] * sigmaSq[index] * sigmaSq[index];
-  sigma6 = std::max(sigma6, forcefield.sc_sigma_6);
+  double sigma6 = pairs[index].sigma6;
   double dist6 = distSq * distSq * distSq;
   double lambdaCoef = forcefield.sc_alpha * pow((1.0 - lambda), forcefield.sc_power);
   double softDist6 = lambdaCoef * sigma6 + dist6;
   double softRsq = cbrt(softDist6);
   double fCoef = lambda * forcefield.sc_alpha * forcefield.sc_power / 6.0;
   fCoef *= pow(1.0 - lambda, forcefield.sc_power - 1.0) * sigma6 / (softRsq * softRsq);
-  double dhdl = CalcEn(softRsq, index) + fCoef * CalcVir(softRsq, index);
+  double dhdl = FF_EXP6::CalcEn(softRsq, index) + fCoef * FF_EXP6::CalcVir(softRsq, index);
   return dhdl;
 }
 
@@ -462,18 +471,17 @@ inline double FF_EXP6::CalcCoulombdEndL(const double distSq,
   double dhdl = 0.0;
   if(forcefield.sc_coul) {
     uint index = FlatIndex(kind1, kind2);
-    double sigma6 = sigmaSq[index] * sigmaSq[index] * sigmaSq[index];
-    sigma6 = std::max(sigma6, forcefield.sc_sigma_6);
+    double sigma6 = pairs[index].sigma6;
     double dist6 = distSq * distSq * distSq;
     double lambdaCoef = forcefield.sc_alpha * pow((1.0 - lambda), forcefield.sc_power);
     double softDist6 = lambdaCoef * sigma6 + dist6;
     double softRsq = cbrt(softDist6);
     double fCoef = lambda * forcefield.sc_alpha * forcefield.sc_power / 6.0;
     fCoef *= pow(1.0 - lambda, forcefield.sc_power - 1) * sigma6 / (softRsq * softRsq);
-    dhdl = CalcCoulomb(softRsq, qi_qj_Fact, b) +
-           fCoef * CalcCoulombVir(softRsq, qi_qj_Fact, b);
+    dhdl = FF_EXP6::CalcCoulomb(softRsq, qi_qj_Fact, b) +
+           fCoef * FF_EXP6::CalcCoulombVir(softRsq, qi_qj_Fact, b);
   } else {
-    dhdl = CalcCoulomb(distSq, qi_qj_Fact, b);
+    dhdl = FF_EXP6::CalcCoulomb(distSq, qi_qj_Fact, b);
   }
   return dhdl;
 }
@@ -6,6 +6,9 @@ along with this program, also can be found at <https://opensource.org/licenses/M
 ********************************************************************************/
 #include "FFParticle.h"
 #include "NumLib.h" //For Sq, Cb, and MeanA/G functions.
+#include "SimdPairKernel.h" //For simd::PairParams
+#include <algorithm> //For max
+#include <memory> //For align
 #ifdef GOMC_CUDA
 #include "ConstantDefinitionsCUDAKernel.cuh"
 #endif
@@ -13,7 +16,8 @@ along with this program, also can be found at <https://opensource.org/licenses/M
 FFParticle::FFParticle(Forcefield &ff) : forcefield(ff), mass(NULL), nameFirst(NULL), nameSec(NULL),
   n(NULL), n_1_4(NULL), sigmaSq(NULL), sigmaSq_1_4(NULL), epsilon(NULL),
   epsilon_1_4(NULL), epsilon_cn(NULL), epsilon_cn_1_4(NULL), epsilon_cn_6(NULL),
-  epsilon_cn_6_1_4(NULL), nOver6(NULL), nOver6_1_4(NULL)
+  epsilon_cn_6_1_4(NULL), nOver6(NULL), nOver6_1_4(NULL), pairs(NULL),
+  pairs_1_4(NULL), pairStorage(NULL)
 #ifdef GOMC_CUDA
   , varCUDA(NULL)
 #endif
@@ -41,6 +45,7 @@ FFParticle::~FFParticle(void)
   delete[] epsilon_cn_1_4;
   delete[] epsilon_cn_6_1_4;
   delete[] nOver6_1_4;
+  delete[] pairStorage;
 
 #ifdef GOMC_CUDA
   DestroyCUDAVars(varCUDA);
@@ -81,6 +86,7 @@ void FFParticle::Init(ff_setup::Particle const& mie,
   Blend(mie);
   //Adjusting VDW parameter using NBFIX
   AdjNBfix(nbfix);
+  InitPairParams();
 
 #ifdef GOMC_CUDA
   double diElectric_1 = 1.0 / forcefield.dielectric;
@@ -146,6 +152,26 @@ double FFParticle::ImpulsePressureCorrection(const uint kind1, const uint kind2)
   return tc;
 }
 
+bool FFParticle::GetSimdParams(simd::PairParams &par) const
+{
+  uint size = count * count;
+  for(uint i = 0; i < size; ++i) {
+    if(n[i] != 12.0)
+      return false;
+  }
+  par.count = count;
+  par.sigmaSq.assign(sigmaSq, sigmaSq + size);
+  par.epsilon_cn.assign(epsilon_cn, epsilon_cn + size);
+  par.epsilon_cn_6.assign(epsilon_cn_6, epsilon_cn_6 + size);
+  par.shiftConst.assign(size, 0.0);
+  par.electrostatic = forcefield.electrostatic;
+  par.ewald = forcefield.ewald;
+  par.wolf = forcefield.wolf;
+  par.coulombShift = 0.0;
+  par.qqFact = num::qqFact;
+  return true;
+}
+
 void FFParticle::Blend(ff_setup::Particle const& mie)
 {
   for(uint i = 0; i < count; ++i) {
@@ -220,6 +246,54 @@ void FFParticle::AdjNBfix(ff_setup::NBfix const& nbfix)
   }
 }
 
+namespace
+{
+//Exponent n if FFParticle::Repulse has a multiplied out form for it
+int IntegerExponent(const double n)
+{
+  if(n == 12.0 || n == 14.0 || n == 16.0)
+    return (int)n;
+  return 0;
+}
+}
+
+void FFParticle::InitPairParams()
+{
+  uint size = num::Sq(count);
+  //new does not align to the cache line before C++17, so align by hand
+  std::size_t bytes = 2 * size * sizeof(FFPairParam);
+  std::size_t space = bytes + alignof(FFPairParam);
+  pairStorage = new char[space];
+  void *start = pairStorage;
+  std::align(alignof(FFPairParam), bytes, start, space);
+  pairs = static_cast<FFPairParam *>(start);
+  pairs_1_4 = pairs + size;
+
+  for(uint idx = 0; idx < size; ++idx) {
+    FFPairParam &p = pairs[idx];
+    p.sigmaSq = sigmaSq[idx];
+    p.epsilon_cn = epsilon_cn[idx];
+    p.epsilon_cn_6 = epsilon_cn_6[idx];
+    p.n = n[idx];
+    p.nOver6 = nOver6[idx];
+    p.sigma6 = std::max(sigmaSq[idx] * sigmaSq[idx] * sigmaSq[idx],
+                        forcefield.sc_sigma_6);
+    p.shiftConst = 0.0;
+    p.nInt = IntegerExponent(n[idx]);
+
+    FFPairParam &p_1_4 = pairs_1_4[idx];
+    p_1_4.sigmaSq = sigmaSq_1_4[idx];
+    p_1_4.epsilon_cn = epsilon_cn_1_4[idx];
+    p_1_4.epsilon_cn_6 = epsilon_cn_6_1_4[idx];
+    p_1_4.n = n_1_4[idx];
+    p_1_4.nOver6 = nOver6_1_4[idx];
+    p_1_4.sigma6 = std::max(sigmaSq_1_4[idx] * sigmaSq_1_4[idx] *
+                            sigmaSq_1_4[idx], forcefield.sc_sigma_6);
+    p_1_4.shiftConst = 0.0;
+    p_1_4.nInt = IntegerExponent(n_1_4[idx]);
+  }
+}
+
 double FFParticle::GetEpsilon(const uint i, const uint j) const
 {
   uint idx = FlatIndex(i, j);
@@ -266,245 +340,3 @@ inline double FFParticle::GetRmax_1_4(const uint i, const uint j) const
 {
   return 0.0;
 }
-
-// Defining the functions
-
-inline void FFParticle::CalcAdd_1_4(double& en, const double distSq,
-                                    const uint kind1, const uint kind2) const
-{
-  if(forcefield.rCutSq < distSq)
-    return;
-
-  uint index = FlatIndex(kind1, kind2);
-  double rRat2 = sigmaSq_1_4[index] / distSq;
-  double attract = rRat2 * rRat2 * rRat2;
-  double repulse = pow(sqrt(rRat2), n_1_4[index]);
-
-  en += epsilon_cn_1_4[index] * (repulse - attract);
-}
-
-inline void FFParticle::CalcCoulombAdd_1_4(double& en, const double distSq,
-    const double qi_qj_Fact,
-    const bool NB) const
-{
-  if(forcefield.rCutSq < distSq)
-    return;
-
-  double dist = sqrt(distSq);
-  if(NB)
-    en += qi_qj_Fact / dist;
-  else
-    en += qi_qj_Fact * forcefield.scaling_14 / dist;
-}
-
-//mie potential
-inline double FFParticle::CalcEn(const double distSq, const uint kind1,
-                                 const uint kind2, const double lambda) const
-{
-  if(forcefield.rCutSq < distSq)
-    return 0.0;
-
-  uint index = FlatIndex(kind1, kind2);
-  if(lambda >= 0.999999) {
-    //save computation time
-    return CalcEn(distSq, index);
-  }
-  double sigma6 = sigmaSq[index] * sigmaSq[index] * sigmaSq[index];
-  sigma6 = std::max(sigma6, forcefield.sc_sigma_6);
-  double dist6 = distSq * distSq * distSq;
-  double lambdaCoef = forcefield.sc_alpha * pow((1.0 - lambda), forcefield.sc_power);
-  double softDist6 = lambdaCoef * sigma6 + dist6;
-  double softRsq = cbrt(softDist6);
-
-  double en = lambda * CalcEn(softRsq, index);
-  return en;
-}
-
-inline double FFParticle::CalcEn(const double distSq, const uint index) const
-{
-  double rRat2 = sigmaSq[index] / distSq;
-  double rRat4 = rRat2 * rRat2;
-  double attract = rRat4 * rRat2;
-  double n_ij = n[index];
-  double repulse = pow(rRat2, (n_ij * 0.5));
-
-  return (epsilon_cn[index] * (repulse - attract));
-}
-
-inline double FFParticle::CalcVir(const double distSq, const uint kind1,
-                                  const uint kind2, const double lambda) const
-{
-  if(forcefield.rCutSq < distSq)
-    return 0.0;
-
-  uint index = FlatIndex(kind1, kind2);
-  if(lambda >= 0.999999) {
-    //save computation time
-    return CalcVir(distSq, index);
-  }
-  double sigma6 = sigmaSq[index] * sigmaSq[index] * sigmaSq[index];
-  sigma6 = std::max(sigma6, forcefield.sc_sigma_6);
-  double dist6 = distSq * distSq * distSq;
-  double lambdaCoef = forcefield.sc_alpha * pow((1.0 - lambda), forcefield.sc_power);
-  double softDist6 = lambdaCoef * sigma6 + dist6;
-  double softRsq = cbrt(softDist6);
-  double correction = distSq / softRsq;
-  //We need to fix the return value from calcVir
-  double vir = lambda * correction * correction * CalcVir(softRsq, index);
-  return vir;
-}
-
-inline double FFParticle::CalcVir(const double distSq, const uint index) const
-{
-  double rNeg2 = 1.0 / distSq;
-  double rRat2 = rNeg2 * sigmaSq[index];
-  double rRat4 = rRat2 * rRat2;
-  double attract = rRat4 * rRat2;
-  double n_ij = n[index];
-  double repulse = pow(rRat2, (n_ij * 0.5));
-  //Virial is F.r = -dE/dr * 1/r
-  return epsilon_cn_6[index] * (nOver6[index] * repulse - attract) * rNeg2;
-}
-
-inline double FFParticle::CalcCoulomb(const double distSq,
-                                      const uint kind1,
-                                      const uint kind2,
-                                      const double qi_qj_Fact,
-                                      const double lambda,
-                                      const uint b) const
-{
-  if(forcefield.rCutCoulombSq[b] < distSq)
-    return 0.0;
-
-  if(lambda >= 0.999999) {
-    //save computation time
-    return CalcCoulomb(distSq, qi_qj_Fact, b);
-  }
-  double en = 0.0;
-  if(forcefield.sc_coul) {
-    uint index = FlatIndex(kind1, kind2);
-    double sigma6 = sigmaSq[index] * sigmaSq[index] * sigmaSq[index];
-    sigma6 = std::max(sigma6, forcefield.sc_sigma_6);
-    double dist6 = distSq * distSq * distSq;
-    double lambdaCoef = forcefield.sc_alpha * pow((1.0 - lambda), forcefield.sc_power);
-    double softDist6 = lambdaCoef * sigma6 + dist6;
-    double softRsq = cbrt(softDist6);
-    en = lambda * CalcCoulomb(softRsq, qi_qj_Fact, b);
-  } else {
-    en = lambda * CalcCoulomb(distSq, qi_qj_Fact, b);
-  }
-  return en;
-}
-
-inline double FFParticle::CalcCoulomb(const double distSq,
-                                      const double qi_qj_Fact,
-                                      const uint b) const
-{
-  if(forcefield.ewald) {
-    double dist = sqrt(distSq);
-    double val = forcefield.alpha[b] * dist;
-    return qi_qj_Fact * erfc(val) / dist;
-  } else {
-    double dist = sqrt(distSq);
-    return qi_qj_Fact / dist;
-  }
-}
-
-inline double FFParticle::CalcCoulombVir(const double distSq,
-    const uint kind1,
-    const uint kind2,
-    const double qi_qj,
-    const double lambda,
-    const uint b) const
-{
-  if(forcefield.rCutCoulombSq[b] < distSq)
-    return 0.0;
-
-  if(lambda >= 0.999999) {
-    //save computation time
-    return CalcCoulombVir(distSq, qi_qj, b);
-  }
-  double vir = 0.0;
-  if(forcefield.sc_coul) {
-    uint index = FlatIndex(kind1, kind2);
-    double sigma6 = sigmaSq[index] * sigmaSq[index] * sigmaSq[index];
-    sigma6 = std::max(sigma6, forcefield.sc_sigma_6);
-    double dist6 = distSq * distSq * distSq;
-    double lambdaCoef = forcefield.sc_alpha * pow((1.0 - lambda), forcefield.sc_power);
-    double softDist6 = lambdaCoef * sigma6 + dist6;
-    double softRsq = cbrt(softDist6);
-    double correction = distSq / softRsq;
-    //We need to fix the return value from calcVir
-    vir = lambda * correction * correction * CalcCoulombVir(softRsq, qi_qj, b);
-  } else {
-    vir = lambda * CalcCoulombVir(distSq, qi_qj, b);
-  }
-  return vir;
-}
-
-inline double FFParticle::CalcCoulombVir(const double distSq,
-    const double qi_qj, const uint b) const
-{
-  if(forcefield.ewald) {
-    double dist = sqrt(distSq);
-    // M_2_SQRTPI is 2/sqrt(PI)
-    double constValue = forcefield.alpha[b] *  M_2_SQRTPI;
-    double expConstValue = exp(-1.0 * forcefield.alphaSq[b] * distSq);
-    double temp = 1.0 - erf(forcefield.alpha[b] * dist);
-    return qi_qj * (temp / dist + constValue * expConstValue) / distSq;
-  } else {
-    double dist = sqrt(distSq);
-    double result = qi_qj / (distSq * dist);
-    return result;
-  }
-}
-
-//Calculate the dE/dlambda for vdw energy
-inline double FFParticle::CalcdEndL(const double distSq, const uint kind1,
-                                    const uint kind2,
-                                    const double lambda) const
-{
-  if(forcefield.rCutSq < distSq)
-    return 0.0;
-
-  uint index = FlatIndex(kind1, kind2);
-  double sigma6 = sigmaSq[index] * sigmaSq[index] * sigmaSq[index];
-  sigma6 = std::max(sigma6, forcefield.sc_sigma_6);
-  double dist6 = distSq * distSq * distSq;
-  double lambdaCoef = forcefield.sc_alpha * pow((1.0 - lambda), forcefield.sc_power);
-  double softDist6 = lambdaCoef * sigma6 + dist6;
-  double softRsq = cbrt(softDist6);
-  double fCoef = lambda * forcefield.sc_alpha * forcefield.sc_power / 6.0;
-  fCoef *= pow(1.0 - lambda, forcefield.sc_power - 1.0) * sigma6 / (softRsq * softRsq);
-  double dhdl = CalcEn(softRsq, index) + fCoef * CalcVir(softRsq, index);
-  return dhdl;
-}
-
-//Calculate the dE/dlambda for Coulomb energy
-inline double FFParticle::CalcCoulombdEndL(const double distSq,
-    const uint kind1,
-    const uint kind2,
-    const double qi_qj_Fact,
-    const double lambda, uint b) const
-{
-  if(forcefield.rCutCoulombSq[b] < distSq)
-    return 0.0;
-
-  double dhdl = 0.0;
-  if(forcefield.sc_coul) {
-    uint index = FlatIndex(kind1, kind2);
-    double sigma6 = sigmaSq[index] * sigmaSq[index] * sigmaSq[index];
-    sigma6 = std::max(sigma6, forcefield.sc_sigma_6);
-    double dist6 = distSq * distSq * distSq;
-    double lambdaCoef = forcefield.sc_alpha * pow((1.0 - lambda), forcefield.sc_power);
-    double softDist6 = lambdaCoef * sigma6 + dist6;
-    double softRsq = cbrt(softDist6);
-    double fCoef = lambda * forcefield.sc_alpha * forcefield.sc_power / 6.0;
-    fCoef *= pow(1.0 - lambda, forcefield.sc_power - 1.0) * sigma6 / (softRsq * softRsq);
-    dhdl = CalcCoulomb(softRsq, qi_qj_Fact, b) +
-           fCoef * CalcCoulombVir(softRsq, qi_qj_Fact, b);
-  } else {
-    dhdl = CalcCoulomb(distSq, qi_qj_Fact, b);
-  }
-  return dhdl;
-}
\ No newline at end of file
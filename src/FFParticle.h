@@ -40,8 +40,29 @@ class Particle;
 class NBfix;
 }
 
+namespace simd
+{
+struct PairParams;
+}
+
 class Forcefield;
 
+// Parameters of one kind pair, in the layout used by the pair potentials.
+// A record fills one 64 byte cache line, so evaluating a pair loads one line
+// instead of one line from each of the parameter arrays.
+struct alignas(64) FFPairParam {
+  double sigmaSq;
+  double epsilon_cn;
+  double epsilon_cn_6;
+  double n;
+  double nOver6;
+  double sigma6;     // max(sigma^6, sc_sigma_6), for the soft core
+  double shiftConst; // energy at rCut for FF_SHIFT, 0 otherwise
+  int nInt;          // n if Repulse has a multiplied out form for it, else 0
+};
+static_assert(sizeof(FFPairParam) == 64,
+              "FFPairParam should fill exactly one cache line");
+
 struct FFParticle {
 public:
 
@@ -96,6 +117,10 @@ public:
                                   const uint kind2, const double qi_qj_Fact,
                                   const double lambda, uint b) const;
 
+  //!Fills the parameters of the SIMD pair kernel, returns false if this
+  //!potential has no vector form (only 12-6 LJ has one)
+  virtual bool GetSimdParams(simd::PairParams &par) const;
+
   uint NumKinds() const
   {
     return count;
@@ -119,6 +144,10 @@ protected:
                              const uint b) const;
   virtual double CalcCoulombVir(const double distSq, const double qi_qj,
                                 uint b) const;
+  //Wolf / DSF terms added to the damped real space energy and virial of a
+  //pair with unit charge product, zero without Wolf summation
+  double WolfEnergy(const double distSq, const uint b) const;
+  double WolfVirial(const double distSq, const uint b) const;
   //Find the index of the pair kind
   uint FlatIndex(const uint i, const uint j) const
   {
@@ -128,6 +157,13 @@ protected:
   void Blend(ff_setup::Particle const& mie);
   //Use NBFIX to adjust sigma, epsilon, and n value for different kind
   void AdjNBfix(ff_setup::NBfix const& nbfix);
+  //Pack the blended parameters into pairs and pairs_1_4
+  void InitPairParams();
+  //Repulsive term (sigma/r)^n of pair p from rRat2 = (sigma/r)^2 and
+  //attract = (sigma/r)^6. The usual Mie exponents are multiplied out,
+  //other ones use pow.
+  static double Repulse(FFPairParam const& p, const double rRat2,
+                        const double attract);
   //To access rcut and other forcefield data
   const Forcefield& forcefield;
 
@@ -141,6 +177,10 @@ protected:
   double *sigmaSq, *sigmaSq_1_4, *epsilon, *epsilon_1_4, *epsilon_cn,
          *epsilon_cn_1_4, *epsilon_cn_6, *epsilon_cn_6_1_4, *nOver6,
          *nOver6_1_4;
+  //Packed copies of the parameters above, indexed by FlatIndex. The arrays
+  //are still used for setup, tail corrections and the GPU.
+  FFPairParam *pairs, *pairs_1_4;
+  char *pairStorage;
 #ifdef GOMC_CUDA
   VariablesCUDA *varCUDA;
 #endif
@@ -149,4 +189,280 @@ protected:
 };
 
 
+// Defining the functions
+
+inline double FFParticle::Repulse(FFPairParam const& p, const double rRat2,
+                                  const double attract)
+{
+  switch(p.nInt) {
+  case 12:
+    return attract * attract;
+  case 14:
+    return attract * attract * rRat2;
+  case 16: {
+    double rRat8 = num::Sq(num::Sq(rRat2));
+    return rRat8 * rRat8;
+  }
+  default:
+    return pow(rRat2, p.n * 0.5);
+  }
+}
+
+inline void FFParticle::CalcAdd_1_4(double& en, const double distSq,
+                                    const uint kind1, const uint kind2) const
+{
+  if(forcefield.rCutSq < distSq)
+    return;
+
+  const FFPairParam &p = pairs_1_4[FlatIndex(kind1, kind2)];
+  double rRat2 = p.sigmaSq / distSq;
+  double attract = rRat2 * rRat2 * rRat2;
+  double repulse = Repulse(p, rRat2, attract);
+
+  en += p.epsilon_cn * (repulse - attract);
+}
+
+inline void FFParticle::CalcCoulombAdd_1_4(double& en, const double distSq,
+    const double qi_qj_Fact,
+    const bool NB) const
+{
+  if(forcefield.rCutSq < distSq)
+    return;
+
+  double dist = sqrt(distSq);
+  if(NB)
+    en += qi_qj_Fact / dist;
+  else
+    en += qi_qj_Fact * forcefield.scaling_14 / dist;
+}
+
+//mie potential
+inline double FFParticle::WolfEnergy(const double distSq, const uint b) const
+{
+  if(!forcefield.wolf)
+    return 0.0;
+  return forcefield.wolfForceShift[b] *
+         (sqrt(distSq) - forcefield.rCutCoulomb[b]) - forcefield.wolfShift[b];
+}
+
+inline double FFParticle::WolfVirial(const double distSq, const uint b) const
+{
+  if(!forcefield.wolf)
+    return 0.0;
+  return -forcefield.wolfForceShift[b] / sqrt(distSq);
+}
+
+inline double FFParticle::CalcEn(const double distSq, const uint kind1,
+                                 const uint kind2, const double lambda) const
+{
+  if(forcefield.rCutSq < distSq)
+    return 0.0;
+
+  uint index = FlatIndex(kind1, kind2);
+  if(lambda >= 0.999999) {
+    //save computation time
+    return FFParticle::CalcEn(distSq, index);
+  }
+  double sigma6 = pairs[index].sigma6;
+  double dist6 = distSq * distSq * distSq;
+  double lambdaCoef = forcefield.sc_alpha * pow((1.0 - lambda), forcefield.sc_power);
+  double softDist6 = lambdaCoef * sigma6 + dist6;
+  double softRsq = cbrt(softDist6);
+
+  double en = lambda * FFParticle::CalcEn(softRsq, index);
+  return en;
+}
+
+inline double FFParticle::CalcEn(const double distSq, const uint index) const
+{
+  const FFPairParam &p = pairs[index];
+  double rRat2 = p.sigmaSq / distSq;
+  double rRat4 = rRat2 * rRat2;
+  double attract = rRat4 * rRat2;
+  double repulse = Repulse(p, rRat2, attract);
+
+  return (p.epsilon_cn * (repulse - attract));
+}
+
+inline double FFParticle::CalcVir(const double distSq, const uint kind1,
+                                  const uint kind2, const double lambda) const
+{
+  if(forcefield.rCutSq < distSq)
+    return 0.0;
+
+  uint index = FlatIndex(kind1, kind2);
+  if(lambda >= 0.999999) {
+    //save computation time
+    return FFParticle::CalcVir(distSq, index);
+  }
+  double sigma6 = pairs[index].sigma6;
+  double dist6 = distSq * distSq * distSq;
+  double lambdaCoef = forcefield.sc_alpha * pow((1.0 - lambda), forcefield.sc_power);
+  double softDist6 = lambdaCoef * sigma6 + dist6;
+  double softRsq = cbrt(softDist6);
+  double correction = distSq / softRsq;
+  //We need to fix the return value from calcVir
+  double vir = lambda * correction * correction * FFParticle::CalcVir(softRsq, index);
+  return vir;
+}
+
+inline double FFParticle::CalcVir(const double distSq, const uint index) const
+{
+  const FFPairParam &p = pairs[index];
+  double rNeg2 = 1.0 / distSq;
+  double rRat2 = rNeg2 * p.sigmaSq;
+  double rRat4 = rRat2 * rRat2;
+  double attract = rRat4 * rRat2;
+  double repulse = Repulse(p, rRat2, attract);
+  //Virial is F.r = -dE/dr * 1/r
+  return p.epsilon_cn_6 * (p.nOver6 * repulse - attract) * rNeg2;
+}
+
+inline double FFParticle::CalcCoulomb(const double distSq,
+                                      const uint kind1,
+                                      const uint kind2,
+                                      const double qi_qj_Fact,
+                                      const double lambda,
+                                      const uint b) const
+{
+  if(forcefield.rCutCoulombSq[b] < distSq)
+    return 0.0;
+
+  if(lambda >= 0.999999) {
+    //save computation time
+    return FFParticle::CalcCoulomb(distSq, qi_qj_Fact, b);
+  }
+  double en = 0.0;
+  if(forcefield.sc_coul) {
+    uint index = FlatIndex(kind1, kind2);
+    double sigma6 = pairs[index].sigma6;
+    double dist6 = distSq * distSq * distSq;
+    double lambdaCoef = forcefield.sc_alpha * pow((1.0 - lambda), forcefield.sc_power);
+    double softDist6 = lambdaCoef * sigma6 + dist6;
+    double softRsq = cbrt(softDist6);
+    en = lambda * FFParticle::CalcCoulomb(softRsq, qi_qj_Fact, b);
+  } else {
+    en = lambda * FFParticle::CalcCoulomb(distSq, qi_qj_Fact, b);
+  }
+  return en;
+}
+
+inline double FFParticle::CalcCoulomb(const double distSq,
+                                      const double qi_qj_Fact,
+                                      const uint b) const
+{
+  if(forcefield.ewald) {
+    double table;
+    if(forcefield.ewaldTable.Energy(table, distSq, b))
+      return qi_qj_Fact * table + qi_qj_Fact * WolfEnergy(distSq, b);
+    double dist = sqrt(distSq);
+    double val = forcefield.alpha[b] * dist;
+    return qi_qj_Fact * erfc(val) / dist +
+           qi_qj_Fact * WolfEnergy(distSq, b);
+  } else {
+    double dist = sqrt(distSq);
+    return qi_qj_Fact / dist;
+  }
+}
+
+inline double FFParticle::CalcCoulombVir(const double distSq,
+    const uint kind1,
+    const uint kind2,
+    const double qi_qj,
+    const double lambda,
+    const uint b) const
+{
+  if(forcefield.rCutCoulombSq[b] < distSq)
+    return 0.0;
+
+  if(lambda >= 0.999999) {
+    //save computation time
+    return FFParticle::CalcCoulombVir(distSq, qi_qj, b);
+  }
+  double vir = 0.0;
+  if(forcefield.sc_coul) {
+    uint index = FlatIndex(kind1, kind2);
+    double sigma6 = pairs[index].sigma6;
+    double dist6 = distSq * distSq * distSq;
+    double lambdaCoef = forcefield.sc_alpha * pow((1.0 - lambda), forcefield.sc_power);
+    double softDist6 = lambdaCoef * sigma6 + dist6;
+    double softRsq = cbrt(softDist6);
+    double correction = distSq / softRsq;
+    //We need to fix the return value from calcVir
+    vir = lambda * correction * correction * FFParticle::CalcCoulombVir(softRsq, qi_qj, b);
+  } else {
+    vir = lambda * FFParticle::CalcCoulombVir(distSq, qi_qj, b);
+  }
+  return vir;
+}
+
+inline double FFParticle::CalcCoulombVir(const double distSq,
+    const double qi_qj, const uint b) const
+{
+  if(forcefield.ewald) {
+    double table;
+    if(forcefield.ewaldTable.Virial(table, distSq, b))
+      return qi_qj * table + qi_qj * WolfVirial(distSq, b);
+    double dist = sqrt(distSq);
+    // M_2_SQRTPI is 2/sqrt(PI)
+    double constValue = forcefield.alpha[b] *  M_2_SQRTPI;
+    double expConstValue = exp(-1.0 * forcefield.alphaSq[b] * distSq);
+    double temp = 1.0 - erf(forcefield.alpha[b] * dist);
+    return qi_qj * (temp / dist + constValue * expConstValue) / distSq +
+           qi_qj * WolfVirial(distSq, b);
+  } else {
+    double dist = sqrt(distSq);
+    double result = qi_qj / (distSq * dist);
+    return result;
+  }
+}
+
+//Calculate the dE/dlambda for vdw energy
+inline double FFParticle::CalcdEndL(const double distSq, const uint kind1,
+                                    const uint kind2,
+                                    const double lambda) const
+{
+  if(forcefield.rCutSq < distSq)
+    return 0.0;
+
+  uint index = FlatIndex(kind1, kind2);
+  double sigma6 = pairs[index].sigma6;
+  double dist6 = distSq * distSq * distSq;
+  double lambdaCoef = forcefield.sc_alpha * pow((1.0 - lambda), forcefield.sc_power);
+  double softDist6 = lambdaCoef * sigma6 + dist6;
+  double softRsq = cbrt(softDist6);
+  double fCoef = lambda * forcefield.sc_alpha * forcefield.sc_power / 6.0;
+  fCoef *= pow(1.0 - lambda, forcefield.sc_power - 1.0) * sigma6 / (softRsq * softRsq);
+  double dhdl = FFParticle::CalcEn(softRsq, index) + fCoef * FFParticle::CalcVir(softRsq, index);
+  return dhdl;
+}
+
+//Calculate the dE/dlambda for Coulomb energy
+inline double FFParticle::CalcCoulombdEndL(const double distSq,
+    const uint kind1,
+    const uint kind2,
+    const double qi_qj_Fact,
+    const double lambda, uint b) const
+{
+  if(forcefield.rCutCoulombSq[b] < distSq)
+    return 0.0;
+
+  double dhdl = 0.0;
+  if(forcefield.sc_coul) {
+    uint index = FlatIndex(kind1, kind2);
+    double sigma6 = pairs[index].sigma6;
+    double dist6 = distSq * distSq * distSq;
+    double lambdaCoef = forcefield.sc_alpha * pow((1.0 - lambda), forcefield.sc_power);
+    double softDist6 = lambdaCoef * sigma6 + dist6;
+    double softRsq = cbrt(softDist6);
+    double fCoef = lambda * forcefield.sc_alpha * forcefield.sc_power / 6.0;
+    fCoef *= pow(1.0 - lambda, forcefield.sc_power - 1.0) * sigma6 / (softRsq * softRsq);
+    dhdl = FFParticle::CalcCoulomb(softRsq, qi_qj_Fact, b) +
+           fCoef * FFParticle::CalcCoulombVir(softRsq, qi_qj_Fact, b);
+  } else {
+    dhdl = FFParticle::CalcCoulomb(distSq, qi_qj_Fact, b);
+  }
+  return dhdl;
+}
+
 #endif /*FF_PARTICLE_H*/
@@ -11,6 +11,7 @@ along with this program, also can be found at <https://opensource.org/licenses/M
 #include "BasicTypes.h" //for uint
 #include "NumLib.h" //For Cb, Sq
 #include "FFParticle.h"
+#include "SimdPairKernel.h" //For simd::PairParams
 
 //////////////////////////////////////////////////////////////////////
 ////////////////////////// LJ Shift Style ////////////////////////////
@@ -84,6 +85,9 @@ public:
                                   const uint kind2, const double qi_qj_Fact,
                                   const double lambda, uint b) const;
 
+  //!Same 12-6 parameters as FFParticle plus the energy shift
+  virtual bool GetSimdParams(simd::PairParams &par) const;
+
 protected:
   virtual double CalcEn(const double distSq, const uint index) const;
   virtual double CalcVir(const double distSq, const uint index) const;
@@ -116,17 +120,29 @@ inline void FF_SHIFT::Init(ff_setup::Particle const& mie,
       double rRat2_1_4 = sigmaSq_1_4[idx] / forcefield.rCutSq;
       double rRat4_1_4 = rRat2_1_4 * rRat2_1_4;
       double attract_1_4 = rRat4_1_4 * rRat2_1_4;
-      double repulse = pow(sqrt(rRat2), n[idx]);
-      double repulse_1_4 = pow(sqrt(rRat2_1_4), n_1_4[idx]);
+      double repulse = Repulse(pairs[idx], rRat2, attract);
+      double repulse_1_4 = Repulse(pairs_1_4[idx], rRat2_1_4, attract_1_4);
 
       shiftConst[idx] =  epsilon_cn[idx] * (repulse - attract);
       shiftConst_1_4[idx] =  epsilon_cn_1_4[idx] *
                              (repulse_1_4 - attract_1_4);
+      pairs[idx].shiftConst = shiftConst[idx];
+      pairs_1_4[idx].shiftConst = shiftConst_1_4[idx];
 
     }
   }
 }
 
+inline bool FF_SHIFT::GetSimdParams(simd::PairParams &par) const
+{
+  if(!FFParticle::GetSimdParams(par))
+    return false;
+  par.shiftConst.assign(shiftConst, shiftConst + num::Sq(count));
+  if(!forcefield.ewald)
+    par.coulombShift = 1.0 / forcefield.rCut;
+  return true;
+}
+
 
 inline void FF_SHIFT::CalcAdd_1_4(double& en, const double distSq,
                                   const uint kind1, const uint kind2) const
@@ -134,12 +150,12 @@ inline void FF_SHIFT::CalcAdd_1_4(double& en, const double distSq,
   if(forcefield.rCutSq < distSq)
     return;
 
-  uint index = FlatIndex(kind1, kind2);
-  double rRat2 = sigmaSq_1_4[index] / distSq;
+  const FFPairParam &p = pairs_1_4[FlatIndex(kind1, kind2)];
+  double rRat2 = p.sigmaSq / distSq;
   double attract = rRat2 * rRat2 * rRat2;
-  double repulse = pow(sqrt(rRat2), n_1_4[index]);
+  double repulse = Repulse(p, rRat2, attract);
 
-  en += (epsilon_cn_1_4[index] * (repulse - attract) - shiftConst_1_4[index]);
+  en += (p.epsilon_cn * (repulse - attract) - p.shiftConst);
 }
 
 inline void FF_SHIFT::CalcCoulombAdd_1_4(double& en, const double distSq,
@@ -165,28 +181,27 @@ inline double FF_SHIFT::CalcEn(const double distSq, const uint kind1,
   uint index = FlatIndex(kind1, kind2);
   if(lambda >= 0.999999) {
     //save computation time
-    return CalcEn(distSq, index);
+    return FF_SHIFT::CalcEn(distSq, index);
   }
-  double sigma6 = sigmaSq[index] * sigmaSq[index] * sigmaSq[index];
-  sigma6 = std::max(sigma6, forcefield.sc_sigma_6);
+  double sigma6 = pairs[index].sigma6;
   double dist6 = distSq * distSq * distSq;
   double lambdaCoef = forcefield.sc_alpha * pow((1.0 - lambda), forcefield.sc_power);
   double softDist6 = lambdaCoef * sigma6 + dist6;
   double softRsq = cbrt(softDist6);
 
-  double en = lambda * CalcEn(softRsq, index);
+  double en = lambda * FF_SHIFT::CalcEn(softRsq, index);
   return en;
 }
 
 inline double FF_SHIFT::CalcEn(const double distSq, const uint index) const
 {
-  double rRat2 = sigmaSq[index] / distSq;
+  const FFPairParam &p = pairs[index];
+  double rRat2 = p.sigmaSq / distSq;
   double rRat4 = rRat2 * rRat2;
   double attract = rRat4 * rRat2;
-  double n_ij = n[index];
-  double repulse = pow(rRat2, (n_ij * 0.5));
+  double repulse = Repulse(p, rRat2, attract);
 
-  return (epsilon_cn[index] * (repulse - attract) - shiftConst[index]);
+  return (p.epsilon_cn * (repulse - attract) - p.shiftConst);
 }
 
 inline double FF_SHIFT::CalcVir(const double distSq, const uint kind1,
@@ -198,31 +213,30 @@ inline double FF_SHIFT::CalcVir(const double distSq, const uint kind1,
   uint index = FlatIndex(kind1, kind2);
   if(lambda >= 0.999999) {
     //save computation time
-    return CalcVir(distSq, index);
+    return FF_SHIFT::CalcVir(distSq, index);
   }
-  double sigma6 = sigmaSq[index] * sigmaSq[index] * sigmaSq[index];
-  sigma6 = std::max(sigma6, forcefield.sc_sigma_6);
+  double sigma6 = pairs[index].sigma6;
   double dist6 = distSq * distSq * distSq;
   double lambdaCoef = forcefield.sc_alpha * pow((1.0 - lambda), forcefield.sc_power);
   double softDist6 = lambdaCoef * sigma6 + dist6;
   double softRsq = cbrt(softDist6);
   double correction = distSq / softRsq;
   //We need to fix the return value from calcVir
-  double vir = lambda * correction * correction * CalcVir(softRsq, index);
+  double vir = lambda * correction * correction * FF_SHIFT::CalcVir(softRsq, index);
   return vir;
 }
 
 inline double FF_SHIFT::CalcVir(const double distSq, const uint index) const
 {
+  const FFPairParam &p = pairs[index];
   double rNeg2 = 1.0 / distSq;
-  double rRat2 = rNeg2 * sigmaSq[index];
+  double rRat2 = rNeg2 * p.sigmaSq;
   double rRat4 = rRat2 * rRat2;
   double attract = rRat4 * rRat2;
-  double n_ij = n[index];
-  double repulse = pow(rRat2, (n_ij * 0.5));
+  double repulse = Repulse(p, rRat2, attract);
 
   //Virial is the derivative of the pressure... mu
-  return epsilon_cn_6[index] * (nOver6[index] * repulse - attract) * rNeg2;
+  return p.epsilon_cn_6 * (p.nOver6 * repulse - attract) * rNeg2;
 }
 
 inline double FF_SHIFT::CalcCoulomb(const double distSq,
@@ -237,20 +251,19 @@ inline double FF_SHIFT::CalcCoulomb(const double distSq,
 
   if(lambda >= 0.999999) {
     //save computation time
-    return CalcCoulomb(distSq, qi_qj_Fact, b);
+    return FF_SHIFT::CalcCoulomb(distSq, qi_qj_Fact, b);
   }
   double en = 0.0;
   if(forcefield.sc_coul) {
     uint index = FlatIndex(kind1, kind2);
-    double sigma6 = sigmaSq[index] * sigmaSq[index] * sigmaSq[index];
-    sigma6 = std::max(sigma6, forcefield.sc_sigma_6);
+    double sigma6 = pairs[index].sigma6;
     double dist6 = distSq * distSq * distSq;
     double lambdaCoef = forcefield.sc_alpha * pow((1.0 - lambda), forcefield.sc_power);
     double softDist6 = lambdaCoef * sigma6 + dist6;
     double softRsq = cbrt(softDist6);
-    en = lambda * CalcCoulomb(softRsq, qi_qj_Fact, b);
+    en = lambda * FF_SHIFT::CalcCoulomb(softRsq, qi_qj_Fact, b);
   } else {
-    en = lambda * CalcCoulomb(distSq, qi_qj_Fact, b);
+    en = lambda * FF_SHIFT::CalcCoulomb(distSq, qi_qj_Fact, b);
   }
   return en;
 }
@@ -259,9 +272,13 @@ inline double FF_SHIFT::CalcCoulomb(const double distSq, const double qi_qj_Fact
                                     const uint b) const
 {
   if(forcefield.ewald) {
+    double table;
+    if(forcefield.ewaldTable.Energy(table, distSq, b))
+      return qi_qj_Fact * table + qi_qj_Fact * WolfEnergy(distSq, b);
     double dist = sqrt(distSq);
     double val = forcefield.alpha[b] * dist;
-    return qi_qj_Fact * erfc(val) / dist;
+    return qi_qj_Fact * erfc(val) / dist +
+           qi_qj_Fact * WolfEnergy(distSq, b);
   } else {
     double dist = sqrt(distSq);
     return qi_qj_Fact * (1.0 / dist - 1.0 / forcefield.rCut);
@@ -277,22 +294,21 @@ inline double FF_SHIFT::CalcCoulombVir(const double distSq, const uint kind1,
 
   if(lambda >= 0.999999) {
     //save computation time
-    return CalcCoulombVir(distSq, qi_qj, b);
+    return FF_SHIFT::CalcCoulombVir(distSq, qi_qj, b);
   }
   double vir = 0.0;
   if(forcefield.sc_coul) {
     uint index = FlatIndex(kind1, kind2);
-    double sigma6 = sigmaSq[index] * sigmaSq[index] * sigmaSq[index];
-    sigma6 = std::max(sigma6, forcefield.sc_sigma_6);
+    double sigma6 = pairs[index].sigma6;
     double dist6 = distSq * distSq * distSq;
     double lambdaCoef = forcefield.sc_alpha * pow((1.0 - lambda), forcefield.sc_power);
     double softDist6 = lambdaCoef * sigma6 + dist6;
     double softRsq = cbrt(softDist6);
     double correction = distSq / softRsq;
     //We need to fix the return value from calcVir
-    vir = lambda * correction * correction * CalcCoulombVir(softRsq, qi_qj, b);
+    vir = lambda * correction * correction * FF_SHIFT::CalcCoulombVir(softRsq, qi_qj, b);
   } else {
-    vir = lambda * CalcCoulombVir(distSq, qi_qj, b);
+    vir = lambda * FF_SHIFT::CalcCoulombVir(distSq, qi_qj, b);
   }
   return vir;
 }
@@ -301,12 +317,16 @@ inline double FF_SHIFT::CalcCoulombVir(const double distSq, const double qi_qj,
                                        uint b) const
 {
   if(forcefield.ewald) {
+    double table;
+    if(forcefield.ewaldTable.Virial(table, distSq, b))
+      return qi_qj * table + qi_qj * WolfVirial(distSq, b);
     double dist = sqrt(distSq);
     // M_2_SQRTPI is 2/sqrt(PI)
     double constValue = forcefield.alpha[b] * M_2_SQRTPI;
     double expConstValue = exp(-1.0 * forcefield.alphaSq[b] * distSq);
     double temp = erfc(forcefield.alpha[b] * dist);
-    return qi_qj * (temp / dist + constValue * expConstValue) / distSq;
+    return qi_qj * (temp / dist + constValue * expConstValue) / distSq +
+           qi_qj * WolfVirial(distSq, b);
   } else {
     double dist = sqrt(distSq);
     return qi_qj / (distSq * dist);
@@ -320,15 +340,14 @@ inline double FF_SHIFT::CalcdEndL(const double distSq, const uint kind1,
     return 0.0;
 
   uint index = FlatIndex(kind1, kind2);
-  double sigma6 = sigmaSq[index] * sigmaSq[index] * sigmaSq[index];
-  sigma6 = std::max(sigma6, forcefield.sc_sigma_6);
+  double sigma6 = pairs[index].sigma6;
   double dist6 = distSq * distSq * distSq;
   double lambdaCoef = forcefield.sc_alpha * pow((1.0 - lambda), forcefield.sc_power);
   double softDist6 = lambdaCoef * sigma6 + dist6;
   double softRsq = cbrt(softDist6);
   double fCoef = lambda * forcefield.sc_alpha * forcefield.sc_power / 6.0;
   fCoef *= pow(1.0 - lambda, forcefield.sc_power - 1.0) * sigma6 / (softRsq * softRsq);
-  double dhdl = CalcEn(softRsq, index) + fCoef * CalcVir(softRsq, index);
+  double dhdl = FF_SHIFT::CalcEn(softRsq, index) + fCoef * FF_SHIFT::CalcVir(softRsq, index);
   return dhdl;
 }
 
@@ -344,18 +363,17 @@ inline double FF_SHIFT::CalcCoulombdEndL(const double distSq, const uint kind1,
   double dhdl = 0.0;
   if(forcefield.sc_coul) {
     uint index = FlatIndex(kind1, kind2);
-    double sigma6 = sigmaSq[index] * sigmaSq[index] * sigmaSq[index];
-    sigma6 = std::max(sigma6, forcefield.sc_sigma_6);
+    double sigma6 = pairs[index].sigma6;
     double dist6 = distSq * distSq * distSq;
     double lambdaCoef = forcefield.sc_alpha * pow((1.0 - lambda), forcefield.sc_power);
     double softDist6 = lambdaCoef * sigma6 + dist6;
     double softRsq = cbrt(softDist6);
     double fCoef = lambda * forcefield.sc_alpha * forcefield.sc_power / 6.0;
     fCoef *= pow(1.0 - lambda, forcefield.sc_power - 1.0) * sigma6 / (softRsq * softRsq);
-    dhdl = CalcCoulomb(softRsq, qi_qj_Fact, b) +
-           fCoef * CalcCoulombVir(softRsq, qi_qj_Fact, b);
+    dhdl = FF_SHIFT::CalcCoulomb(softRsq, qi_qj_Fact, b) +
+           fCoef * FF_SHIFT::CalcCoulombVir(softRsq, qi_qj_Fact, b);
   } else {
-    dhdl = CalcCoulomb(distSq, qi_qj_Fact, b);
+    dhdl = FF_SHIFT::CalcCoulomb(distSq, qi_qj_Fact, b);
   }
   return dhdl;
 }
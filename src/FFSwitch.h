@@ -94,6 +94,12 @@ public:
                                   const uint kind2, const double qi_qj_Fact,
                                   const double lambda, uint b) const;
 
+  //!Switched potential has no SIMD kernel, uses the scalar one
+  virtual bool GetSimdParams(simd::PairParams &par) const
+  {
+    return false;
+  }
+
 protected:
   virtual double CalcEn(const double distSq, const uint index) const;
   virtual double CalcVir(const double distSq, const uint index) const;
@@ -125,19 +131,19 @@ inline void FF_SWITCH::CalcAdd_1_4(double& en, const double distSq,
   if(forcefield.rCutSq < distSq)
     return;
 
-  uint index = FlatIndex(kind1, kind2);
+  const FFPairParam &p = pairs_1_4[FlatIndex(kind1, kind2)];
   double rCutSq_rijSq = forcefield.rCutSq - distSq;
   double rCutSq_rijSq_Sq = rCutSq_rijSq * rCutSq_rijSq;
 
-  double rRat2 = sigmaSq_1_4[index] / distSq;
+  double rRat2 = p.sigmaSq / distSq;
   double attract = rRat2 * rRat2 * rRat2;
-  double repulse = pow(sqrt(rRat2), n_1_4[index]);
+  double repulse = Repulse(p, rRat2, attract);
 
   double fE = rCutSq_rijSq_Sq * factor2 * (factor1 + 2.0 * distSq);
 
   const double factE = ( distSq > rOnSq ? fE : 1.0);
 
-  en += (epsilon_cn_1_4[index] * (repulse - attract)) * factE;
+  en += (p.epsilon_cn * (repulse - attract)) * factE;
 }
 
 inline void FF_SWITCH::CalcCoulombAdd_1_4(double& en, const double distSq,
@@ -163,31 +169,31 @@ inline double FF_SWITCH::CalcEn(const double distSq, const uint kind1,
   uint index = FlatIndex(kind1, kind2);
   if(lambda >= 0.999999) {
     //save computation time
-    return CalcEn(distSq, index);
+    return FF_SWITCH::CalcEn(distSq, index);
   }
-  double sigma6 = sigmaSq[index] * sigmaSq[index] * sigmaSq[index];
-  sigma6 = std::max(sigma6, forcefield.sc_sigma_6);
+  double sigma6 = pairs[index].sigma6;
   double dist6 = distSq * distSq * distSq;
   double lambdaCoef = forcefield.sc_alpha * pow((1.0 - lambda), forcefield.sc_power);
   double softDist6 = lambdaCoef * sigma6 + dist6;
   double softRsq = cbrt(softDist6);
 
-  double en = lambda * CalcEn(softRsq, index);
+  double en = lambda * FF_SWITCH::CalcEn(softRsq, index);
   return en;
 }
 
 inline double FF_SWITCH::CalcEn(const double distSq, const uint index) const
 {
+  const FFPairParam &p = pairs[index];
   double rCutSq_rijSq = forcefield.rCutSq - distSq;
   double rCutSq_rijSq_Sq = rCutSq_rijSq * rCutSq_rijSq;
-  double rRat2 = sigmaSq[index] / distSq;
+  double rRat2 = p.sigmaSq / distSq;
   double attract = rRat2 * rRat2 * rRat2;
-  double repulse = pow(rRat2, (n[index] * 0.5));
+  double repulse = Repulse(p, rRat2, attract);
 
   double fE = rCutSq_rijSq_Sq * factor2 * (factor1 + 2.0 * distSq);
   const double factE = ( distSq > rOnSq ? fE : 1.0);
 
-  return (epsilon_cn[index] * (repulse - attract)) * factE;
+  return (p.epsilon_cn * (repulse - attract)) * factE;
 }
 
 inline double FF_SWITCH::CalcVir(const double distSq, const uint kind1,
@@ -199,37 +205,37 @@ inline double FF_SWITCH::CalcVir(const double distSq, const uint kind1,
   uint index = FlatIndex(kind1, kind2);
   if(lambda >= 0.999999) {
     //save computation time
-    return CalcVir(distSq, index);
+    return FF_SWITCH::CalcVir(distSq, index);
   }
-  double sigma6 = sigmaSq[index] * sigmaSq[index] * sigmaSq[index];
-  sigma6 = std::max(sigma6, forcefield.sc_sigma_6);
+  double sigma6 = pairs[index].sigma6;
   double dist6 = distSq * distSq * distSq;
   double lambdaCoef = forcefield.sc_alpha * pow((1.0 - lambda), forcefield.sc_power);
   double softDist6 = lambdaCoef * sigma6 + dist6;
   double softRsq = cbrt(softDist6);
   double correction = distSq / softRsq;
   //We need to fix the return value from calcVir
-  double vir = lambda * correction * correction * CalcVir(softRsq, index);
+  double vir = lambda * correction * correction * FF_SWITCH::CalcVir(softRsq, index);
   return vir;
 }
 
 inline double FF_SWITCH::CalcVir(const double distSq, const uint index) const
 {
+  const FFPairParam &p = pairs[index];
   double rCutSq_rijSq = forcefield.rCutSq - distSq;
   double rCutSq_rijSq_Sq = rCutSq_rijSq * rCutSq_rijSq;
 
   double rNeg2 = 1.0 / distSq;
-  double rRat2 = rNeg2 * sigmaSq[index];
+  double rRat2 = rNeg2 * p.sigmaSq;
   double attract = rRat2 * rRat2 * rRat2;
-  double repulse = pow(rRat2, (n[index] * 0.5));
+  double repulse = Repulse(p, rRat2, attract);
 
   double fE = rCutSq_rijSq_Sq * factor2 * (factor1 + 2.0 * distSq);
   double fW = 12.0 * factor2 * rCutSq_rijSq * (rOnSq - distSq);
 
   const double factE = ( distSq > rOnSq ? fE : 1.0);
   const double factW = ( distSq > rOnSq ? fW : 0.0);
-  double Wij = epsilon_cn_6[index] * (nOver6[index] * repulse - attract) * rNeg2;
-  double Eij = epsilon_cn[index] * (repulse - attract);
+  double Wij = p.epsilon_cn_6 * (p.nOver6 * repulse - attract) * rNeg2;
+  double Eij = p.epsilon_cn * (repulse - attract);
 
   return (Wij * factE - Eij * factW);
 }
@@ -246,20 +252,19 @@ inline double FF_SWITCH::CalcCoulomb(const double distSq,
 
   if(lambda >= 0.999999) {
     //save computation time
-    return CalcCoulomb(distSq, qi_qj_Fact, b);
+    return FF_SWITCH::CalcCoulomb(distSq, qi_qj_Fact, b);
   }
   double en = 0.0;
   if(forcefield.sc_coul) {
     uint index = FlatIndex(kind1, kind2);
-    double sigma6 = sigmaSq[index] * sigmaSq[index] * sigmaSq[index];
-    sigma6 = std::max(sigma6, forcefield.sc_sigma_6);
+    double sigma6 = pairs[index].sigma6;
     double dist6 = distSq * distSq * distSq;
     double lambdaCoef = forcefield.sc_alpha * pow((1.0 - lambda), forcefield.sc_power);
     double softDist6 = lambdaCoef * sigma6 + dist6;
     double softRsq = cbrt(softDist6);
-    en = lambda * CalcCoulomb(softRsq, qi_qj_Fact, b);
+    en = lambda * FF_SWITCH::CalcCoulomb(softRsq, qi_qj_Fact, b);
   } else {
-    en = lambda * CalcCoulomb(distSq, qi_qj_Fact, b);
+    en = lambda * FF_SWITCH::CalcCoulomb(distSq, qi_qj_Fact, b);
   }
   return en;
 }
@@ -269,9 +274,13 @@ inline double FF_SWITCH::CalcCoulomb(const double distSq,
                                      const uint b) const
 {
   if(forcefield.ewald) {
+    double table;
+    if(forcefield.ewaldTable.Energy(table, distSq, b))
+      return qi_qj_Fact * table + qi_qj_Fact * WolfEnergy(distSq, b);
     double dist = sqrt(distSq);
     double val = forcefield.alpha[b] * dist;
-    return qi_qj_Fact * erfc(val) / dist;
+    return qi_qj_Fact * erfc(val) / dist +
+           qi_qj_Fact * WolfEnergy(distSq, b);
   } else {
     double dist = sqrt(distSq);
     double switchVal = distSq / forcefield.rCutSq - 1.0;
@@ -292,22 +301,21 @@ inline double FF_SWITCH::CalcCoulombVir(const double distSq,
 
   if(lambda >= 0.999999) {
     //save computation time
-    return CalcCoulombVir(distSq, qi_qj, b);
+    return FF_SWITCH::CalcCoulombVir(distSq, qi_qj, b);
   }
   double vir = 0.0;
   if(forcefield.sc_coul) {
     uint index = FlatIndex(kind1, kind2);
-    double sigma6 = sigmaSq[index] * sigmaSq[index] * sigmaSq[index];
-    sigma6 = std::max(sigma6, forcefield.sc_sigma_6);
+    double sigma6 = pairs[index].sigma6;
     double dist6 = distSq * distSq * distSq;
     double lambdaCoef = forcefield.sc_alpha * pow((1.0 - lambda), forcefield.sc_power);
     double softDist6 = lambdaCoef * sigma6 + dist6;
     double softRsq = cbrt(softDist6);
     double correction = distSq / softRsq;
     //We need to fix the return value from calcVir
-    vir = lambda * correction * correction * CalcCoulombVir(softRsq, qi_qj, b);
+    vir = lambda * correction * correction * FF_SWITCH::CalcCoulombVir(softRsq, qi_qj, b);
   } else {
-    vir = lambda * CalcCoulombVir(distSq, qi_qj, b);
+    vir = lambda * FF_SWITCH::CalcCoulombVir(distSq, qi_qj, b);
   }
   return vir;
 }
@@ -316,12 +324,16 @@ inline double FF_SWITCH::CalcCoulombVir(const double distSq, const double qi_qj,
                                         const uint b) const
 {
   if(forcefield.ewald) {
+    double table;
+    if(forcefield.ewaldTable.Virial(table, distSq, b))
+      return qi_qj * table + qi_qj * WolfVirial(distSq, b);
     double dist = sqrt(distSq);
     // M_2_SQRTPI is 2/sqrt(PI)
     double constValue = forcefield.alpha[b] * M_2_SQRTPI;
     double expConstValue = exp(-1.0 * forcefield.alphaSq[b] * distSq);
     double temp = erfc(forcefield.alpha[b] * dist);
-    return qi_qj * (temp / dist + constValue * expConstValue) / distSq;
+    return qi_qj * (temp / dist + constValue * expConstValue) / distSq +
+           qi_qj * WolfVirial(distSq, b);
   } else {
     double dist = sqrt(distSq);
     double switchVal = distSq / forcefield.rCutSq - 1.0;
@@ -339,15 +351,14 @@ inline double FF_SWITCH::CalcdEndL(const double distSq, const uint kind1,
     return 0.0;
 
   uint index = FlatIndex(kind1, kind2);
-  double sigma6 = sigmaSq[index] * sigmaSq[index] * sigmaSq[index];
-  sigma6 = std::max(sigma6, forcefield.sc_sigma_6);
+  double sigma6 = pairs[index].sigma6;
   double dist6 = distSq * distSq * distSq;
   double lambdaCoef = forcefield.sc_alpha * pow((1.0 - lambda), forcefield.sc_power);
   double softDist6 = lambdaCoef * sigma6 + dist6;
   double softRsq = cbrt(softDist6);
   double fCoef = lambda * forcefield.sc_alpha * forcefield.sc_power / 6.0;
   fCoef *= pow(1.0 - lambda, forcefield.sc_power - 1.0) * sigma6 / (softRsq * softRsq);
-  double dhdl = CalcEn(softRsq, index) + fCoef * CalcVir(softRsq, index);
+  double dhdl = FF_SWITCH::CalcEn(softRsq, index) + fCoef * FF_SWITCH::CalcVir(softRsq, index);
   return dhdl;
 }
 
@@ -364,18 +375,17 @@ inline double FF_SWITCH::CalcCoulombdEndL(const double distSq,
   double dhdl = 0.0;
   if(forcefield.sc_coul) {
     uint index = FlatIndex(kind1, kind2);
-    double sigma6 = sigmaSq[index] * sigmaSq[index] * sigmaSq[index];
-    sigma6 = std::max(sigma6, forcefield.sc_sigma_6);
+    double sigma6 = pairs[index].sigma6;
     double dist6 = distSq * distSq * distSq;
     double lambdaCoef = forcefield.sc_alpha * pow((1.0 - lambda), forcefield.sc_power);
     double softDist6 = lambdaCoef * sigma6 + dist6;
     double softRsq = cbrt(softDist6);
     double fCoef = lambda * forcefield.sc_alpha * forcefield.sc_power / 6.0;
     fCoef *= pow(1.0 - lambda, forcefield.sc_power - 1.0) * sigma6 / (softRsq * softRsq);
-    dhdl = CalcCoulomb(softRsq, qi_qj_Fact, b) +
-           fCoef * CalcCoulombVir(softRsq, qi_qj_Fact, b);
+    dhdl = FF_SWITCH::CalcCoulomb(softRsq, qi_qj_Fact, b) +
+           fCoef * FF_SWITCH::CalcCoulombVir(softRsq, qi_qj_Fact, b);
   } else {
-    dhdl = CalcCoulomb(distSq, qi_qj_Fact, b);
+    dhdl = FF_SWITCH::CalcCoulomb(distSq, qi_qj_Fact, b);
   }
   return dhdl;
 }
@@ -118,6 +118,12 @@ public:
                                   const uint kind2, const double qi_qj_Fact,
                                   const double lambda, uint b) const;
 
+  //!Switched potential has no SIMD kernel, uses the scalar one
+  virtual bool GetSimdParams(simd::PairParams &par) const
+  {
+    return false;
+  }
+
 protected:
   virtual double CalcEn(const double distSq, const uint index) const;
   virtual double CalcVir(const double distSq, const uint index) const;
@@ -275,16 +281,15 @@ inline double FF_SWITCH_MARTINI::CalcEn(const double distSq,
   uint index = FlatIndex(kind1, kind2);
   if(lambda >= 0.999999) {
     //save computation time
-    return CalcEn(distSq, index);
+    return FF_SWITCH_MARTINI::CalcEn(distSq, index);
   }
-  double sigma6 = sigmaSq[index] * sigmaSq[index] * sigmaSq[index];
-  sigma6 = std::max(sigma6, forcefield.sc_sigma_6);
+  double sigma6 = pairs[index].sigma6;
   double dist6 = distSq * distSq * distSq;
   double lambdaCoef = forcefield.sc_alpha * pow((1.0 - lambda), forcefield.sc_power);
   double softDist6 = lambdaCoef * sigma6 + dist6;
   double softRsq = cbrt(softDist6);
 
-  double en = lambda * CalcEn(softRsq, index);
+  double en = lambda * FF_SWITCH_MARTINI::CalcEn(softRsq, index);
   return en;
 }
 
@@ -325,17 +330,16 @@ inline double FF_SWITCH_MARTINI::CalcVir(const double distSq,
   uint index = FlatIndex(kind1, kind2);
   if(lambda >= 0.999999) {
     //save computation time
-    return CalcVir(distSq, index);
+    return FF_SWITCH_MARTINI::CalcVir(distSq, index);
   }
-  double sigma6 = sigmaSq[index] * sigmaSq[index] * sigmaSq[index];
-  sigma6 = std::max(sigma6, forcefield.sc_sigma_6);
+  double sigma6 = pairs[index].sigma6;
   double dist6 = distSq * distSq * distSq;
   double lambdaCoef = forcefield.sc_alpha * pow((1.0 - lambda), forcefield.sc_power);
   double softDist6 = lambdaCoef * sigma6 + dist6;
   double softRsq = cbrt(softDist6);
   double correction = distSq / softRsq;
   //We need to fix the return value from calcVir
-  double vir = lambda * correction * correction * CalcVir(softRsq, index);
+  double vir = lambda * correction * correction * FF_SWITCH_MARTINI::CalcVir(softRsq, index);
   return vir;
 }
 
@@ -376,20 +380,19 @@ inline double FF_SWITCH_MARTINI::CalcCoulomb(const double distSq,
 
   if(lambda >= 0.999999) {
     //save computation time
-    return CalcCoulomb(distSq, qi_qj_Fact, b);
+    return FF_SWITCH_MARTINI::CalcCoulomb(distSq, qi_qj_Fact, b);
   }
   double en = 0.0;
   if(forcefield.sc_coul) {
     uint index = FlatIndex(kind1, kind2);
-    double sigma6 = sigmaSq[index] * sigmaSq[index] * sigmaSq[index];
-    sigma6 = std::max(sigma6, forcefield.sc_sigma_6);
+    double sigma6 = pairs[index].sigma6;
     double dist6 = distSq * distSq * distSq;
     double lambdaCoef = forcefield.sc_alpha * pow((1.0 - lambda), forcefield.sc_power);
     double softDist6 = lambdaCoef * sigma6 + dist6;
     double softRsq = cbrt(softDist6);
-    en = lambda * CalcCoulomb(softRsq, qi_qj_Fact, b);
+    en = lambda * FF_SWITCH_MARTINI::CalcCoulomb(softRsq, qi_qj_Fact, b);
   } else {
-    en = lambda * CalcCoulomb(distSq, qi_qj_Fact, b);
+    en = lambda * FF_SWITCH_MARTINI::CalcCoulomb(distSq, qi_qj_Fact, b);
   }
   return en;
 }
@@ -399,9 +402,13 @@ inline double FF_SWITCH_MARTINI::CalcCoulomb(const double distSq,
     const uint b) const
 {
   if(forcefield.ewald) {
+    double table;
+    if(forcefield.ewaldTable.Energy(table, distSq, b))
+      return qi_qj_Fact * table + qi_qj_Fact * WolfEnergy(distSq, b);
     double dist = sqrt(distSq);
     double val = forcefield.alpha[b] * dist;
-    return qi_qj_Fact * erfc(val) / dist;
+    return qi_qj_Fact * erfc(val) / dist +
+           qi_qj_Fact * WolfEnergy(distSq, b);
   } else {
     // in Martini, the Coulomb switching distance is zero, so we will have
     // sqrt(distSq) - rOnCoul =  sqrt(distSq)
@@ -426,22 +433,21 @@ inline double FF_SWITCH_MARTINI::CalcCoulombVir(const double distSq,
 
   if(lambda >= 0.999999) {
     //save computation time
-    return CalcCoulombVir(distSq, qi_qj, b);
+    return FF_SWITCH_MARTINI::CalcCoulombVir(distSq, qi_qj, b);
   }
   double vir = 0.0;
   if(forcefield.sc_coul) {
     uint index = FlatIndex(kind1, kind2);
-    double sigma6 = sigmaSq[index] * sigmaSq[index] * sigmaSq[index];
-    sigma6 = std::max(sigma6, forcefield.sc_sigma_6);
+    double sigma6 = pairs[index].sigma6;
     double dist6 = distSq * distSq * distSq;
     double lambdaCoef = forcefield.sc_alpha * pow((1.0 - lambda), forcefield.sc_power);
     double softDist6 = lambdaCoef * sigma6 + dist6;
     double softRsq = cbrt(softDist6);
     double correction = distSq / softRsq;
     //We need to fix the return value from calcVir
-    vir = lambda * correction * correction * CalcCoulombVir(softRsq, qi_qj, b);
+    vir = lambda * correction * correction * FF_SWITCH_MARTINI::CalcCoulombVir(softRsq, qi_qj, b);
   } else {
-    vir = lambda * CalcCoulombVir(distSq, qi_qj, b);
+    vir = lambda * FF_SWITCH_MARTINI::CalcCoulombVir(distSq, qi_qj, b);
   }
   return vir;
 }
@@ -451,12 +457,16 @@ inline double FF_SWITCH_MARTINI::CalcCoulombVir(const double distSq,
     const uint b) const
 {
   if(forcefield.ewald) {
+    double table;
+    if(forcefield.ewaldTable.Virial(table, distSq, b))
+      return qi_qj * table + qi_qj * WolfVirial(distSq, b);
     double dist = sqrt(distSq);
     // M_2_SQRTPI is 2/sqrt(PI)
     double constValue = forcefield.alpha[b] * M_2_SQRTPI;
     double expConstValue = exp(-1.0 * forcefield.alphaSq[b] * distSq);
     double temp = erfc(forcefield.alpha[b] * dist);
-    return qi_qj * (temp / dist + constValue * expConstValue) / distSq;
+    return qi_qj * (temp / dist + constValue * expConstValue) / distSq +
+           qi_qj * WolfVirial(distSq, b);
   } else {
     // in Martini, the Coulomb switching distance is zero, so we will have
     // sqrt(distSq) - rOnCoul =  sqrt(distSq)
@@ -478,15 +488,14 @@ inline double FF_SWITCH_MARTINI::CalcdEndL(const double distSq,
     return 0.0;
 
   uint index = FlatIndex(kind1, kind2);
-  double sigma6 = sigmaSq[index] * sigmaSq[index] * sigmaSq[index];
-  sigma6 = std::max(sigma6, forcefield.sc_sigma_6);
+  double sigma6 = pairs[index].sigma6;
   double dist6 = distSq * distSq * distSq;
   double lambdaCoef = forcefield.sc_alpha * pow((1.0 - lambda), forcefield.sc_power);
   double softDist6 = lambdaCoef * sigma6 + dist6;
   double softRsq = cbrt(softDist6);
   double fCoef = lambda * forcefield.sc_alpha * forcefield.sc_power / 6.0;
   fCoef *= pow(1.0 - lambda, forcefield.sc_power - 1.0) * sigma6 / (softRsq * softRsq);
-  double dhdl = CalcEn(softRsq, index) + fCoef * CalcVir(softRsq, index);
+  double dhdl = FF_SWITCH_MARTINI::CalcEn(softRsq, index) + fCoef * FF_SWITCH_MARTINI::CalcVir(softRsq, index);
   return dhdl;
 }
 
@@ -504,18 +513,17 @@ inline double FF_SWITCH_MARTINI::CalcCoulombdEndL(const double distSq,
   double dhdl = 0.0;
   if(forcefield.sc_coul) {
     uint index = FlatIndex(kind1, kind2);
-    double sigma6 = sigmaSq[index] * sigmaSq[index] * sigmaSq[index];
-    sigma6 = std::max(sigma6, forcefield.sc_sigma_6);
+    double sigma6 = pairs[index].sigma6;
     double dist6 = distSq * distSq * distSq;
     double lambdaCoef = forcefield.sc_alpha * pow((1.0 - lambda), forcefield.sc_power);
     double softDist6 = lambdaCoef * sigma6 + dist6;
     double softRsq = cbrt(softDist6);
     double fCoef = lambda * forcefield.sc_alpha * forcefield.sc_power / 6.0;
     fCoef *= pow(1.0 - lambda, forcefield.sc_power - 1.0) * sigma6 / (softRsq * softRsq);
-    dhdl = CalcCoulomb(softRsq, qi_qj_Fact, b) +
-           fCoef * CalcCoulombVir(softRsq, qi_qj_Fact, b);
+    dhdl = FF_SWITCH_MARTINI::CalcCoulomb(softRsq, qi_qj_Fact, b) +
+           fCoef * FF_SWITCH_MARTINI::CalcCoulombVir(softRsq, qi_qj_Fact, b);
   } else {
-    dhdl = CalcCoulomb(distSq, qi_qj_Fact, b);
+    dhdl = FF_SWITCH_MARTINI::CalcCoulomb(distSq, qi_qj_Fact, b);
   }
   return dhdl;
 }
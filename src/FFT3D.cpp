@@ -0,0 +1,122 @@
+/*******************************************************************************
+GPU OPTIMIZED MONTE CARLO (GOMC) 2.75
+Copyright (C) 2022 GOMC Group
+A copy of the MIT License can be found in License.txt
+along with this program, also can be found at <https://opensource.org/licenses/MIT>.
+********************************************************************************/
+#include "FFT3D.h"
+#include "EnsemblePreprocessor.h" //For GCC_VERSION
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+FFT3D::FFT3D()
+{
+  n[0] = n[1] = n[2] = 0;
+}
+
+uint FFT3D::NextPowerOfTwo(const uint len)
+{
+  uint pow2 = 1;
+  while(pow2 < len)
+    pow2 <<= 1;
+  return pow2;
+}
+
+void FFT3D::Resize(const uint nx, const uint ny, const uint nz)
+{
+  uint len[3] = {nx, ny, nz};
+  for(uint d = 0; d < 3; d++) {
+    if(len[d] == 0 || NextPowerOfTwo(len[d]) != len[d]) {
+      printf("Error: FFT grid size %u is not a power of two!\n", len[d]);
+      exit(EXIT_FAILURE);
+    }
+    if(len[d] == n[d])
+      continue;
+
+    n[d] = len[d];
+    twiddle[d].resize(n[d] / 2);
+    for(uint k = 0; k < n[d] / 2; k++) {
+      double angle = 2.0 * M_PI * k / n[d];
+      twiddle[d][k] = std::complex<double>(cos(angle), sin(angle));
+    }
+    uint bits = 0;
+    while((1u << bits) < n[d])
+      bits++;
+    reversed[d].resize(n[d]);
+    for(uint k = 0; k < n[d]; k++) {
+      uint r = 0;
+      for(uint b = 0; b < bits; b++) {
+        if(k & (1u << b))
+          r |= 1u << (bits - 1 - b);
+      }
+      reversed[d][k] = r;
+    }
+  }
+}
+
+void FFT3D::Transform1D(std::complex<double> *line, const uint d,
+                        const int sign) const
+{
+  uint len = n[d];
+  for(uint k = 0; k < len; k++) {
+    if(k < reversed[d][k])
+      std::swap(line[k], line[reversed[d][k]]);
+  }
+
+  for(uint half = 1; half < len; half <<= 1) {
+    uint step = len / (2 * half);
+    for(uint start = 0; start < len; start += 2 * half) {
+      for(uint k = 0; k < half; k++) {
+        std::complex<double> w = twiddle[d][k * step];
+        if(sign < 0)
+          w = std::conj(w);
+        std::complex<double> odd = w * line[start + half + k];
+        line[start + half + k] = line[start + k] - odd;
+        line[start + k] += odd;
+      }
+    }
+  }
+}
+
+void FFT3D::Transform(std::complex<double> *data, const int sign) const
+{
+  //distance between neighbor points along each axis. A line of axis d
+  //starts at every point with a zero index along d.
+  uint stride[3] = {n[1] * n[2], n[2], 1};
+
+  for(int d = 2; d >= 0; d--) {
+    uint len = n[d], dist = stride[d];
+    int lines = (int) (Size() / len);
+
+#ifdef _OPENMP
+#if GCC_VERSION >= 90000
+    #pragma omp parallel default(none) shared(d, data, dist, len, lines, \
+    sign)
+#else
+    #pragma omp parallel default(none) shared(d, data, dist, len, lines)
+#endif
+#endif
+    {
+      std::vector<std::complex<double> > scratch(len);
+#ifdef _OPENMP
+      #pragma omp for
+#endif
+      for(int l = 0; l < lines; l++) {
+        uint first = (l / dist) * len * dist + (l % dist);
+        if(dist == 1) {
+          Transform1D(data + first, d, sign);
+        } else {
+          for(uint k = 0; k < len; k++)
+            scratch[k] = data[first + k * dist];
+          Transform1D(&scratch[0], d, sign);
+          for(uint k = 0; k < len; k++)
+            data[first + k * dist] = scratch[k];
+        }
+      }
+    }
+  }
+}
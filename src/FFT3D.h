@@ -0,0 +1,55 @@
+/*******************************************************************************
+GPU OPTIMIZED MONTE CARLO (GOMC) 2.75
+Copyright (C) 2022 GOMC Group
+A copy of the MIT License can be found in License.txt
+along with this program, also can be found at <https://opensource.org/licenses/MIT>.
+********************************************************************************/
+#ifndef FFT3D_H
+#define FFT3D_H
+
+#include "BasicTypes.h" //For uint
+#include <complex>
+#include <vector>
+
+//In-place complex 3D discrete Fourier transform of a grid with power of two
+//sizes, stored with z running fastest: data[(x * ny + y) * nz + z].
+//  out(m) = sum_g in(g) * e^{sign * 2 PI i (mx gx / nx + my gy / ny + mz gz / nz)}
+//No normalization is applied in either direction. Each axis is done as a
+//set of iterative radix-2 transforms of the grid lines along that axis.
+class FFT3D
+{
+public:
+  FFT3D();
+
+  //Sets the grid size, every size must be a power of two
+  void Resize(const uint nx, const uint ny, const uint nz);
+
+  //Transforms data, which holds Size() points, with sign +1 or -1
+  void Transform(std::complex<double> *data, const int sign) const;
+
+  uint Size() const
+  {
+    return n[0] * n[1] * n[2];
+  }
+
+  uint Length(const uint d) const
+  {
+    return n[d];
+  }
+
+  //Smallest power of two that is not less than len
+  static uint NextPowerOfTwo(const uint len);
+
+private:
+  //Transforms one line of length n[d]
+  void Transform1D(std::complex<double> *line, const uint d,
+                   const int sign) const;
+
+  uint n[3];
+  //e^{2 PI i k / n[d]} for k < n[d] / 2
+  std::vector<std::complex<double> > twiddle[3];
+  //bit reversed index of every point of the line
+  std::vector<uint> reversed[3];
+};
+
+#endif /*FFT3D_H*/
@@ -46,11 +46,21 @@ void Forcefield::InitBasicVals(config_setup::SystemVals const& val,
 {
   useLRC = val.ff.doTailCorr;
   useIPC = val.ff.doImpulsePressureCorr;
+  simdKernel = val.ff.simdKernel;
+  verletSkin = val.ff.verletSkin;
+  halfShell = val.ff.halfShell;
+  mixedPrecision = val.ff.mixedPrecision;
+  mixedPrecisionFreq = val.ff.mixedPrecisionFreq;
+  parallelGrain = val.ff.parallelGrain;
+  energyLedger = val.ff.energyLedger;
   T_in_K = val.T.inKelvin;
   rCut = val.ff.cutoff;
   rCutSq = rCut * rCut;
   rCutLow = val.ff.cutoffLow;
   rCutLowSq = rCutLow * rCutLow;
+  rCutSurrogateSq = val.ff.cutoffSurrogate * val.ff.cutoffSurrogate;
+  dropOverlapTrials = val.ff.dropOverlapTrials;
+  comScreen = val.ff.comScreen;
   scaling_14 = val.elect.oneFourScale;
   beta = 1 / T_in_K;
 
@@ -60,6 +70,8 @@ void Forcefield::InitBasicVals(config_setup::SystemVals const& val,
 
   electrostatic = val.elect.enable;
   ewald = val.elect.ewald;
+  ewaldRecurrence = val.elect.ewaldRecurrence;
+  wolf = ewald && val.elect.wolf;
   tolerance = val.elect.tolerance;
   rswitch = val.ff.rswitch;
   dielectric = val.elect.dielectric;
@@ -89,6 +101,20 @@ void Forcefield::InitBasicVals(config_setup::SystemVals const& val,
     alphaSq[b] = alpha[b] * alpha[b];
     recip_rcut[b] = -2.0 * log(tolerance) / rCutCoulomb[b];
     recip_rcut_Sq[b] = recip_rcut[b] * recip_rcut[b];
+    wolfShift[b] = wolfForceShift[b] = 0.0;
+    if(wolf) {
+      //the pair energy goes to zero at Rc, and with DSF so does the force
+      wolfShift[b] = erfc(alpha[b] * rCutCoulomb[b]) / rCutCoulomb[b];
+      if(val.elect.wolfDSF) {
+        wolfForceShift[b] = (wolfShift[b] + alpha[b] * M_2_SQRTPI *
+                             exp(-alphaSq[b] * rCutCoulombSq[b])) /
+                            rCutCoulomb[b];
+      }
+    }
+    if(ewald && val.elect.ewaldTable) {
+      ewaldTable.Init(b, alpha[b], rCutLow, rCutCoulomb[b],
+                      val.elect.ewaldTableAccuracy);
+    }
   }
 
   vdwGeometricSigma = val.ff.vdwGeometricSigma;
@@ -8,10 +8,10 @@ along with this program, also can be found at <https://opensource.org/licenses/M
 #define FORCEFIELD_H
 
 //Member classes
-#include "FFParticle.h"
 #include "FFBonds.h"
 #include "FFAngles.h"
 #include "FFDihedrals.h"
+#include "EwaldRealTable.h"
 
 namespace config_setup
 {
@@ -43,16 +43,31 @@ public:
   FFDihedrals dihedrals;          //!<For 4-atom torsional rotation energy
   bool useLRC;                    //!<Use long-range tail corrections if true
   bool useIPC;                    //!<Use impulse pressure corrections if true
+  bool simdKernel;                //!<Use the SIMD box pair kernel if supported
+  double verletSkin;              //!<Skin of the Verlet pair list, 0 if unused
+  bool halfShell;                 //!<Use the half shell cell stencil
+  bool mixedPrecision;            //!<Single precision pair energies and recip
+  ulong mixedPrecisionFreq;       //!<Steps between double precision recalcs
+  int parallelGrain;              //!<Work of the parallel move loops, < 0 measured
+  bool energyLedger;              //!<Keep per-molecule energies for displacements
   double T_in_K;                  //!<System temp in Kelvin
   double beta;                    //!<Thermodynamic beta = 1/(T) K^-1)
   double rCut, rCutSq;            //!<Cutoff radius for LJ/Mie potential (angstroms)
   double rCutLow, rCutLowSq;      //!<Cutoff min for Electrostatic (angstroms)
+  double rCutSurrogateSq;         //!<LJ cutoff of the two-stage acceptance, 0 if unused
+  bool dropOverlapTrials;         //!<Zero weight for CBMC trials closer than rCutLow
+  bool comScreen;                 //!<Skip neighbor molecules by COM distance
   double rCutCoulomb[BOX_TOTAL];  //!<Cutoff Coulomb interaction(angstroms)
   double rCutCoulombSq[BOX_TOTAL]; //!<Cutoff Coulomb interaction(angstroms)
   double alpha[BOX_TOTAL];        //Ewald sum terms
   double alphaSq[BOX_TOTAL];      //Ewald sum terms
   double recip_rcut[BOX_TOTAL];   //Ewald sum terms
   double recip_rcut_Sq[BOX_TOTAL]; //Ewald sum terms
+  EwaldRealTable ewaldTable;      //!<Tabulated Ewald real space terms
+  bool ewaldRecurrence;           //!<Structure factors from per-atom phases
+  bool wolf;                      //!<Wolf / DSF summation, no reciprocal space
+  double wolfShift[BOX_TOTAL];    //!<erfc(alpha Rc) / Rc
+  double wolfForceShift[BOX_TOTAL]; //!<Force shift of DSF, zero for Wolf
   double tolerance;               //Ewald sum terms
   double rswitch;                 //Switch distance
   double dielectric;              //dielectric for martini
@@ -81,4 +96,8 @@ private:
 
 };
 
+//FFParticle's inline pair functions read the cutoffs from Forcefield, so it
+//has to be included after Forcefield is complete.
+#include "FFParticle.h"
+
 #endif /*FORCEFIELD_H*/
@@ -7,6 +7,7 @@ along with this program, also can be found at <https://opensource.org/licenses/M
 #include "Geometry.h"
 #include "MolSetup.h"
 #include "FFSetup.h"
+#include "NumLib.h"
 
 #include <algorithm>
 #include <vector>
@@ -314,6 +315,22 @@ void GeomFeature::Init(const std::vector<mol_setup::Improper>& imps, const BondL
 }
 
 
+void NonbondTable::Init(const Nonbond& nb, const uint* atomKind,
+                        const double* atomCharge)
+{
+  part1.assign(nb.part1, nb.part1 + nb.count);
+  part2.assign(nb.part2, nb.part2 + nb.count);
+  kind1.resize(nb.count);
+  kind2.resize(nb.count);
+  qi_qj_fact.resize(nb.count);
+  for (uint i = 0; i < nb.count; ++i) {
+    kind1[i] = atomKind[part1[i]];
+    kind2[i] = atomKind[part2[i]];
+    qi_qj_fact[i] = num::qqFact * atomCharge[part1[i]] *
+                    atomCharge[part2[i]];
+  }
+}
+
 void SortedNonbond::Init(const Nonbond& nb, const uint numAtoms)
 {
 
@@ -58,6 +58,21 @@ struct EwaldNonbond : public Nonbond {
 
 };
 
+//!Flat copy of a Nonbond list with the atom kinds and the charge product of
+//!every pair, so the intramolecular energy loops read contiguous arrays
+struct NonbondTable {
+  std::vector<uint> part1, part2, kind1, kind2;
+  //num::qqFact * charge of part1 * charge of part2
+  std::vector<double> qi_qj_fact;
+
+  void Init(const Nonbond& nb, const uint* atomKind,
+            const double* atomCharge);
+  uint Count() const
+  {
+    return part1.size();
+  }
+};
+
 
 //!List of all pairs of particles in bonds.
 struct BondList {
@@ -94,12 +94,16 @@ void MoleculeKind::Init
   sortedNB_1_4.Init(nonBonded_1_4, numAtoms);
   sortedNB.Init(nonBonded, numAtoms);
   sortedEwaldNB.Init(nonEwaldBonded, numAtoms);
+  tableNB.Init(nonBonded, atomKind, atomCharge);
+  tableNB_1_4.Init(nonBonded_1_4, atomKind, atomCharge);
+  tableNB_1_3.Init(nonBonded_1_3, atomKind, atomCharge);
   bondList.Init(molData.bonds);
   angles.Init(molData.angles, bondList);
   dihedrals.Init(molData.dihedrals, bondList);
   impropers.Init(molData.impropers, bondList);
   donorList.Init(molData.donors);
   acceptorList.Init(molData.acceptors);
+  InitRigid(forcefield);
 
   
 #ifdef VARIABLE_PARTICLE_NUMBER
@@ -109,7 +113,7 @@ void MoleculeKind::Init
 }
 
 MoleculeKind::MoleculeKind() : angles(3), dihedrals(4), impropers(4),
-  atomMass(NULL), builder(NULL), atomKind(NULL),
+  isRigid(false), atomMass(NULL), builder(NULL), atomKind(NULL),
   atomCharge(NULL) {}
 
 
@@ -173,6 +177,35 @@ void MoleculeKind::InitAtoms(mol_setup::MolKind const& molData)
   }
 }
 
+void MoleculeKind::InitRigid(Forcefield const& forcefield)
+{
+  isRigid = false;
+  if(numAtoms < 2 || bondList.count != numAtoms - 1 || NumDihs() != 0 ||
+      tableNB.Count() != 0 || tableNB_1_4.Count() != 0 ||
+      tableNB_1_3.Count() != 0)
+    return;
+
+  std::vector<uint> bondCount(numAtoms, 0);
+  for(uint i = 0; i < bondList.count; ++i) {
+    if(!forcefield.bonds.BondFixed(bondList.kinds[i]))
+      return;
+    ++bondCount[bondList.part1[i]];
+    ++bondCount[bondList.part2[i]];
+  }
+  //Only a single center with terminal atoms around it is fully defined by
+  //its bonds and angles, a bond between two centers would be a free torsion
+  for(uint i = 0; i < bondList.count; ++i) {
+    if(bondCount[bondList.part1[i]] > 1 && bondCount[bondList.part2[i]] > 1)
+      return;
+  }
+
+  for(uint i = 0; i < angles.Count(); ++i) {
+    if(!forcefield.angles->AngleFixed(angles.GetKind(i)))
+      return;
+  }
+  isRigid = true;
+}
+
 double MoleculeKind::GetMoleculeCharge()
 {
   double netCharge = 0.0;
@@ -179,6 +179,8 @@ public:
   Nonbond_1_4 nonBonded_1_4;
   Nonbond_1_3 nonBonded_1_3;
   EwaldNonbond nonEwaldBonded;
+  //flat pair tables of nonBonded, nonBonded_1_4 and nonBonded_1_3
+  NonbondTable tableNB, tableNB_1_4, tableNB_1_3;
 
   BondList bondList, donorList, acceptorList;
   GeomFeature angles;
@@ -186,6 +188,10 @@ public:
   GeomFeature impropers;
   
   bool oneThree, oneFour;
+  //every bond and angle is fixed, there are no dihedrals and no
+  //intramolecular nonbonded pairs, so the intramolecular energy is zero and
+  //the molecule can only be translated and rotated as a whole
+  bool isRigid;
 
   // uniqueName - guarunteed to be unique, the map key
   // name - not guarunteed to be unique
@@ -210,6 +216,9 @@ private:
 
   void InitAtoms(mol_setup::MolKind const& molData);
 
+  //sets isRigid from the fixed bonds and angles of the forcefield
+  void InitRigid(Forcefield const& forcefield);
+
   //uses buildBonds to check if molecule is branched
   //bool CheckBranches();
   void InitCBMC(System& sys, Forcefield& ff,
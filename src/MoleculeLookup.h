@@ -160,7 +160,8 @@ public:
                        double const * const volInv) const;
 
 #ifdef VARIABLE_PARTICLE_NUMBER
-  //Registers shift of mol into intoBox
+  //Registers shift of mol into intoBox, the caller also updates the tail
+  //sums with CalculateEnergy::ShiftTailSums
   //Returns true if shift was successful, false otherwise
   bool ShiftMolBox(const uint mol, const uint currentBox,
                    const uint intoBox, const uint kind);
@@ -109,6 +109,10 @@ void Molecules::Init(Setup & setup, Forcefield & forcefield,
     double netCharge = 0.0;
     for (uint mk = 0 ; mk < kindsCount; mk++) {
       netCharge += (countByKind[mk] * kinds[mk].GetMoleculeCharge());
+      if(kinds[mk].isRigid) {
+        printf("%-40s %-s \n", "Info: Rigid molecule kind",
+               kinds[mk].name.c_str());
+      }
       if(kinds[mk].MoleculeHasCharge()) {
         if(!forcefield.ewald && !forcefield.isMartini) {
           std::cout << "Warning: Charge detected in " << kinds[mk].name
@@ -0,0 +1,109 @@
+/*******************************************************************************
+GPU OPTIMIZED MONTE CARLO (GOMC) 2.75
+Copyright (C) 2022 GOMC Group
+A copy of the MIT License can be found in License.txt
+along with this program, also can be found at <https://opensource.org/licenses/MIT>.
+********************************************************************************/
+#include "ParallelGrain.h"
+#include "EnsemblePreprocessor.h" //For GCC_VERSION
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace
+{
+uint grainWork = 0;
+
+#ifdef _OPENMP
+//keeps the timed sums from being optimized away
+volatile double pairSumSink = 0.0;
+
+//Sum with the cost of a pair evaluation per iteration: LJ and erfc
+double PairSum(std::vector<double> const& distSq, int n, bool parallel)
+{
+  double sum = 0.0;
+#if GCC_VERSION >= 90000
+  #pragma omp parallel for default(none) shared(distSq, n) reduction(+:sum) \
+  if(parallel)
+#else
+  #pragma omp parallel for default(none) shared(distSq) reduction(+:sum) \
+  if(parallel)
+#endif
+  for(int i = 0; i < n; i++) {
+    double rRat2 = 1.0 / distSq[i];
+    double rRat6 = rRat2 * rRat2 * rRat2;
+    sum += rRat6 * rRat6 - rRat6 + erfc(distSq[i]) * sqrt(rRat2);
+  }
+  return sum;
+}
+
+//Best of a few timings of repeat calls of PairSum over n distances
+double TimePairSum(std::vector<double> const& distSq, const int n,
+                   const int repeat, const bool parallel)
+{
+  double best = 0.0;
+  for(int t = 0; t < 3; t++) {
+    double start = omp_get_wtime();
+    for(int r = 0; r < repeat; r++)
+      pairSumSink = pairSumSink + PairSum(distSq, n, parallel);
+    double time = omp_get_wtime() - start;
+    if(t == 0 || time < best)
+      best = time;
+  }
+  return best;
+}
+
+//Smallest power of two number of pair evaluations that is faster in
+//parallel than in serial
+uint MeasureGrain()
+{
+  const int maxWork = 1 << 16;
+  if(omp_get_max_threads() < 2)
+    return UINT_MAX;
+
+  std::vector<double> distSq(maxWork);
+  for(int i = 0; i < maxWork; i++)
+    distSq[i] = 1.0 + (i % 97) * 0.1;
+  //start the thread team before timing
+  PairSum(distSq, maxWork, true);
+  for(int n = 16; n <= maxWork; n *= 2) {
+    int repeat = std::max(maxWork / n, 4);
+    double serial = TimePairSum(distSq, n, repeat, false);
+    double parallel = TimePairSum(distSq, n, repeat, true);
+    if(parallel < serial)
+      return n;
+  }
+  return UINT_MAX;
+}
+#endif
+}
+
+namespace parallel_grain
+{
+void Init(const int grain)
+{
+#ifdef _OPENMP
+  if(grain < 0) {
+    grainWork = MeasureGrain();
+    if(grainWork == UINT_MAX)
+      printf("%-40s %-s \n", "Info: Parallel loop grain (measured)",
+             "Serial");
+    else
+      printf("%-40s %-u pairs\n", "Info: Parallel loop grain (measured)",
+             grainWork);
+  } else {
+    grainWork = grain;
+  }
+#endif
+}
+
+uint Grain()
+{
+  return grainWork;
+}
+}
@@ -0,0 +1,35 @@
+/*******************************************************************************
+GPU OPTIMIZED MONTE CARLO (GOMC) 2.75
+Copyright (C) 2022 GOMC Group
+A copy of the MIT License can be found in License.txt
+along with this program, also can be found at <https://opensource.org/licenses/MIT>.
+********************************************************************************/
+#ifndef PARALLEL_GRAIN_H
+#define PARALLEL_GRAIN_H
+
+#include "BasicTypes.h" //For uint
+
+//Grain size policy for the OpenMP loops of the moves (MoleculeInter,
+//ParticleInter, MolReciprocal, SwapDestRecip, the CBMC angle trials, ...).
+//They run once per atom or trial and often have only a few hundred
+//iterations, so starting the thread team can cost more than the work. The
+//loops pass an estimate of their work, in pair evaluations, to the if()
+//clause of their pragma and run serially below the grain. OpenMP keeps the
+//threads of the team alive between regions, so above the grain the work is
+//split across warm threads.
+namespace parallel_grain
+{
+//grain < 0 measures the grain on this machine with the current number of
+//threads, grain = 0 parallelizes every loop, grain > 0 is used as is
+void Init(const int grain);
+
+//Smallest work, in pair evaluations, that is run in parallel
+uint Grain();
+
+inline bool Parallel(const uint work)
+{
+  return work >= Grain();
+}
+}
+
+#endif /*PARALLEL_GRAIN_H*/
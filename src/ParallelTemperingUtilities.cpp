@@ -560,6 +560,7 @@ void ParallelTemperingUtilities::exchangeCellLists(CellList & myCellList, MultiS
     MPI_Send(&buffer.head[0][0], buffer.head[0].size(), MPI_INT, exchangePartner, 0,
              MPI_COMM_WORLD);
   }
+  myCellList.InvalidateCellArrays();
 }
 
 void ParallelTemperingUtilities::exchangePotentials(SystemPotential & mySystemPotential, MultiSim const*const& multisim, int exchangePartner, bool leader)
@@ -0,0 +1,640 @@
+/*******************************************************************************
+GPU OPTIMIZED MONTE CARLO (GOMC) 2.75
+Copyright (C) 2022 GOMC Group
+A copy of the MIT License can be found in License.txt
+along with this program, also can be found at <https://opensource.org/licenses/MIT>.
+********************************************************************************/
+#include "SimdPairKernel.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+//The vector code is compiled with function level target attributes, so the
+//rest of GOMC does not need -mavx2 and the kernel is only entered after
+//DetectIsa found the instructions on the running CPU.
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(__INTEL_COMPILER) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define GOMC_SIMD_X86
+#include <immintrin.h>
+#endif
+
+namespace simd
+{
+
+void CellAtoms::Resize(const uint n, const bool single)
+{
+  //room for one full AVX-512 float vector past the last atom
+  const uint padded = n + 16;
+  if(single) {
+    xf.assign(padded, 0.0f);
+    yf.assign(padded, 0.0f);
+    zf.assign(padded, 0.0f);
+    chargef.assign(padded, 0.0f);
+  } else {
+    x.assign(padded, 0.0);
+    y.assign(padded, 0.0);
+    z.assign(padded, 0.0);
+    charge.assign(padded, 0.0);
+  }
+  kind.assign(padded, 0);
+  mol.assign(padded, -1);
+  atom.assign(padded, -1);
+}
+
+void PairParams::FillSingle()
+{
+  sigmaSqF.assign(sigmaSq.begin(), sigmaSq.end());
+  epsilon_cnF.assign(epsilon_cn.begin(), epsilon_cn.end());
+  shiftConstF.assign(shiftConst.begin(), shiftConst.end());
+}
+
+#ifdef GOMC_SIMD_X86
+
+namespace avx2
+{
+#define SIMD_TARGET __attribute__((target("avx2,fma")))
+const int WIDTH = 4;
+typedef __m256d vdouble;
+typedef __m256d vmask;
+typedef __m128i vindex;
+typedef __m256i vlong;
+
+SIMD_TARGET static inline vdouble Zero()
+{
+  return _mm256_setzero_pd();
+}
+SIMD_TARGET static inline vdouble Set1(const double a)
+{
+  return _mm256_set1_pd(a);
+}
+SIMD_TARGET static inline vdouble Load(const double *p)
+{
+  return _mm256_loadu_pd(p);
+}
+SIMD_TARGET static inline void Store(double *p, const vdouble a)
+{
+  _mm256_storeu_pd(p, a);
+}
+SIMD_TARGET static inline vdouble Add(const vdouble a, const vdouble b)
+{
+  return _mm256_add_pd(a, b);
+}
+SIMD_TARGET static inline vdouble Sub(const vdouble a, const vdouble b)
+{
+  return _mm256_sub_pd(a, b);
+}
+SIMD_TARGET static inline vdouble Mul(const vdouble a, const vdouble b)
+{
+  return _mm256_mul_pd(a, b);
+}
+SIMD_TARGET static inline vdouble Div(const vdouble a, const vdouble b)
+{
+  return _mm256_div_pd(a, b);
+}
+SIMD_TARGET static inline vdouble Sqrt(const vdouble a)
+{
+  return _mm256_sqrt_pd(a);
+}
+SIMD_TARGET static inline vdouble Round(const vdouble a)
+{
+  return _mm256_round_pd(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+}
+SIMD_TARGET static inline vdouble Max(const vdouble a, const vdouble b)
+{
+  return _mm256_max_pd(a, b);
+}
+SIMD_TARGET static inline vdouble Min(const vdouble a, const vdouble b)
+{
+  return _mm256_min_pd(a, b);
+}
+SIMD_TARGET static inline vmask Less(const vdouble a, const vdouble b)
+{
+  return _mm256_cmp_pd(a, b, _CMP_LT_OQ);
+}
+SIMD_TARGET static inline vmask NotZero(const vdouble a)
+{
+  return _mm256_cmp_pd(a, _mm256_setzero_pd(), _CMP_NEQ_OQ);
+}
+SIMD_TARGET static inline vmask And(const vmask a, const vmask b)
+{
+  return _mm256_and_pd(a, b);
+}
+SIMD_TARGET static inline vmask AndNot(const vmask a, const vmask b)
+{
+  return _mm256_andnot_pd(b, a);
+}
+SIMD_TARGET static inline vdouble Select(const vmask m, const vdouble a)
+{
+  return _mm256_and_pd(m, a);
+}
+SIMD_TARGET static inline int Bits(const vmask m)
+{
+  return _mm256_movemask_pd(m);
+}
+//Lanes below n
+SIMD_TARGET static inline vmask FirstLanes(const int n)
+{
+  return _mm256_cmp_pd(_mm256_set_pd(3.0, 2.0, 1.0, 0.0),
+                       _mm256_set1_pd((double)n), _CMP_LT_OQ);
+}
+SIMD_TARGET static inline vmask IntGreater(const int *p, const int a)
+{
+  __m128i v = _mm_loadu_si128((const __m128i *)p);
+  __m128i cmp = _mm_cmpgt_epi32(v, _mm_set1_epi32(a));
+  return _mm256_castsi256_pd(_mm256_cvtepi32_epi64(cmp));
+}
+SIMD_TARGET static inline vmask IntEqual(const int *p, const int a)
+{
+  __m128i v = _mm_loadu_si128((const __m128i *)p);
+  __m128i cmp = _mm_cmpeq_epi32(v, _mm_set1_epi32(a));
+  return _mm256_castsi256_pd(_mm256_cvtepi32_epi64(cmp));
+}
+SIMD_TARGET static inline vindex PairIndex(const int kind1, const int *kind2,
+                                           const int count)
+{
+  __m128i v = _mm_loadu_si128((const __m128i *)kind2);
+  return _mm_add_epi32(_mm_set1_epi32(kind1),
+                       _mm_mullo_epi32(v, _mm_set1_epi32(count)));
+}
+SIMD_TARGET static inline vdouble Gather(const double *base, const vindex i)
+{
+  return _mm256_i32gather_pd(base, i, 8);
+}
+//Offset of the EwaldRealTable coefficients for r^2 = s
+SIMD_TARGET static inline vlong TableIndex(const vdouble s, const int shift,
+                                           const uint64_t base)
+{
+  __m256i i = _mm256_srl_epi64(_mm256_castpd_si256(s),
+                               _mm_cvtsi32_si128(shift));
+  i = _mm256_sub_epi64(i, _mm256_set1_epi64x((long long)base));
+  return _mm256_slli_epi64(i, 2);
+}
+//Start of the EwaldRealTable interval of r^2 = s
+SIMD_TARGET static inline vdouble TableFloor(const vdouble s,
+                                             const uint64_t mask)
+{
+  return _mm256_and_pd(s, _mm256_castsi256_pd(
+                         _mm256_set1_epi64x((long long)mask)));
+}
+SIMD_TARGET static inline vdouble GatherLong(const double *base,
+                                             const vlong i)
+{
+  return _mm256_i64gather_pd(base, i, 8);
+}
+SIMD_TARGET static inline double Sum(const vdouble a)
+{
+  __m128d s = _mm_add_pd(_mm256_castpd256_pd128(a),
+                         _mm256_extractf128_pd(a, 1));
+  return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+}
+
+//Single precision helpers of the mixed precision kernel
+const int WIDTHF = 8;
+typedef __m256 vfloat;
+typedef __m256 fmask;
+typedef __m256i vindexf;
+
+SIMD_TARGET static inline vfloat Set1F(const float a)
+{
+  return _mm256_set1_ps(a);
+}
+SIMD_TARGET static inline vfloat LoadF(const float *p)
+{
+  return _mm256_loadu_ps(p);
+}
+SIMD_TARGET static inline vfloat Add(const vfloat a, const vfloat b)
+{
+  return _mm256_add_ps(a, b);
+}
+SIMD_TARGET static inline vfloat Sub(const vfloat a, const vfloat b)
+{
+  return _mm256_sub_ps(a, b);
+}
+SIMD_TARGET static inline vfloat Mul(const vfloat a, const vfloat b)
+{
+  return _mm256_mul_ps(a, b);
+}
+SIMD_TARGET static inline vfloat Div(const vfloat a, const vfloat b)
+{
+  return _mm256_div_ps(a, b);
+}
+SIMD_TARGET static inline vfloat Sqrt(const vfloat a)
+{
+  return _mm256_sqrt_ps(a);
+}
+SIMD_TARGET static inline vfloat Round(const vfloat a)
+{
+  return _mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+}
+SIMD_TARGET static inline vfloat Max(const vfloat a, const vfloat b)
+{
+  return _mm256_max_ps(a, b);
+}
+SIMD_TARGET static inline vfloat Min(const vfloat a, const vfloat b)
+{
+  return _mm256_min_ps(a, b);
+}
+SIMD_TARGET static inline fmask LessF(const vfloat a, const vfloat b)
+{
+  return _mm256_cmp_ps(a, b, _CMP_LT_OQ);
+}
+SIMD_TARGET static inline fmask NotZeroF(const vfloat a)
+{
+  return _mm256_cmp_ps(a, _mm256_setzero_ps(), _CMP_NEQ_OQ);
+}
+SIMD_TARGET static inline fmask AndF(const fmask a, const fmask b)
+{
+  return _mm256_and_ps(a, b);
+}
+SIMD_TARGET static inline fmask AndNotF(const fmask a, const fmask b)
+{
+  return _mm256_andnot_ps(b, a);
+}
+SIMD_TARGET static inline vfloat SelectF(const fmask m, const vfloat a)
+{
+  return _mm256_and_ps(m, a);
+}
+SIMD_TARGET static inline int BitsF(const fmask m)
+{
+  return _mm256_movemask_ps(m);
+}
+SIMD_TARGET static inline fmask FirstLanesF(const int n)
+{
+  return _mm256_cmp_ps(_mm256_set_ps(7.0f, 6.0f, 5.0f, 4.0f, 3.0f, 2.0f,
+                                     1.0f, 0.0f),
+                       _mm256_set1_ps((float)n), _CMP_LT_OQ);
+}
+SIMD_TARGET static inline fmask IntGreaterF(const int *p, const int a)
+{
+  __m256i v = _mm256_loadu_si256((const __m256i *)p);
+  return _mm256_castsi256_ps(_mm256_cmpgt_epi32(v, _mm256_set1_epi32(a)));
+}
+SIMD_TARGET static inline fmask IntEqualF(const int *p, const int a)
+{
+  __m256i v = _mm256_loadu_si256((const __m256i *)p);
+  return _mm256_castsi256_ps(_mm256_cmpeq_epi32(v, _mm256_set1_epi32(a)));
+}
+SIMD_TARGET static inline vindexf PairIndexF(const int kind1, const int *kind2,
+                                             const int count)
+{
+  __m256i v = _mm256_loadu_si256((const __m256i *)kind2);
+  return _mm256_add_epi32(_mm256_set1_epi32(kind1),
+                          _mm256_mullo_epi32(v, _mm256_set1_epi32(count)));
+}
+SIMD_TARGET static inline vfloat GatherF(const float *base, const vindexf i)
+{
+  return _mm256_i32gather_ps(base, i, 4);
+}
+//2^n for integral n in the normal float range
+SIMD_TARGET static inline vfloat Pow2F(const vfloat n)
+{
+  __m256i e = _mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127));
+  return _mm256_castsi256_ps(_mm256_slli_epi32(e, 23));
+}
+//Adds the float lanes of a to the double sum
+SIMD_TARGET static inline void AccumulateF(vdouble &sum, const vfloat a)
+{
+  sum = Add(sum, _mm256_cvtps_pd(_mm256_castps256_ps128(a)));
+  sum = Add(sum, _mm256_cvtps_pd(_mm256_extractf128_ps(a, 1)));
+}
+
+#include "SimdPairKernelBody.h"
+#undef SIMD_TARGET
+}
+
+namespace avx512
+{
+#define SIMD_TARGET __attribute__((target("avx512f,avx2,fma")))
+const int WIDTH = 8;
+typedef __m512d vdouble;
+typedef __mmask8 vmask;
+typedef __m256i vindex;
+typedef __m512i vlong;
+
+SIMD_TARGET static inline vdouble Zero()
+{
+  return _mm512_setzero_pd();
+}
+SIMD_TARGET static inline vdouble Set1(const double a)
+{
+  return _mm512_set1_pd(a);
+}
+SIMD_TARGET static inline vdouble Load(const double *p)
+{
+  return _mm512_loadu_pd(p);
+}
+SIMD_TARGET static inline void Store(double *p, const vdouble a)
+{
+  _mm512_storeu_pd(p, a);
+}
+SIMD_TARGET static inline vdouble Add(const vdouble a, const vdouble b)
+{
+  return _mm512_add_pd(a, b);
+}
+SIMD_TARGET static inline vdouble Sub(const vdouble a, const vdouble b)
+{
+  return _mm512_sub_pd(a, b);
+}
+SIMD_TARGET static inline vdouble Mul(const vdouble a, const vdouble b)
+{
+  return _mm512_mul_pd(a, b);
+}
+SIMD_TARGET static inline vdouble Div(const vdouble a, const vdouble b)
+{
+  return _mm512_div_pd(a, b);
+}
+SIMD_TARGET static inline vdouble Sqrt(const vdouble a)
+{
+  return _mm512_sqrt_pd(a);
+}
+SIMD_TARGET static inline vdouble Round(const vdouble a)
+{
+  return _mm512_roundscale_pd(a, _MM_FROUND_TO_NEAREST_INT |
+                              _MM_FROUND_NO_EXC);
+}
+SIMD_TARGET static inline vdouble Max(const vdouble a, const vdouble b)
+{
+  return _mm512_max_pd(a, b);
+}
+SIMD_TARGET static inline vdouble Min(const vdouble a, const vdouble b)
+{
+  return _mm512_min_pd(a, b);
+}
+SIMD_TARGET static inline vmask Less(const vdouble a, const vdouble b)
+{
+  return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ);
+}
+SIMD_TARGET static inline vmask NotZero(const vdouble a)
+{
+  return _mm512_cmp_pd_mask(a, _mm512_setzero_pd(), _CMP_NEQ_OQ);
+}
+SIMD_TARGET static inline vmask And(const vmask a, const vmask b)
+{
+  return a & b;
+}
+SIMD_TARGET static inline vmask AndNot(const vmask a, const vmask b)
+{
+  return a & ~b;
+}
+SIMD_TARGET static inline vdouble Select(const vmask m, const vdouble a)
+{
+  return _mm512_maskz_mov_pd(m, a);
+}
+SIMD_TARGET static inline int Bits(const vmask m)
+{
+  return (int)m;
+}
+SIMD_TARGET static inline vmask FirstLanes(const int n)
+{
+  return (vmask)(n >= WIDTH ? 0xFF : (1 << n) - 1);
+}
+SIMD_TARGET static inline vmask IntGreater(const int *p, const int a)
+{
+  __m256i v = _mm256_loadu_si256((const __m256i *)p);
+  __m256i cmp = _mm256_cmpgt_epi32(v, _mm256_set1_epi32(a));
+  return (vmask)_mm256_movemask_ps(_mm256_castsi256_ps(cmp));
+}
+SIMD_TARGET static inline vmask IntEqual(const int *p, const int a)
+{
+  __m256i v = _mm256_loadu_si256((const __m256i *)p);
+  __m256i cmp = _mm256_cmpeq_epi32(v, _mm256_set1_epi32(a));
+  return (vmask)_mm256_movemask_ps(_mm256_castsi256_ps(cmp));
+}
+SIMD_TARGET static inline vindex PairIndex(const int kind1, const int *kind2,
+                                           const int count)
+{
+  __m256i v = _mm256_loadu_si256((const __m256i *)kind2);
+  return _mm256_add_epi32(_mm256_set1_epi32(kind1),
+                          _mm256_mullo_epi32(v, _mm256_set1_epi32(count)));
+}
+SIMD_TARGET static inline vdouble Gather(const double *base, const vindex i)
+{
+  return _mm512_i32gather_pd(i, base, 8);
+}
+SIMD_TARGET static inline vlong TableIndex(const vdouble s, const int shift,
+                                           const uint64_t base)
+{
+  __m512i i = _mm512_srl_epi64(_mm512_castpd_si512(s),
+                               _mm_cvtsi32_si128(shift));
+  i = _mm512_sub_epi64(i, _mm512_set1_epi64((long long)base));
+  return _mm512_slli_epi64(i, 2);
+}
+SIMD_TARGET static inline vdouble TableFloor(const vdouble s,
+                                             const uint64_t mask)
+{
+  return _mm512_castsi512_pd(_mm512_and_si512(_mm512_castpd_si512(s),
+                             _mm512_set1_epi64((long long)mask)));
+}
+SIMD_TARGET static inline vdouble GatherLong(const double *base,
+                                             const vlong i)
+{
+  return _mm512_i64gather_pd(i, base, 8);
+}
+SIMD_TARGET static inline double Sum(const vdouble a)
+{
+  return _mm512_reduce_add_pd(a);
+}
+
+//Single precision helpers of the mixed precision kernel
+const int WIDTHF = 16;
+typedef __m512 vfloat;
+typedef __mmask16 fmask;
+typedef __m512i vindexf;
+
+SIMD_TARGET static inline vfloat Set1F(const float a)
+{
+  return _mm512_set1_ps(a);
+}
+SIMD_TARGET static inline vfloat LoadF(const float *p)
+{
+  return _mm512_loadu_ps(p);
+}
+SIMD_TARGET static inline vfloat Add(const vfloat a, const vfloat b)
+{
+  return _mm512_add_ps(a, b);
+}
+SIMD_TARGET static inline vfloat Sub(const vfloat a, const vfloat b)
+{
+  return _mm512_sub_ps(a, b);
+}
+SIMD_TARGET static inline vfloat Mul(const vfloat a, const vfloat b)
+{
+  return _mm512_mul_ps(a, b);
+}
+SIMD_TARGET static inline vfloat Div(const vfloat a, const vfloat b)
+{
+  return _mm512_div_ps(a, b);
+}
+SIMD_TARGET static inline vfloat Sqrt(const vfloat a)
+{
+  return _mm512_sqrt_ps(a);
+}
+SIMD_TARGET static inline vfloat Round(const vfloat a)
+{
+  return _mm512_roundscale_ps(a, _MM_FROUND_TO_NEAREST_INT |
+                              _MM_FROUND_NO_EXC);
+}
+SIMD_TARGET static inline vfloat Max(const vfloat a, const vfloat b)
+{
+  return _mm512_max_ps(a, b);
+}
+SIMD_TARGET static inline vfloat Min(const vfloat a, const vfloat b)
+{
+  return _mm512_min_ps(a, b);
+}
+SIMD_TARGET static inline fmask LessF(const vfloat a, const vfloat b)
+{
+  return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ);
+}
+SIMD_TARGET static inline fmask NotZeroF(const vfloat a)
+{
+  return _mm512_cmp_ps_mask(a, _mm512_setzero_ps(), _CMP_NEQ_OQ);
+}
+SIMD_TARGET static inline fmask AndF(const fmask a, const fmask b)
+{
+  return a & b;
+}
+SIMD_TARGET static inline fmask AndNotF(const fmask a, const fmask b)
+{
+  return a & ~b;
+}
+SIMD_TARGET static inline vfloat SelectF(const fmask m, const vfloat a)
+{
+  return _mm512_maskz_mov_ps(m, a);
+}
+SIMD_TARGET static inline int BitsF(const fmask m)
+{
+  return (int)m;
+}
+SIMD_TARGET static inline fmask FirstLanesF(const int n)
+{
+  return (fmask)(n >= WIDTHF ? 0xFFFF : (1 << n) - 1);
+}
+SIMD_TARGET static inline fmask IntGreaterF(const int *p, const int a)
+{
+  __m512i v = _mm512_loadu_si512((const void *)p);
+  return _mm512_cmpgt_epi32_mask(v, _mm512_set1_epi32(a));
+}
+SIMD_TARGET static inline fmask IntEqualF(const int *p, const int a)
+{
+  __m512i v = _mm512_loadu_si512((const void *)p);
+  return _mm512_cmpeq_epi32_mask(v, _mm512_set1_epi32(a));
+}
+SIMD_TARGET static inline vindexf PairIndexF(const int kind1, const int *kind2,
+                                             const int count)
+{
+  __m512i v = _mm512_loadu_si512((const void *)kind2);
+  return _mm512_add_epi32(_mm512_set1_epi32(kind1),
+                          _mm512_mullo_epi32(v, _mm512_set1_epi32(count)));
+}
+SIMD_TARGET static inline vfloat GatherF(const float *base, const vindexf i)
+{
+  return _mm512_i32gather_ps(i, base, 4);
+}
+SIMD_TARGET static inline vfloat Pow2F(const vfloat n)
+{
+  __m512i e = _mm512_add_epi32(_mm512_cvtps_epi32(n), _mm512_set1_epi32(127));
+  return _mm512_castsi512_ps(_mm512_slli_epi32(e, 23));
+}
+SIMD_TARGET static inline void AccumulateF(vdouble &sum, const vfloat a)
+{
+  sum = Add(sum, _mm512_cvtps_pd(_mm512_castps512_ps256(a)));
+  sum = Add(sum, _mm512_cvtps_pd(_mm256_castpd_ps(
+                                   _mm512_extractf64x4_pd(_mm512_castps_pd(a), 1))));
+}
+
+#include "SimdPairKernelBody.h"
+#undef SIMD_TARGET
+}
+
+#endif /*GOMC_SIMD_X86*/
+
+Isa DetectIsa()
+{
+#ifdef GOMC_SIMD_X86
+  __builtin_cpu_init();
+  if(__builtin_cpu_supports("avx512f"))
+    return ISA_AVX512;
+  if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    return ISA_AVX2;
+#endif
+  return ISA_NONE;
+}
+
+const char* IsaName(const Isa isa)
+{
+  switch(isa) {
+  case ISA_AVX512:
+    return "AVX-512";
+  case ISA_AVX2:
+    return "AVX2";
+  default:
+    return "None";
+  }
+}
+
+void RowEnergy(const Isa isa, CellAtoms const& atoms, PairParams const& par,
+               BoxParams const& box, const int p, const int *cells,
+               const int nCells, const int *cellStart, const int skipMol,
+               double &realEn, double &ljEn)
+{
+#ifdef GOMC_SIMD_X86
+  if(isa == ISA_AVX512) {
+    avx512::Row<false>(atoms, par, box, p, cells, nCells, cellStart, skipMol,
+                       realEn, ljEn, NULL, NULL, NULL, NULL, NULL, NULL);
+    return;
+  } else if(isa == ISA_AVX2) {
+    avx2::Row<false>(atoms, par, box, p, cells, nCells, cellStart, skipMol,
+                     realEn, ljEn, NULL, NULL, NULL, NULL, NULL, NULL);
+    return;
+  }
+#endif
+  printf("Error: SIMD pair kernel called without a supported instruction set!\n");
+  exit(EXIT_FAILURE);
+}
+
+void RowForce(const Isa isa, CellAtoms const& atoms, PairParams const& par,
+              BoxParams const& box, const int p, const int *cells,
+              const int nCells, const int *cellStart, const int skipMol,
+              double &realEn, double &ljEn, double *aForcex, double *aForcey,
+              double *aForcez, double *mForcex, double *mForcey,
+              double *mForcez)
+{
+#ifdef GOMC_SIMD_X86
+  if(isa == ISA_AVX512) {
+    avx512::Row<true>(atoms, par, box, p, cells, nCells, cellStart, skipMol,
+                      realEn, ljEn, aForcex, aForcey, aForcez,
+                      mForcex, mForcey, mForcez);
+    return;
+  } else if(isa == ISA_AVX2) {
+    avx2::Row<true>(atoms, par, box, p, cells, nCells, cellStart, skipMol,
+                    realEn, ljEn, aForcex, aForcey, aForcez,
+                    mForcex, mForcey, mForcez);
+    return;
+  }
+#endif
+  printf("Error: SIMD pair kernel called without a supported instruction set!\n");
+  exit(EXIT_FAILURE);
+}
+
+void RowEnergyMixed(const Isa isa, CellAtoms const& atoms,
+                    PairParams const& par, BoxParams const& box, const int p,
+                    const int *cells, const int nCells, const int *cellStart,
+                    const int skipMol, double &realEn, double &ljEn)
+{
+#ifdef GOMC_SIMD_X86
+  if(isa == ISA_AVX512) {
+    avx512::RowMixed(atoms, par, box, p, cells, nCells, cellStart, skipMol,
+                     realEn, ljEn);
+    return;
+  } else if(isa == ISA_AVX2) {
+    avx2::RowMixed(atoms, par, box, p, cells, nCells, cellStart, skipMol,
+                   realEn, ljEn);
+    return;
+  }
+#endif
+  printf("Error: SIMD pair kernel called without a supported instruction set!\n");
+  exit(EXIT_FAILURE);
+}
+
+}
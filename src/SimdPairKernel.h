@@ -0,0 +1,94 @@
+/*******************************************************************************
+GPU OPTIMIZED MONTE CARLO (GOMC) 2.75
+Copyright (C) 2022 GOMC Group
+A copy of the MIT License can be found in License.txt
+along with this program, also can be found at <https://opensource.org/licenses/MIT>.
+********************************************************************************/
+#ifndef SIMD_PAIR_KERNEL_H
+#define SIMD_PAIR_KERNEL_H
+
+#include "BasicTypes.h" //For uint
+#include <stdint.h>
+#include <vector>
+
+//Vectorized inner loop of the box pair sums (BoxInter and BoxForce). The
+//particle data is copied in cell order, so the atoms of a neighbor cell are
+//contiguous and can be loaded 4 (AVX2) or 8 (AVX-512) at a time. The cutoff,
+//duplicate pairs and pairs in the same molecule are handled with lane masks.
+//Only orthogonal boxes and 12-6 LJ (plain or shifted) have a vector form,
+//everything else keeps using the scalar kernels in CalculateEnergy. The
+//mixed precision energy kernel does the same work on single precision
+//coordinates and parameters, twice as many pairs per vector, and sums the
+//pair energies in double.
+namespace simd
+{
+enum Isa {ISA_NONE, ISA_AVX2, ISA_AVX512};
+
+//Widest instruction set that the CPU and the compiler both support
+Isa DetectIsa();
+const char* IsaName(const Isa isa);
+
+//12-6 parameters for each kind pair, indexed kind1 + kind2 * count as in
+//FFParticle, plus how the real space Coulomb term is computed.
+struct PairParams {
+  std::vector<double> sigmaSq, epsilon_cn, epsilon_cn_6, shiftConst;
+  uint count;
+  bool electrostatic, ewald;
+  bool wolf;            //Wolf / DSF terms added to the damped Coulomb
+  double coulombShift;  //1/rCut for the shifted Coulomb, otherwise zero
+  double qqFact;
+  //single precision copies for RowEnergyMixed, see FillSingle
+  std::vector<float> sigmaSqF, epsilon_cnF, shiftConstF;
+  void FillSingle();
+};
+
+//Orthogonal box lengths and cutoffs of one box, and the Ewald real space
+//table of the box (see EwaldRealTable) or NULL tableEn if it is not used
+struct BoxParams {
+  double axis[3], axisInv[3];
+  double rCutSq, rCutCoulombSq, alpha, alphaSq;
+  double rCutCoulomb, wolfShift, wolfForceShift;
+  const double *tableEn, *tableVir;
+  double tableStart, tableEnd;
+  int tableShift;
+  uint64_t tableBase, tableMask;
+};
+
+//Particle data of one box in cell order (the order of cellVector). The
+//arrays are padded so full vectors can be loaded at the end of a cell. With
+//single only the float coordinates and charges are allocated.
+struct CellAtoms {
+  std::vector<double> x, y, z, charge;
+  std::vector<float> xf, yf, zf, chargef;
+  std::vector<int> kind, mol, atom;
+  void Resize(const uint n, const bool single = false);
+};
+
+//Adds the energy of the atom at cell position p with the atoms of the given
+//neighbor cells. Only pairs with a larger atom index, in another molecule and
+//not involving skipMol (the fractional molecule, or -1) are counted.
+void RowEnergy(const Isa isa, CellAtoms const& atoms, PairParams const& par,
+               BoxParams const& box, const int p, const int *cells,
+               const int nCells, const int *cellStart, const int skipMol,
+               double &realEn, double &ljEn);
+
+//Same as RowEnergy, and also adds the pair forces to the atom and molecule
+//force arrays (indexed by global atom and molecule index).
+void RowForce(const Isa isa, CellAtoms const& atoms, PairParams const& par,
+              BoxParams const& box, const int p, const int *cells,
+              const int nCells, const int *cellStart, const int skipMol,
+              double &realEn, double &ljEn, double *aForcex, double *aForcey,
+              double *aForcez, double *mForcex, double *mForcey,
+              double *mForcez);
+
+//Same pairs as RowEnergy, from the single precision arrays of atoms and par.
+//Distances and pair energies are computed in float, the sums in double. The
+//Ewald real space term uses a vector erfc with 1e-7 relative error instead
+//of the EwaldRealTable.
+void RowEnergyMixed(const Isa isa, CellAtoms const& atoms,
+                    PairParams const& par, BoxParams const& box, const int p,
+                    const int *cells, const int nCells, const int *cellStart,
+                    const int skipMol, double &realEn, double &ljEn);
+}
+
+#endif /*SIMD_PAIR_KERNEL_H*/
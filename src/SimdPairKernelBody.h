@@ -0,0 +1,352 @@
+/*******************************************************************************
+GPU OPTIMIZED MONTE CARLO (GOMC) 2.75
+Copyright (C) 2022 GOMC Group
+A copy of the MIT License can be found in License.txt
+along with this program, also can be found at <https://opensource.org/licenses/MIT>.
+********************************************************************************/
+//Body of the vectorized row kernel. There is no include guard on purpose:
+//SimdPairKernel.cpp includes this file once per instruction set, inside a
+//namespace that defines SIMD_TARGET, WIDTH, vdouble, vmask, vindex and the
+//vector helpers (Load, Add, Less, Gather, ...), and for the mixed precision
+//kernel WIDTHF, vfloat, fmask, vindexf and the float helpers (LoadF, LessF,
+//GatherF, ...).
+
+//Cubic spline of EwaldRealTable at offsets idx, d from the interval start
+SIMD_TARGET static inline vdouble Spline(const double *c, const vlong idx,
+                                         const vdouble d)
+{
+  vdouble val = GatherLong(c + 3, idx);
+  val = Add(GatherLong(c + 2, idx), Mul(d, val));
+  val = Add(GatherLong(c + 1, idx), Mul(d, val));
+  return Add(GatherLong(c, idx), Mul(d, val));
+}
+
+//Energy (and with FORCE the pair forces) of the atom at cell position p with
+//the atoms of the neighbor cells. See simd::RowEnergy and simd::RowForce.
+template <bool FORCE>
+SIMD_TARGET static void Row(CellAtoms const& atoms, PairParams const& par,
+                            BoxParams const& box, const int p,
+                            const int *cells, const int nCells,
+                            const int *cellStart, const int skipMol,
+                            double &realEn, double &ljEn,
+                            double *aForcex, double *aForcey, double *aForcez,
+                            double *mForcex, double *mForcey, double *mForcez)
+{
+  const double *x = &atoms.x[0], *y = &atoms.y[0], *z = &atoms.z[0];
+  const double *charge = &atoms.charge[0];
+  const int *kind = &atoms.kind[0], *mol = &atoms.mol[0];
+  const int *atom = &atoms.atom[0];
+  const int atomI = atom[p], molI = mol[p], kindI = kind[p];
+  const double qi = charge[p];
+  const bool doCoulomb = par.electrostatic && qi != 0.0;
+
+  const vdouble xi = Set1(x[p]), yi = Set1(y[p]), zi = Set1(z[p]);
+  const vdouble axX = Set1(box.axis[0]), axY = Set1(box.axis[1]);
+  const vdouble axZ = Set1(box.axis[2]);
+  const vdouble invX = Set1(box.axisInv[0]), invY = Set1(box.axisInv[1]);
+  const vdouble invZ = Set1(box.axisInv[2]);
+  const vdouble rCutSq = Set1(box.rCutSq);
+  const vdouble rCutCoulombSq = Set1(box.rCutCoulombSq);
+  const vdouble two = Set1(2.0), one = Set1(1.0);
+  const vdouble qiFact = Set1(qi);
+  const vdouble qqFact = Set1(par.qqFact);
+  const vdouble alpha = Set1(box.alpha);
+  const vdouble coulombShift = Set1(par.coulombShift);
+  const vdouble rCutCoulomb = Set1(box.rCutCoulomb);
+  const vdouble wolfShift = Set1(box.wolfShift);
+  const vdouble wolfForceShift = Set1(box.wolfForceShift);
+  //2 * alpha / sqrt(PI), for the Ewald real space virial
+  const double expCoef = box.alpha * M_2_SQRTPI;
+  const bool useTable = par.ewald && box.tableEn != NULL;
+  const vdouble tableStart = Set1(box.tableStart);
+  const vdouble tableEnd = Set1(box.tableEnd);
+
+  vdouble sumLJ = Zero(), sumReal = Zero();
+  vdouble fxI = Zero(), fyI = Zero(), fzI = Zero();
+  double lane[WIDTH] __attribute__((aligned(64)));
+  double laneExp[WIDTH] __attribute__((aligned(64)));
+  double laneSq[WIDTH] __attribute__((aligned(64)));
+  double laneQq[WIDTH] __attribute__((aligned(64)));
+  double fx[WIDTH] __attribute__((aligned(64)));
+  double fy[WIDTH] __attribute__((aligned(64)));
+  double fz[WIDTH] __attribute__((aligned(64)));
+
+  for(int c = 0; c < nCells; c++) {
+    const int end = cellStart[cells[c] + 1];
+    for(int j = cellStart[cells[c]]; j < end; j += WIDTH) {
+      //unique pairs of atoms in different molecules, no fractional molecule
+      vmask m = And(FirstLanes(end - j), IntGreater(atom + j, atomI));
+      m = AndNot(m, IntEqual(mol + j, molI));
+      m = AndNot(m, IntEqual(mol + j, skipMol));
+      if(!Bits(m))
+        continue;
+
+      //branch free minimum image for the orthogonal box
+      vdouble dx = Sub(xi, Load(x + j));
+      vdouble dy = Sub(yi, Load(y + j));
+      vdouble dz = Sub(zi, Load(z + j));
+      dx = Sub(dx, Mul(axX, Round(Mul(dx, invX))));
+      dy = Sub(dy, Mul(axY, Round(Mul(dy, invY))));
+      dz = Sub(dz, Mul(axZ, Round(Mul(dz, invZ))));
+      vdouble distSq = Add(Add(Mul(dx, dx), Mul(dy, dy)), Mul(dz, dz));
+      m = And(m, Less(distSq, rCutSq));
+      if(!Bits(m))
+        continue;
+
+      //12-6 LJ
+      vindex index = PairIndex(kindI, kind + j, par.count);
+      vdouble rRat2 = Div(Gather(&par.sigmaSq[0], index), distSq);
+      vdouble attract = Mul(Mul(rRat2, rRat2), rRat2);
+      vdouble repulse = Mul(attract, attract);
+      vdouble en = Sub(Mul(Gather(&par.epsilon_cn[0], index),
+                           Sub(repulse, attract)),
+                       Gather(&par.shiftConst[0], index));
+      sumLJ = Add(sumLJ, Select(m, en));
+      vdouble vir;
+      if(FORCE) {
+        //epsilon_cn_6 * (n/6 * repulse - attract) / r^2 with n = 12
+        vir = Div(Mul(Gather(&par.epsilon_cn_6[0], index),
+                      Sub(Mul(two, repulse), attract)), distSq);
+        vir = Select(m, vir);
+      }
+
+      if(doCoulomb) {
+        vdouble qq = Mul(Mul(qiFact, Load(charge + j)), qqFact);
+        vmask mc = And(m, And(NotZero(qq), Less(distSq, rCutCoulombSq)));
+        int bits = Bits(mc);
+        if(bits) {
+          vdouble real, virReal;
+          if(useTable) {
+            //clamp so lanes outside the table still read valid entries
+            vdouble s = Min(Max(distSq, tableStart), tableEnd);
+            vlong idx = TableIndex(s, box.tableShift, box.tableBase);
+            vdouble d = Sub(s, TableFloor(s, box.tableMask));
+            real = Mul(qq, Spline(box.tableEn, idx, d));
+            if(FORCE)
+              virReal = Mul(qq, Spline(box.tableVir, idx, d));
+            //below the table start erfc is evaluated for the lane
+            int low = Bits(And(mc, Less(distSq, tableStart)));
+            if(low) {
+              Store(lane, real);
+              if(FORCE)
+                Store(laneExp, virReal);
+              Store(laneSq, distSq);
+              Store(laneQq, qq);
+              for(int k = 0; k < WIDTH; k++) {
+                if(low & (1 << k)) {
+                  double dist = sqrt(laneSq[k]);
+                  double en = erfc(box.alpha * dist) / dist;
+                  lane[k] = laneQq[k] * en;
+                  if(FORCE) {
+                    laneExp[k] = laneQq[k] * (en + expCoef *
+                                 exp(-box.alphaSq * laneSq[k])) / laneSq[k];
+                  }
+                }
+              }
+              real = Load(lane);
+              if(FORCE)
+                virReal = Load(laneExp);
+            }
+          } else {
+            vdouble dist = Sqrt(distSq);
+            if(par.ewald) {
+              //erfc has no vector form, evaluate it for the active lanes
+              Store(lane, Mul(alpha, dist));
+              for(int k = 0; k < WIDTH; k++) {
+                if(bits & (1 << k)) {
+                  if(FORCE)
+                    laneExp[k] = expCoef * exp(-lane[k] * lane[k]);
+                  lane[k] = erfc(lane[k]);
+                } else {
+                  lane[k] = 0.0;
+                  laneExp[k] = 0.0;
+                }
+              }
+              vdouble erfcVal = Load(lane);
+              real = Div(Mul(qq, erfcVal), dist);
+              if(FORCE) {
+                virReal = Div(Mul(qq, Add(Div(erfcVal, dist), Load(laneExp))),
+                              distSq);
+              }
+            } else {
+              real = Mul(qq, Sub(Div(one, dist), coulombShift));
+              if(FORCE)
+                virReal = Div(qq, Mul(distSq, dist));
+            }
+          }
+          if(par.wolf) {
+            vdouble dist = Sqrt(distSq);
+            vdouble shifted = Sub(Mul(wolfForceShift, Sub(dist, rCutCoulomb)),
+                                  wolfShift);
+            real = Add(real, Mul(qq, shifted));
+            if(FORCE)
+              virReal = Sub(virReal, Div(Mul(qq, wolfForceShift), dist));
+          }
+          sumReal = Add(sumReal, Select(mc, real));
+          if(FORCE)
+            vir = Add(vir, Select(mc, virReal));
+        }
+      }
+
+      if(FORCE) {
+        vdouble forceX = Mul(dx, vir);
+        vdouble forceY = Mul(dy, vir);
+        vdouble forceZ = Mul(dz, vir);
+        fxI = Add(fxI, forceX);
+        fyI = Add(fyI, forceY);
+        fzI = Add(fzI, forceZ);
+        Store(fx, forceX);
+        Store(fy, forceY);
+        Store(fz, forceZ);
+        int bits = Bits(m);
+        //lanes can share a molecule, so scatter one lane at a time
+        for(int k = 0; k < WIDTH; k++) {
+          if(bits & (1 << k)) {
+            int a = atom[j + k], mj = mol[j + k];
+            aForcex[a] -= fx[k];
+            aForcey[a] -= fy[k];
+            aForcez[a] -= fz[k];
+            mForcex[mj] -= fx[k];
+            mForcey[mj] -= fy[k];
+            mForcez[mj] -= fz[k];
+          }
+        }
+      }
+    }
+  }
+
+  realEn += Sum(sumReal);
+  ljEn += Sum(sumLJ);
+  if(FORCE) {
+    double sx = Sum(fxI), sy = Sum(fyI), sz = Sum(fzI);
+    aForcex[atomI] += sx;
+    aForcey[atomI] += sy;
+    aForcez[atomI] += sz;
+    mForcex[molI] += sx;
+    mForcey[molI] += sy;
+    mForcez[molI] += sz;
+  }
+}
+
+//e^x in single precision (Cephes expf): x = n ln2 + r with |r| <= ln2 / 2,
+//e^r from a degree 7 polynomial and 2^n from the exponent bits
+SIMD_TARGET static inline vfloat ExpF(vfloat x)
+{
+  x = Min(Max(x, Set1F(-87.3f)), Set1F(88.7f));
+  vfloat n = Round(Mul(x, Set1F(1.44269504088896341f)));
+  x = Sub(x, Mul(n, Set1F(0.693359375f)));
+  x = Sub(x, Mul(n, Set1F(-2.12194440e-4f)));
+  vfloat y = Set1F(1.9875691500e-4f);
+  y = Add(Mul(y, x), Set1F(1.3981999507e-3f));
+  y = Add(Mul(y, x), Set1F(8.3334519073e-3f));
+  y = Add(Mul(y, x), Set1F(4.1665795894e-2f));
+  y = Add(Mul(y, x), Set1F(1.6666665459e-1f));
+  y = Add(Mul(y, x), Set1F(5.0000001201e-1f));
+  y = Add(Add(Mul(Mul(y, x), x), x), Set1F(1.0f));
+  return Mul(y, Pow2F(n));
+}
+
+//erfc(z) for z >= 0 with 1.2e-7 relative error (Numerical Recipes erfcc)
+SIMD_TARGET static inline vfloat ErfcF(const vfloat z)
+{
+  const vfloat one = Set1F(1.0f);
+  vfloat t = Div(one, Add(one, Mul(Set1F(0.5f), z)));
+  vfloat p = Set1F(0.17087277f);
+  p = Add(Mul(p, t), Set1F(-0.82215223f));
+  p = Add(Mul(p, t), Set1F(1.48851587f));
+  p = Add(Mul(p, t), Set1F(-1.13520398f));
+  p = Add(Mul(p, t), Set1F(0.27886807f));
+  p = Add(Mul(p, t), Set1F(-0.18628806f));
+  p = Add(Mul(p, t), Set1F(0.09678418f));
+  p = Add(Mul(p, t), Set1F(0.37409196f));
+  p = Add(Mul(p, t), Set1F(1.00002368f));
+  p = Add(Mul(p, t), Set1F(-1.26551223f));
+  return Mul(t, ExpF(Sub(p, Mul(z, z))));
+}
+
+//Mixed precision energy of the atom at cell position p with the atoms of the
+//neighbor cells. See simd::RowEnergyMixed.
+SIMD_TARGET static void RowMixed(CellAtoms const& atoms, PairParams const& par,
+                                 BoxParams const& box, const int p,
+                                 const int *cells, const int nCells,
+                                 const int *cellStart, const int skipMol,
+                                 double &realEn, double &ljEn)
+{
+  const float *x = &atoms.xf[0], *y = &atoms.yf[0], *z = &atoms.zf[0];
+  const float *charge = &atoms.chargef[0];
+  const int *kind = &atoms.kind[0], *mol = &atoms.mol[0];
+  const int *atom = &atoms.atom[0];
+  const int atomI = atom[p], molI = mol[p], kindI = kind[p];
+  const bool doCoulomb = par.electrostatic && charge[p] != 0.0f;
+
+  const vfloat xi = Set1F(x[p]), yi = Set1F(y[p]), zi = Set1F(z[p]);
+  const vfloat axX = Set1F(box.axis[0]), axY = Set1F(box.axis[1]);
+  const vfloat axZ = Set1F(box.axis[2]);
+  const vfloat invX = Set1F(box.axisInv[0]), invY = Set1F(box.axisInv[1]);
+  const vfloat invZ = Set1F(box.axisInv[2]);
+  const vfloat rCutSq = Set1F(box.rCutSq);
+  const vfloat rCutCoulombSq = Set1F(box.rCutCoulombSq);
+  const vfloat one = Set1F(1.0f);
+  const vfloat qiFact = Set1F(charge[p] * par.qqFact);
+  const vfloat alpha = Set1F(box.alpha);
+  const vfloat coulombShift = Set1F(par.coulombShift);
+  const vfloat rCutCoulomb = Set1F(box.rCutCoulomb);
+  const vfloat wolfShift = Set1F(box.wolfShift);
+  const vfloat wolfForceShift = Set1F(box.wolfForceShift);
+
+  vdouble sumLJ = Zero(), sumReal = Zero();
+
+  for(int c = 0; c < nCells; c++) {
+    const int end = cellStart[cells[c] + 1];
+    for(int j = cellStart[cells[c]]; j < end; j += WIDTHF) {
+      //unique pairs of atoms in different molecules, no fractional molecule
+      fmask m = AndF(FirstLanesF(end - j), IntGreaterF(atom + j, atomI));
+      m = AndNotF(m, IntEqualF(mol + j, molI));
+      m = AndNotF(m, IntEqualF(mol + j, skipMol));
+      if(!BitsF(m))
+        continue;
+
+      vfloat dx = Sub(xi, LoadF(x + j));
+      vfloat dy = Sub(yi, LoadF(y + j));
+      vfloat dz = Sub(zi, LoadF(z + j));
+      dx = Sub(dx, Mul(axX, Round(Mul(dx, invX))));
+      dy = Sub(dy, Mul(axY, Round(Mul(dy, invY))));
+      dz = Sub(dz, Mul(axZ, Round(Mul(dz, invZ))));
+      vfloat distSq = Add(Add(Mul(dx, dx), Mul(dy, dy)), Mul(dz, dz));
+      m = AndF(m, LessF(distSq, rCutSq));
+      if(!BitsF(m))
+        continue;
+
+      //12-6 LJ
+      vindexf index = PairIndexF(kindI, kind + j, par.count);
+      vfloat rRat2 = Div(GatherF(&par.sigmaSqF[0], index), distSq);
+      vfloat attract = Mul(Mul(rRat2, rRat2), rRat2);
+      vfloat en = Sub(Mul(GatherF(&par.epsilon_cnF[0], index),
+                          Sub(Mul(attract, attract), attract)),
+                      GatherF(&par.shiftConstF[0], index));
+      AccumulateF(sumLJ, SelectF(m, en));
+
+      if(doCoulomb) {
+        vfloat qq = Mul(qiFact, LoadF(charge + j));
+        fmask mc = AndF(m, AndF(NotZeroF(qq), LessF(distSq, rCutCoulombSq)));
+        if(BitsF(mc)) {
+          vfloat dist = Sqrt(distSq);
+          vfloat real;
+          if(par.ewald)
+            real = Div(Mul(qq, ErfcF(Mul(alpha, dist))), dist);
+          else
+            real = Mul(qq, Sub(Div(one, dist), coulombShift));
+          if(par.wolf) {
+            vfloat shifted = Sub(Mul(wolfForceShift, Sub(dist, rCutCoulomb)),
+                                 wolfShift);
+            real = Add(real, Mul(qq, shifted));
+          }
+          AccumulateF(sumReal, SelectF(mc, real));
+        }
+      }
+    }
+  }
+
+  realEn += Sum(sumReal);
+  ljEn += Sum(sumLJ);
+}
@@ -104,6 +104,11 @@ void Simulation::RunSimulation(void)
       }
     }
 
+    if(staticValues->forcefield.mixedPrecision &&
+        (step + 1) % staticValues->forcefield.mixedPrecisionFreq == 0) {
+      RecalculateDouble();
+    }
+
 #if GOMC_LIB_MPI
     //
     if(staticValues->simEventFreq.parallelTemp && step > cpu->equilSteps && step % staticValues->simEventFreq.parallelTempFreq == 0) {
@@ -150,10 +155,21 @@ void Simulation::RunSimulation(void)
 #endif
 }
 
+void Simulation::RecalculateDouble(void)
+{
+  system->calcEnergy.SetMixedPrecision(false);
+  system->calcEwald->UpdateVectorsAndRecipTerms(false);
+  system->potential = system->calcEnergy.SystemTotal();
+  system->calcEnergy.SetMixedPrecision(true);
+}
+
 bool Simulation::RecalculateAndCheck(void)
 {
+  //Check against double precision energies
+  system->calcEnergy.SetMixedPrecision(false);
   system->calcEwald->UpdateVectorsAndRecipTerms(false);
   SystemPotential pot = system->calcEnergy.SystemTotal();
+  system->calcEnergy.SetMixedPrecision(staticValues->forcefield.mixedPrecision);
 
   bool compare = true;
   compare &= num::approximatelyEqual(system->potential.totalEnergy.intraBond, pot.totalEnergy.intraBond, EPSILON);
@@ -37,6 +37,10 @@ public:
     Molecules & GetMolecules();
   #endif
 private:
+  //! Recomputes the running energies and Ewald reference sums in double
+  //! precision, to bound the drift of the MixedPrecision engine
+  void RecalculateDouble(void);
+
   StaticVals * staticValues;
   System * system;
   CPUSide * cpu;
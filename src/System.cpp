@@ -8,6 +8,8 @@ along with this program, also can be found at <https://opensource.org/licenses/M
 #include "System.h"
 #include "CalculateEnergy.h"
 #include "EwaldCached.h"
+#include "EwaldSPME.h"
+#include "EwaldWolf.h"
 #include "Ewald.h"
 #include "NoEwald.h"
 #include "EnergyTypes.h"
@@ -137,7 +139,13 @@ void System::Init(Setup & set)
     calcEwald = new NoEwald(statV, *this);
 #else
   bool cached = set.config.sys.elect.cache;
-  if (ewald && cached)
+  bool spme = set.config.sys.elect.spme;
+  bool wolf = set.config.sys.elect.wolf;
+  if (ewald && wolf)
+    calcEwald = new EwaldWolf(statV, *this);
+  else if (ewald && spme)
+    calcEwald = new EwaldSPME(statV, *this);
+  else if (ewald && cached)
     calcEwald = new EwaldCached(statV, *this);
   else if (ewald && !cached)
     calcEwald = new Ewald(statV, *this);
@@ -318,6 +326,25 @@ void System::CalcEn(const uint kind)
 
 void System::Accept(const uint kind, const uint rejectState, const ulong step)
 {
+  //Displacement and rotation keep the energy ledger of calcEnergy exact,
+  //any other accepted move makes it stale. The nonequilibrium transfer runs
+  //displacements it may undo, so it always does.
+  if(calcEnergy.LedgerEnabled() && kind != mv::DISPLACE &&
+      kind != mv::ROTATE) {
+    uint accepted = 0;
+    for(uint b = 0; b < BOX_TOTAL; b++)
+      accepted += moveSettings.GetAcceptTot(b, kind);
+    moves[kind]->Accept(rejectState, step);
+    bool stale = false;
+#if ENSEMBLE == GEMC || ENSEMBLE == GCMC
+    stale = (kind == mv::NE_MTMC);
+#endif
+    for(uint b = 0; b < BOX_TOTAL; b++)
+      accepted -= moveSettings.GetAcceptTot(b, kind);
+    if(stale || accepted != 0)
+      calcEnergy.InvalidateLedger();
+    return;
+  }
   moves[kind]->Accept(rejectState, step);
 }
 
@@ -0,0 +1,156 @@
+/*******************************************************************************
+GPU OPTIMIZED MONTE CARLO (GOMC) 2.75
+Copyright (C) 2022 GOMC Group
+A copy of the MIT License can be found in License.txt
+along with this program, also can be found at <https://opensource.org/licenses/MIT>.
+********************************************************************************/
+#include "VerletList.h"
+#include <algorithm>
+#include <cmath>
+
+VerletList::VerletList() : skin(0.0)
+{
+  for(uint b = 0; b < BOX_TOTAL; b++) {
+    list[b].built = false;
+    list[b].builds = 0;
+  }
+}
+
+void VerletList::Init(const double skin)
+{
+  this->skin = skin;
+  for(uint b = 0; b < BOX_TOTAL; b++) {
+    Invalidate(b);
+  }
+}
+
+void VerletList::Update(XYZArray const& coords, BoxDimensions const& boxAxes,
+                        const uint b, std::vector<int> const& atoms,
+                        std::vector<int> const& particleMol)
+{
+  if(!IsValid(coords, boxAxes, b, atoms))
+    Build(coords, boxAxes, b, atoms, particleMol);
+}
+
+bool VerletList::IsValid(XYZArray const& coords, BoxDimensions const& boxAxes,
+                         const uint b, std::vector<int> const& atoms) const
+{
+  BoxList const& l = list[b];
+  if(!l.built || l.atoms != atoms)
+    return false;
+  XYZ axis = boxAxes.GetAxis(b);
+  if(axis.x != l.axis.x || axis.y != l.axis.y || axis.z != l.axis.z)
+    return false;
+
+  double maxMoveSq = 0.25 * skin * skin;
+  for(uint r = 0; r < atoms.size(); r++) {
+    XYZ move(coords.x[atoms[r]] - l.refX[r], coords.y[atoms[r]] - l.refY[r],
+             coords.z[atoms[r]] - l.refZ[r]);
+    //atoms wrapped through the box boundary did not really move
+    if(move.LengthSq() > maxMoveSq &&
+        boxAxes.MinImage(move, b).LengthSq() > maxMoveSq)
+      return false;
+  }
+  return true;
+}
+
+void VerletList::Build(XYZArray const& coords, BoxDimensions const& boxAxes,
+                       const uint b, std::vector<int> const& atoms,
+                       std::vector<int> const& particleMol)
+{
+  BoxList & l = list[b];
+  double listCut = boxAxes.rCut[b] + skin;
+  double listCutSq = listCut * listCut;
+  XYZ axis = boxAxes.GetAxis(b);
+
+  //Cells are made in the unslanted frame, like in CellList. Unslanted
+  //coordinate k changes by |grad u_k| per unit length, so the cells need
+  //to be listCut * |grad u_k| wide to be listCut thick in a slanted box.
+  XYZ gx = boxAxes.TransformUnSlant(XYZ(1.0, 0.0, 0.0), b);
+  XYZ gy = boxAxes.TransformUnSlant(XYZ(0.0, 1.0, 0.0), b);
+  XYZ gz = boxAxes.TransformUnSlant(XYZ(0.0, 0.0, 1.0), b);
+  double grad[3] = { XYZ(gx.x, gy.x, gz.x).Length(),
+                     XYZ(gx.y, gy.y, gz.y).Length(),
+                     XYZ(gx.z, gy.z, gz.z).Length()
+                   };
+  double side[3] = { axis.x, axis.y, axis.z };
+  int nCells[3];
+  double cellInv[3];
+  for(uint k = 0; k < 3; k++) {
+    nCells[k] = std::max((int)floor(side[k] / (listCut * grad[k])), 1);
+    cellInv[k] = nCells[k] / side[k];
+  }
+
+  //Bin the atoms of the box
+  l.head.assign(nCells[0] * nCells[1] * nCells[2], -1);
+  l.next.resize(atoms.size());
+  l.cell.resize(atoms.size());
+  for(uint r = 0; r < atoms.size(); r++) {
+    XYZ u = boxAxes.TransformUnSlant(coords.Get(atoms[r]), b);
+    double uk[3] = { u.x, u.y, u.z };
+    int c[3];
+    for(uint k = 0; k < 3; k++) {
+      c[k] = (int)floor(uk[k] * cellInv[k]) % nCells[k];
+      c[k] += (c[k] < 0 ? nCells[k] : 0);
+    }
+    int cell = (c[0] * nCells[1] + c[1]) * nCells[2] + c[2];
+    l.cell[r] = cell;
+    l.next[r] = l.head[cell];
+    l.head[cell] = r;
+  }
+
+  //Neighbor cell offsets, without repeats when there are fewer than three
+  //cells along an axis
+  std::vector<int> offsets[3];
+  for(uint k = 0; k < 3; k++) {
+    offsets[k].push_back(0);
+    if(nCells[k] > 1)
+      offsets[k].push_back(1);
+    if(nCells[k] > 2)
+      offsets[k].push_back(-1);
+  }
+
+  l.start.resize(atoms.size() + 1);
+  l.pairs.clear();
+  for(uint r = 0; r < atoms.size(); r++) {
+    l.start[r] = l.pairs.size();
+    int i = atoms[r];
+    int cell = l.cell[r];
+    int c[3] = { cell / (nCells[1] * nCells[2]),
+                 (cell / nCells[2]) % nCells[1],
+                 cell % nCells[2]
+               };
+    for(uint ox = 0; ox < offsets[0].size(); ox++) {
+      int cx = (c[0] + offsets[0][ox] + nCells[0]) % nCells[0];
+      for(uint oy = 0; oy < offsets[1].size(); oy++) {
+        int cy = (c[1] + offsets[1][oy] + nCells[1]) % nCells[1];
+        for(uint oz = 0; oz < offsets[2].size(); oz++) {
+          int cz = (c[2] + offsets[2][oz] + nCells[2]) % nCells[2];
+          int s = l.head[(cx * nCells[1] + cy) * nCells[2] + cz];
+          for(; s != -1; s = l.next[s]) {
+            int j = atoms[s];
+            if(i >= j || particleMol[i] == particleMol[j])
+              continue;
+            XYZ dist = boxAxes.MinImage(coords.Difference(i, j), b);
+            if(dist.LengthSq() < listCutSq)
+              l.pairs.push_back(j);
+          }
+        }
+      }
+    }
+  }
+  l.start[atoms.size()] = l.pairs.size();
+
+  l.atoms = atoms;
+  l.refX.resize(atoms.size());
+  l.refY.resize(atoms.size());
+  l.refZ.resize(atoms.size());
+  for(uint r = 0; r < atoms.size(); r++) {
+    l.refX[r] = coords.x[atoms[r]];
+    l.refY[r] = coords.y[atoms[r]];
+    l.refZ[r] = coords.z[atoms[r]];
+  }
+  l.axis = axis;
+  l.built = true;
+  l.builds++;
+}
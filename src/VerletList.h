@@ -0,0 +1,94 @@
+/*******************************************************************************
+GPU OPTIMIZED MONTE CARLO (GOMC) 2.75
+Copyright (C) 2022 GOMC Group
+A copy of the MIT License can be found in License.txt
+along with this program, also can be found at <https://opensource.org/licenses/MIT>.
+********************************************************************************/
+#ifndef VERLET_LIST_H
+#define VERLET_LIST_H
+
+#include "BasicTypes.h" //For uint, XYZ
+#include "EnsemblePreprocessor.h" //For BOX_TOTAL
+#include "XYZArray.h"
+#include "BoxDimensions.h"
+#include <vector>
+
+//Verlet pair list of a box for the full box pair sums (BoxInter, BoxForce
+//and VirialCalc). Every unique pair of atoms in different molecules closer
+//than rCut + skin is stored, so the pair loops only test these candidates
+//instead of all atoms of the 27 neighbor cells. The list is kept until an
+//atom moves more than half the skin from where it was when the list was
+//built, the set of atoms in the box changes or the box is resized. The
+//positions are compared on every Update, so the list can be shared by the
+//trial coordinates of MultiParticle and the current coordinates.
+class VerletList
+{
+public:
+  VerletList();
+
+  //skin <= 0 disables the list
+  void Init(const double skin);
+
+  bool Enabled() const
+  {
+    return skin > 0.0;
+  }
+
+  //Rebuilds the list of box b from coords if it is no longer valid. atoms
+  //are the global indices of the atoms in the box, particleMol maps them to
+  //their molecule.
+  void Update(XYZArray const& coords, BoxDimensions const& boxAxes,
+              const uint b, std::vector<int> const& atoms,
+              std::vector<int> const& particleMol);
+
+  //Forces a rebuild of box b on the next Update
+  void Invalidate(const uint b)
+  {
+    list[b].built = false;
+  }
+
+  //Pairs of the list in compressed rows: atom Atoms(b)[r] is paired with
+  //Pairs(b)[k] for Start(b)[r] <= k < Start(b)[r + 1]. Within a pair the
+  //first atom always has the lower global index.
+  std::vector<int> const& Atoms(const uint b) const
+  {
+    return list[b].atoms;
+  }
+  std::vector<int> const& Start(const uint b) const
+  {
+    return list[b].start;
+  }
+  std::vector<int> const& Pairs(const uint b) const
+  {
+    return list[b].pairs;
+  }
+
+  //Number of times the list of box b has been built
+  uint Builds(const uint b) const
+  {
+    return list[b].builds;
+  }
+
+private:
+  struct BoxList {
+    std::vector<int> atoms, start, pairs;
+    //positions of the atoms when the list was built
+    std::vector<double> refX, refY, refZ;
+    XYZ axis;
+    bool built;
+    uint builds;
+    //cell grid used to build the list
+    std::vector<int> head, next, cell;
+  };
+
+  bool IsValid(XYZArray const& coords, BoxDimensions const& boxAxes,
+               const uint b, std::vector<int> const& atoms) const;
+  void Build(XYZArray const& coords, BoxDimensions const& boxAxes,
+             const uint b, std::vector<int> const& atoms,
+             std::vector<int> const& particleMol);
+
+  double skin;
+  BoxList list[BOX_TOTAL];
+};
+
+#endif /*VERLET_LIST_H*/
@@ -13,6 +13,7 @@ along with this program, also can be found at <https://opensource.org/licenses/M
 #include "Forcefield.h"
 #include "PRNG.h"
 #include "NumLib.h"
+#include "ParallelGrain.h"
 #include <numeric>
 #include <cassert>
 
@@ -130,7 +131,8 @@ void DCHedron::GenerateAnglesNew(TrialMol& newMol, uint molIndex,
   }
 
 #ifdef _OPENMP
-  #pragma omp parallel for default(none) shared(bType, kind, molIndex, newMol, nonbonded_1_3, nTrials)
+  #pragma omp parallel for default(none) shared(bType, kind, molIndex, newMol, nonbonded_1_3, nTrials) \
+  if(parallel_grain::Parallel(nTrials))
 #endif
   for (int i = 0; i < (int) nTrials; ++i) {
     data->angleEnergy[i] = data->ff.angles->Calc(kind, data->angles[i]);
@@ -166,7 +168,8 @@ void DCHedron::GenerateAnglesOld(TrialMol& oldMol, uint molIndex,
   }
 
 #ifdef _OPENMP
-  #pragma omp parallel for default(none) shared(bType, kind, molIndex, nonbonded_1_3, nTrials, oldMol)
+  #pragma omp parallel for default(none) shared(bType, kind, molIndex, nonbonded_1_3, nTrials, oldMol) \
+  if(parallel_grain::Parallel(nTrials))
 #endif
   for (int i = 0; i < (int) nTrials; ++i) {
     data->angleEnergy[i] = data->ff.angles->Calc(kind, data->angles[i]);
@@ -323,7 +326,8 @@ void DCHedron::ConstrainedAngles(TrialMol& newMol, uint molIndex, uint nTrials)
     //calculate weights from combined energy
     double stepWeight = 0.0;
 #ifdef _OPENMP
-    #pragma omp parallel for default(none) shared(energies, nonbonded_1_3, nTrials, weights) reduction(+:stepWeight)
+    #pragma omp parallel for default(none) shared(energies, nonbonded_1_3, nTrials, weights) reduction(+:stepWeight) \
+    if(parallel_grain::Parallel(nTrials))
 #endif
     for (int i = 0; i < (int) nTrials; ++i) {
       weights[i] = exp(-1 * data->ff.beta * (energies[i] +
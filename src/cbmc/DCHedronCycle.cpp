@@ -13,6 +13,7 @@ along with this program, also can be found at <https://opensource.org/licenses/M
 #include "Forcefield.h"
 #include "PRNG.h"
 #include "NumLib.h"
+#include "ParallelGrain.h"
 #include "Geometry.h"
 #include <numeric>
 #include <cassert>
@@ -191,7 +192,8 @@ void DCHedronCycle::GenerateAnglesNew(TrialMol& newMol, uint molIndex,
   }
 
 #ifdef _OPENMP
-  #pragma omp parallel for default(none) shared(bType, kind, molIndex, newMol, nonbonded_1_3, nTrials)
+  #pragma omp parallel for default(none) shared(bType, kind, molIndex, newMol, nonbonded_1_3, nTrials) \
+  if(parallel_grain::Parallel(nTrials))
 #endif
   for (int i = 0; i < (int) nTrials; ++i) {
     data->angleEnergy[i] = data->ff.angles->Calc(kind, data->angles[i]);
@@ -229,7 +231,8 @@ void DCHedronCycle::GenerateAnglesOld(TrialMol& oldMol, uint molIndex,
   }
 
 #ifdef _OPENMP
-  #pragma omp parallel for default(none) shared(bType, kind, molIndex, nonbonded_1_3, nTrials, oldMol)
+  #pragma omp parallel for default(none) shared(bType, kind, molIndex, nonbonded_1_3, nTrials, oldMol) \
+  if(parallel_grain::Parallel(nTrials))
 #endif
   for (int i = 0; i < (int) nTrials; ++i) {
     data->angleEnergy[i] = data->ff.angles->Calc(kind, data->angles[i]);
@@ -406,7 +409,8 @@ void DCHedronCycle::ConstrainedAngles(TrialMol& newMol, uint molIndex, uint nTri
     //calculate weights from combined energy
     double stepWeight = 0.0;
 #ifdef _OPENMP
-    #pragma omp parallel for default(none) shared(energies, nonbonded_1_3, nTrials, weights) reduction(+:stepWeight)
+    #pragma omp parallel for default(none) shared(energies, nonbonded_1_3, nTrials, weights) reduction(+:stepWeight) \
+    if(parallel_grain::Parallel(nTrials))
 #endif
     for (int i = 0; i < (int) nTrials; ++i) {
       weights[i] = exp(-1 * data->ff.beta * (energies[i] + nonbonded_1_3[i]));
@@ -456,7 +456,8 @@ double DCLinkedCycle::EvalLJ(TrialMol& mol, uint molIndex)
                              molIndex, mol.GetBox(), nLJTrials);
 
     data->calc.ParticleNonbonded(nonbonded, mol, positions[b],
-                                 hed.Bonded(b), mol.GetBox(), nLJTrials);
+                                 hed.Bonded(b), mol.GetBox(), nLJTrials,
+                                 overlap);
   }
   double stepWeight = 0;
   for (uint lj = 0; lj < nLJTrials; ++lj) {
@@ -0,0 +1,117 @@
+/*******************************************************************************
+GPU OPTIMIZED MONTE CARLO (GOMC) 2.75
+Copyright (C) 2022 GOMC Group
+A copy of the MIT License can be found in License.txt
+along with this program, also can be found at <https://opensource.org/licenses/MIT>.
+********************************************************************************/
+#include <cassert>
+#include "DCRigid.h"
+#include "DCRotateCOM.h"
+#include "DCGraph.h"
+#include "DCLinear.h"
+#include "TrialMol.h"
+#include "MoleculeKind.h"
+
+namespace cbmc
+{
+
+DCRigid::DCRigid(System& sys, const Forcefield& ff,
+                 const MoleculeKind& kind, const Setup& set) :
+  data(sys, ff, set)
+{
+  mol_setup::MolMap::const_iterator it = set.mol.kindMap.find(kind.uniqueName);
+  assert(it != set.mol.kindMap.end());
+  const mol_setup::MolKind setupKind = it->second;
+
+  idExchange = new DCRotateCOM(&data, setupKind);
+  coords.Init(kind.NumAtoms());
+  if (kind.NumAtoms() > 2) {
+    growth = new DCGraph(sys, ff, kind, set);
+  } else {
+    growth = new DCLinear(sys, ff, kind, set);
+  }
+}
+
+DCRigid::~DCRigid()
+{
+  delete idExchange;
+  delete growth;
+}
+
+void DCRigid::CopyGeometry(TrialMol& oldMol, TrialMol& newMol)
+{
+  oldMol.GetCoords().CopyRange(coords, 0, 0, coords.Count());
+  //newMol may be in a different box, so unwrap in the box of oldMol
+  data.axes.UnwrapPBC(coords, oldMol.GetBox(), coords.Get(0));
+  newMol.SetCoords(coords, 0);
+}
+
+void DCRigid::Build(TrialMol& oldMol, TrialMol& newMol, uint molIndex)
+{
+  //The inserted molecule keeps the geometry of the one being removed
+  CopyGeometry(oldMol, newMol);
+  idExchange->PrepareNew(newMol, molIndex);
+  idExchange->BuildNew(newMol, molIndex);
+  idExchange->PrepareOld(oldMol, molIndex);
+  idExchange->BuildOld(oldMol, molIndex);
+}
+
+void DCRigid::Regrowth(TrialMol& oldMol, TrialMol& newMol, uint molIndex)
+{
+  //Keep the center of mass and pick a new orientation around it
+  CopyGeometry(oldMol, newMol);
+  XYZ center = newMol.GetCOM();
+  newMol.SetSeed(center, XYZ(), false, true, false);
+  oldMol.SetSeed(center, XYZ(), false, true, false);
+  idExchange->PrepareNew(newMol, molIndex);
+  idExchange->BuildNew(newMol, molIndex);
+  idExchange->PrepareOld(oldMol, molIndex);
+  idExchange->BuildOld(oldMol, molIndex);
+}
+
+void DCRigid::CrankShaft(TrialMol& oldMol, TrialMol& newMol, uint molIndex)
+{
+  //No crank shaft move for rigid molecule.
+  //Instead we perform Regrowth move within the same box
+  Regrowth(oldMol, newMol, molIndex);
+}
+
+void DCRigid::BuildIDNew(TrialMol& newMol, uint molIndex)
+{
+  idExchange->PrepareNew(newMol, molIndex);
+  idExchange->BuildNew(newMol, molIndex);
+}
+
+void DCRigid::BuildIDOld(TrialMol& oldMol, uint molIndex)
+{
+  idExchange->PrepareOld(oldMol, molIndex);
+  idExchange->BuildOld(oldMol, molIndex);
+}
+
+void DCRigid::BuildNew(TrialMol& newMol, uint molIndex)
+{
+  growth->BuildNew(newMol, molIndex);
+}
+
+void DCRigid::BuildOld(TrialMol& oldMol, uint molIndex)
+{
+  growth->BuildOld(oldMol, molIndex);
+}
+
+void DCRigid::BuildGrowNew(TrialMol& newMol, uint molIndex)
+{
+  growth->BuildGrowNew(newMol, molIndex);
+}
+
+void DCRigid::BuildGrowOld(TrialMol& oldMol, uint molIndex)
+{
+  growth->BuildGrowOld(oldMol, molIndex);
+}
+
+void DCRigid::BuildGrowInCav(TrialMol& oldMol, TrialMol& newMol,
+                             uint molIndex)
+{
+  growth->BuildGrowInCav(oldMol, newMol, molIndex);
+}
+
+}
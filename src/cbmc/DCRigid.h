@@ -0,0 +1,59 @@
+/*******************************************************************************
+GPU OPTIMIZED MONTE CARLO (GOMC) 2.75
+Copyright (C) 2022 GOMC Group
+A copy of the MIT License can be found in License.txt
+along with this program, also can be found at <https://opensource.org/licenses/MIT>.
+********************************************************************************/
+#ifndef DCRIGID_H
+#define DCRIGID_H
+#include "CBMC.h"
+#include "DCData.h"
+#include "XYZArray.h"
+
+/*CBMC for rigid molecules (see MoleculeKind::isRigid)
+* Insertion and regrowth only pick a position and an orientation for the
+* existing geometry of the molecule, there are no bond, angle or dihedral
+* trials to generate. Growth from a seed atom, used by MEMC and targeted
+* swap, is left to the regular builder of the molecule.
+*/
+
+class System;
+class Forcefield;
+class MoleculeKind;
+class Setup;
+
+namespace cbmc
+{
+class DCRotateCOM;
+
+class DCRigid : public CBMC
+{
+public:
+  DCRigid(System& sys, const Forcefield& ff,
+          const MoleculeKind& kind, const Setup& set);
+
+  void Build(TrialMol& oldMol, TrialMol& newMol, uint molIndex);
+  void Regrowth(TrialMol& oldMol, TrialMol& newMol, uint molIndex);
+  void CrankShaft(TrialMol& oldMol, TrialMol& newMol, uint molIndex);
+  void BuildIDNew(TrialMol& newMol, uint molIndex);
+  void BuildIDOld(TrialMol& oldMol, uint molIndex);
+  void BuildNew(TrialMol& newMol, uint molIndex);
+  void BuildOld(TrialMol& oldMol, uint molIndex);
+  void BuildGrowNew(TrialMol& newMol, uint molIndex);
+  void BuildGrowOld(TrialMol& oldMol, uint molIndex);
+  void BuildGrowInCav(TrialMol& oldMol, TrialMol& newMol, uint molIndex);
+  ~DCRigid();
+
+private:
+  //copy the coordinates of oldMol to newMol as one unwrapped molecule
+  void CopyGeometry(TrialMol& oldMol, TrialMol& newMol);
+
+  DCData data;
+  DCRotateCOM* idExchange;
+  //regular builder of the kind, used to grow from a seed atom
+  CBMC* growth;
+  XYZArray coords;
+};
+}
+
+#endif
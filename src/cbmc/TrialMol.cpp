@@ -334,12 +334,11 @@ XYZ TrialMol::GetCOM()
 {
   XYZ tcom;
   uint atomNumber = tCoords.Count();
-  XYZArray temp(tCoords);
-  axes->UnwrapPBC(temp, box, tCoords.Get(0));
-  tCoords = temp;
+  //unwrap in place, the reference is a copy of the first atom
+  axes->UnwrapPBC(tCoords, box, tCoords.Get(0));
 
   for(uint p = 0; p < atomNumber; p++) {
-    tcom += temp.Get(p);
+    tcom += tCoords.Get(p);
   }
   tcom *= (1.0 / (double)(atomNumber));
   //Unwrap with respect to COM
@@ -688,11 +688,13 @@ inline void MoleculeExchange1::ShiftMol(const bool A, const uint n,
     newMolA[n].GetCoords().CopyRange(coordCurrRef, 0, pStartA[n], pLenA[n]);
     comCurrRef.SetNew(molIndexA[n], to);
     molLookRef.ShiftMolBox(molIndexA[n], from, to, kindIndexA[n]);
+    calcEnRef.ShiftTailSums(kindIndexA[n], from, to);
   } else {
     //Add type B to source box
     newMolB[n].GetCoords().CopyRange(coordCurrRef, 0, pStartB[n], pLenB[n]);
     comCurrRef.SetNew(molIndexB[n], to);
     molLookRef.ShiftMolBox(molIndexB[n], from, to, kindIndexB[n]);
+    calcEnRef.ShiftTailSums(kindIndexB[n], from, to);
   }
 }
 
@@ -707,6 +709,7 @@ inline void MoleculeExchange1::RecoverMol(const bool A, const uint n,
     molA.CopyRange(coordCurrRef, 0, pStartA[n], pLenA[n]);
     comCurrRef.SetNew(molIndexA[n], to);
     molLookRef.ShiftMolBox(molIndexA[n], from, to, kindIndexA[n]);
+    calcEnRef.ShiftTailSums(kindIndexA[n], from, to);
   } else {
     XYZArray molB(pLenB[n]);
     oldMolB[n].GetCoords().CopyRange(molB, 0, 0, pLenB[n]);
@@ -715,6 +718,7 @@ inline void MoleculeExchange1::RecoverMol(const bool A, const uint n,
     molB.CopyRange(coordCurrRef, 0, pStartB[n], pLenB[n]);
     comCurrRef.SetNew(molIndexB[n], to);
     molLookRef.ShiftMolBox(molIndexB[n], from, to, kindIndexB[n]);
+    calcEnRef.ShiftTailSums(kindIndexB[n], from, to);
   }
 }
 
@@ -213,6 +213,7 @@ inline void MoleculeTransfer::Accept(const uint rejectState, const ulong step)
       comCurrRef.SetNew(molIndex, destBox);
       molLookRef.ShiftMolBox(molIndex, sourceBox, destBox,
                              kindIndex);
+      calcEnRef.ShiftTailSums(kindIndex, sourceBox, destBox);
       cellList.AddMol(molIndex, destBox, coordCurrRef);
 
       //Zero out box energies to prevent small number
@@ -108,6 +108,7 @@ protected:
 class MolTransformBase
 {
 protected:
+  MolTransformBase() : surrogateEn(0.0), surrogateReject(false) {}
   uint GetBoxAndMol(PRNG & prng, Molecules const& molRef,
                     const double subDraw, const double movPerc);
   void ReplaceWith(MolTransformBase const& other);
@@ -117,6 +118,10 @@ protected:
   uint pStart, pLen;
   //Position
   XYZArray newMolPos;
+  //Surrogate energy change of the first stage of the two-stage acceptance,
+  //and whether that stage rejected the move
+  double surrogateEn;
+  bool surrogateReject;
 };
 
 inline uint MolTransformBase::GetBoxAndMol(PRNG & prng, Molecules const& molRef,
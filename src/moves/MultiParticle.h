@@ -567,20 +567,16 @@ inline void MultiParticle::RotateForceBiased(uint molIndex)
   uint start, stop, len;
   molRef.GetRange(start, stop, len, molIndex);
   
-  // Copy the range into temporary array
-  XYZArray temp(len);
-  newMolsPos.CopyRange(temp, start, 0, len);
-  boxDimRef.UnwrapPBC(temp, bPick, center);
-  
+  // Rotate the range in place, without a temporary array
+  boxDimRef.UnwrapPBC(newMolsPos, start, stop, bPick, center);
+
   // Do Rotation
-  for(uint p = 0; p < len; p++) {
-    temp.Add(p, -center);
-    temp.Set(p, matrix.Apply(temp[p]));
-    temp.Add(p, center);
+  for(uint p = start; p < stop; p++) {
+    newMolsPos.Add(p, -center);
+    newMolsPos.Set(p, matrix.Apply(newMolsPos[p]));
+    newMolsPos.Add(p, center);
   }
-  boxDimRef.WrapPBC(temp, bPick);
-  // Copy back the result
-  temp.CopyRange(newMolsPos, 0, start, len);
+  boxDimRef.WrapPBC(newMolsPos, start, stop, bPick);
 }
 
 inline void MultiParticle::TranslateForceBiased(uint molIndex)
@@ -600,17 +596,12 @@ inline void MultiParticle::TranslateForceBiased(uint molIndex)
   XYZ newcom = comCurrRef.Get(molIndex);
   uint stop, start, len;
   molRef.GetRange(start, stop, len, molIndex);
-  // Copy the range into temporary array
-  XYZArray temp(len);
-  newMolsPos.CopyRange(temp, start, 0, len);
-  //Shift the coordinate and COM
-  temp.AddAll(shift);
+  //Shift the coordinate and COM in place, without a temporary array
+  newMolsPos.AddRange(start, stop, shift);
   newcom += shift;
   //rewrapping
-  boxDimRef.WrapPBC(temp, bPick);
+  boxDimRef.WrapPBC(newMolsPos, start, stop, bPick);
   newcom = boxDimRef.WrapPBC(newcom, bPick);
-  //set the new coordinate
-  temp.CopyRange(newMolsPos, 0, start, len);
   newCOMs.Set(molIndex, newcom);
 }
 
@@ -625,20 +616,16 @@ inline void MultiParticle::RotateRandom(uint molIndex)
   uint start, stop, len;
   molRef.GetRange(start, stop, len, molIndex);
   
-  // Copy the range into temporary array
-  XYZArray temp(len);
-  newMolsPos.CopyRange(temp, start, 0, len);
-  boxDimRef.UnwrapPBC(temp, bPick, center);
-  
+  // Rotate the range in place, without a temporary array
+  boxDimRef.UnwrapPBC(newMolsPos, start, stop, bPick, center);
+
   // Do Rotation
-  for(uint p = 0; p < len; p++) {
-    temp.Add(p, -center);
-    temp.Set(p, matrix.Apply(temp[p]));
-    temp.Add(p, center);
+  for(uint p = start; p < stop; p++) {
+    newMolsPos.Add(p, -center);
+    newMolsPos.Set(p, matrix.Apply(newMolsPos[p]));
+    newMolsPos.Add(p, center);
   }
-  boxDimRef.WrapPBC(temp, bPick);
-  // Copy back the result
-  temp.CopyRange(newMolsPos, 0, start, len);
+  boxDimRef.WrapPBC(newMolsPos, start, stop, bPick);
 }
 
 inline void MultiParticle::TranslateRandom(uint molIndex)
@@ -649,17 +636,12 @@ inline void MultiParticle::TranslateRandom(uint molIndex)
   uint stop, start, len;
 
   molRef.GetRange(start, stop, len, molIndex);
-  // Copy the range into temporary array
-  XYZArray temp(len);
-  newMolsPos.CopyRange(temp, start, 0, len);
-  //Shift the coordinate and COM
-  temp.AddAll(shift);
+  //Shift the coordinate and COM in place, without a temporary array
+  newMolsPos.AddRange(start, stop, shift);
   newcom += shift;
   //rewrapping
-  boxDimRef.WrapPBC(temp, bPick);
+  boxDimRef.WrapPBC(newMolsPos, start, stop, bPick);
   newcom = boxDimRef.WrapPBC(newcom, bPick);
-  //set the new coordinate
-  temp.CopyRange(newMolsPos, 0, start, len);
   newCOMs.Set(molIndex, newcom);
 }
 
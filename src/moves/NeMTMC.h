@@ -386,6 +386,7 @@ inline void NEMTMC::ShiftMolToSourceBox()
   oldMolNEMT.GetCoords().CopyRange(coordCurrRef, 0, pStartNEMT, pLenNEMT);
   comCurrRef.SetNew(molIndex, sourceBox);
   molLookRef.ShiftMolBox(molIndex, destBox, sourceBox, kindIndex);
+  calcEnRef.ShiftTailSums(kindIndex, destBox, sourceBox);
   cellList.AddMol(molIndex, sourceBox, coordCurrRef);
 }
 
@@ -396,6 +397,7 @@ inline void NEMTMC::ShiftMolToDestBox()
   newMolNEMT.GetCoords().CopyRange(coordCurrRef, 0, pStartNEMT, pLenNEMT);
   comCurrRef.SetNew(molIndex, destBox);
   molLookRef.ShiftMolBox(molIndex, sourceBox, destBox, kindIndex);
+  calcEnRef.ShiftTailSums(kindIndex, sourceBox, destBox);
   cellList.AddMol(molIndex, destBox, coordCurrRef);
 }
 
@@ -701,6 +701,7 @@ inline void TargetedSwap::Accept(const uint rejectState, const ulong step)
       comCurrRef.SetNew(molIndex, destBox);
       molLookRef.ShiftMolBox(molIndex, sourceBox, destBox,
                              kindIndex);
+      calcEnRef.ShiftTailSums(kindIndex, sourceBox, destBox);
       cellList.AddMol(molIndex, destBox, coordCurrRef);
 
       //Zero out box energies to prevent small number
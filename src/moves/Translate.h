@@ -89,6 +89,18 @@ inline void Translate::CalcEn()
   cellList.RemoveMol(m, b, coordCurrRef);
   molRemoved = true;
   overlap = false;
+  surrogateEn = 0.0;
+  surrogateReject = false;
+
+  //First stage of the two-stage acceptance, on the surrogate energy only
+  if(calcEnRef.SurrogateEnabled()) {
+    overlap = calcEnRef.MoleculeSurrogate(surrogateEn, newMolPos, m, b);
+    surrogateReject = overlap || !(prng() < exp(-BETA * surrogateEn));
+  }
+  if(surrogateReject) {
+    GOMC_EVENT_STOP(1, GomcProfileEvent::CALC_EN_DISPLACE);
+    return;
+  }
 
   //calculate LJ interaction and real term of electrostatic interaction
   overlap = calcEnRef.MoleculeInter(inter_LJ, inter_Real, newMolPos, m, b);
@@ -103,12 +115,13 @@ inline void Translate::Accept(const uint rejectState, const ulong step)
 {
   GOMC_EVENT_START(1, GomcProfileEvent::ACC_DISPLACE);
   bool res = false;
-  if (rejectState == mv::fail_state::NO_FAIL) {
+  //The second stage of the two-stage acceptance corrects for the first
+  if(rejectState == mv::fail_state::NO_FAIL && !surrogateReject) {
     double pr = prng();
     res = pr < exp(-BETA * (inter_LJ.energy + inter_Real.energy +
-                            recip.energy));
+                            recip.energy - surrogateEn));
   }
-  bool result = res && !overlap;
+  bool result = res && !overlap && !surrogateReject;
 
   if (result) {
     //Set new energy.
@@ -119,6 +132,7 @@ inline void Translate::Accept(const uint rejectState, const ulong step)
     // setting energy and virial of recip term
     sysPotRef.boxEnergy[b].recip += recip.energy;;
 
+    calcEnRef.LedgerAccept(m, b);
     //Copy coords
     newMolPos.CopyRange(coordCurrRef, 0, pStart, pLen);
     comCurrRef.Set(m, newCOM);
@@ -131,7 +145,7 @@ inline void Translate::Accept(const uint rejectState, const ulong step)
 
   if(molRemoved) {
     // It means that Recip energy is calculated and move not accepted
-    if(!result && !overlap) {
+    if(!result && !overlap && !surrogateReject) {
       calcEwald->RestoreMol(m);
     }
     cellList.AddMol(m, b, coordCurrRef);
@@ -8,6 +8,12 @@ function(add_NVT_test name)
       set_target_properties(${name} PROPERTIES 
       COMPILE_FLAGS "${NVT_flags}")
       add_test(NAME BasicTypesTest_NVT COMMAND BasicTypesTest)
+      add_test(NAME BoxGeometryTest_NVT COMMAND BoxGeometryTest)
+      add_test(NAME SimdPairKernelTest_NVT COMMAND SimdPairKernelTest)
+      add_test(NAME EwaldRealTableTest_NVT COMMAND EwaldRealTableTest)
+      add_test(NAME FFT3DTest_NVT COMMAND FFT3DTest)
+      add_test(NAME VerletListTest_NVT COMMAND VerletListTest)
+      add_test(NAME CellListTest_NVT COMMAND CellListTest)
       #add_test(NAME CircuitTester_NVT COMMAND DialaTest)
       add_test(NAME MolLookupTest_NVT COMMAND CheckConsensusBeta)
       #add_test(NAME PSFParserTest_NVT COMMAND CheckProtAndWaterTest)
@@ -22,6 +28,12 @@ function(add_NPT_test name)
       set_target_properties(${name} PROPERTIES 
       COMPILE_FLAGS "${NPT_flags}")
       add_test(NAME BasicTypesTest_NPT COMMAND BasicTypesTest)
+      add_test(NAME BoxGeometryTest_NPT COMMAND BoxGeometryTest)
+      add_test(NAME SimdPairKernelTest_NPT COMMAND SimdPairKernelTest)
+      add_test(NAME EwaldRealTableTest_NPT COMMAND EwaldRealTableTest)
+      add_test(NAME FFT3DTest_NPT COMMAND FFT3DTest)
+      add_test(NAME VerletListTest_NPT COMMAND VerletListTest)
+      add_test(NAME CellListTest_NPT COMMAND CellListTest)
       #add_test(NAME CircuitTester_NPT COMMAND DialaTest)
       add_test(NAME MolLookupTest_NPT COMMAND CheckConsensusBeta)
       #add_test(NAME PSFParserTest_NPT COMMAND CheckProtAndWaterTest)
@@ -36,6 +48,12 @@ function(add_GCMC_test name)
       set_target_properties(${name} PROPERTIES 
       COMPILE_FLAGS "${GCMC_flags}")
       add_test(NAME BasicTypesTest_GCMC COMMAND BasicTypesTest)
+      add_test(NAME BoxGeometryTest_GCMC COMMAND BoxGeometryTest)
+      add_test(NAME SimdPairKernelTest_GCMC COMMAND SimdPairKernelTest)
+      add_test(NAME EwaldRealTableTest_GCMC COMMAND EwaldRealTableTest)
+      add_test(NAME FFT3DTest_GCMC COMMAND FFT3DTest)
+      add_test(NAME VerletListTest_GCMC COMMAND VerletListTest)
+      add_test(NAME CellListTest_GCMC COMMAND CellListTest)
       #add_test(NAME CircuitTester_GCMC COMMAND DialaTest)
       add_test(NAME MolLookupTest_GCMC COMMAND CheckConsensusBeta)
       #add_test(NAME PSFParserTest_GCMC COMMAND CheckProtAndWaterTest)
@@ -52,6 +70,12 @@ function(add_GEMC_test name)
       set_target_properties(${name} PROPERTIES 
       COMPILE_FLAGS "${GEMC_flags}")
       add_test(NAME BasicTypesTest_GEMC COMMAND BasicTypesTest)
+      add_test(NAME BoxGeometryTest_GEMC COMMAND BoxGeometryTest)
+      add_test(NAME SimdPairKernelTest_GEMC COMMAND SimdPairKernelTest)
+      add_test(NAME EwaldRealTableTest_GEMC COMMAND EwaldRealTableTest)
+      add_test(NAME FFT3DTest_GEMC COMMAND FFT3DTest)
+      add_test(NAME VerletListTest_GEMC COMMAND VerletListTest)
+      add_test(NAME CellListTest_GEMC COMMAND CellListTest)
       #add_test(NAME CircuitTester_GEMC COMMAND DialaTest)
       add_test(NAME MolLookupTest_GEMC COMMAND CheckConsensusBeta)
       #add_test(NAME PSFParserTest_GEMC COMMAND CheckProtAndWaterTest)
@@ -1,6 +1,12 @@
 set(TestSources
     test/src/BasicTypesTest.cpp
     test/src/BitLibTest.cpp
+    test/src/BoxGeometryTest.cpp
+    test/src/SimdPairKernelTest.cpp
+    test/src/EwaldRealTableTest.cpp
+    test/src/FFT3DTest.cpp
+    test/src/VerletListTest.cpp
+    test/src/CellListTest.cpp
     test/src/EndianTest.cpp
     test/src/MolLookupTest.cpp
     #test/src/CircuitTester.cpp
@@ -34,10 +40,14 @@ set(GOMCSources
    src/ExtendedSystemOutput.cpp
    src/Ewald.cpp
    src/EwaldCached.cpp
+   src/EwaldRealTable.cpp
+   src/EwaldSPME.cpp
+   src/EwaldWolf.cpp
    src/FFConst.cpp
    src/FFDihedrals.cpp
    src/FFParticle.cpp
    src/FFSetup.cpp
+   src/FFT3D.cpp
    src/Forcefield.cpp
    src/FreeEnergyOutput.cpp
    src/Geometry.cpp
@@ -52,6 +62,7 @@ set(GOMCSources
    src/NoEwald.cpp
    src/OutConst.cpp
    src/OutputVars.cpp
+   src/ParallelGrain.cpp
    src/ParallelTemperingPreprocessor.cpp
    src/ParallelTemperingUtilities.cpp
    src/PDBSetup.cpp
@@ -60,9 +71,11 @@ set(GOMCSources
    src/PSFOutput.cpp
    src/Random123Wrapper.cpp
    src/Reader.cpp
+   src/SimdPairKernel.cpp
    src/Simulation.cpp
    src/StaticVals.cpp
    src/System.cpp
+   src/VerletList.cpp
    src/cbmc/DCCrankShaftAng.cpp
    src/cbmc/DCCrankShaftDih.cpp
    src/cbmc/DCCyclic.cpp
@@ -77,6 +90,7 @@ set(GOMCSources
    src/cbmc/DCHedronCycle.cpp
    src/cbmc/DCLinear.cpp
    src/cbmc/DCOnSphere.cpp
+   src/cbmc/DCRigid.cpp
    src/cbmc/DCRotateCOM.cpp
    src/cbmc/DCRotateOnAtom.cpp
    src/cbmc/DCSingle.cpp
@@ -87,6 +101,7 @@ set(GOMCHeaders
    src/BondAdjacencyList.h
    src/BoxDimensions.h
    src/BoxDimensionsNonOrth.h
+   src/BoxGeometry.h
    src/CalculateEnergy.h
    src/CBMC.h
    src/CellList.h
@@ -109,6 +124,9 @@ set(GOMCHeaders
    src/ExtendedSystemOutput.h
    src/Ewald.h
    src/EwaldCached.h  
+   src/EwaldRealTable.h
+   src/EwaldSPME.h
+   src/EwaldWolf.h
    src/FFAngles.h
    src/FFBonds.h
    src/FFConst.h
@@ -119,6 +137,7 @@ set(GOMCHeaders
    src/FFShift.h
    src/FFSwitch.h
    src/FFSwitchMartini.h
+   src/FFT3D.h
    src/FixedWidthReader.h
    src/Forcefield.h
    src/FreeEnergyOutput.h
@@ -141,6 +160,7 @@ set(GOMCHeaders
    src/OutConst.h
    src/OutputAbstracts.h
    src/OutputVars.h
+   src/ParallelGrain.h
    src/ParallelTemperingPreprocessor.h
    src/ParallelTemperingUtilities.h
    src/PDBConst.h
@@ -154,12 +174,15 @@ set(GOMCHeaders
    src/SeedReader.h
    src/Setup.h
    src/SimEventFrequency.h
+   src/SimdPairKernel.h
+   src/SimdPairKernelBody.h
    src/Simulation.h
    src/StaticVals.h
    src/SubdividedArray.h
    src/System.h
    src/TransformMatrix.h
    src/Velocity.h
+   src/VerletList.h
    src/Writer.h
    src/XYZArray.h
    src/cbmc/DCComponent.h
@@ -178,6 +201,7 @@ set(GOMCHeaders
    src/cbmc/DCHedronCycle.h
    src/cbmc/DCLinear.h
    src/cbmc/DCOnSphere.h
+   src/cbmc/DCRigid.h
    src/cbmc/DCRotateCOM.h
    src/cbmc/DCRotateOnAtom.h
    src/cbmc/DCSingle.h
@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+#include "BoxGeometry.h"
+
+TEST(BoxGeometryTest, OrthMinImageMatchesBoxDimensions) {
+  BoxDimensions boxDim;
+  boxDim.axis.Set(0, 30.0, 25.0, 40.0);
+  boxDim.halfAx.Set(0, 15.0, 12.5, 20.0);
+  boxDim.rCutSq[0] = 100.0;
+  OrthGeometry geom(boxDim, 0);
+
+  XYZ vecs[] = { XYZ(1.0, -2.0, 3.0), XYZ(16.0, -13.0, 21.5),
+                 XYZ(-29.0, 24.0, -39.0), XYZ(14.9, 12.4, -19.9) };
+  for (uint i = 0; i < 4; ++i) {
+    XYZ expected = boxDim.BoxDimensions::MinImage(vecs[i], 0);
+    XYZ result = geom.MinImage(vecs[i]);
+    EXPECT_DOUBLE_EQ(expected.x, result.x);
+    EXPECT_DOUBLE_EQ(expected.y, result.y);
+    EXPECT_DOUBLE_EQ(expected.z, result.z);
+  }
+}
+
+TEST(BoxGeometryTest, OrthInRcut) {
+  BoxDimensions boxDim;
+  boxDim.axis.Set(0, 30.0, 30.0, 30.0);
+  boxDim.halfAx.Set(0, 15.0, 15.0, 15.0);
+  boxDim.rCutSq[0] = 100.0;
+  OrthGeometry geom(boxDim, 0);
+
+  XYZArray coords(3);
+  coords.Set(0, 1.0, 1.0, 1.0);
+  coords.Set(1, 29.0, 1.0, 1.0);
+  coords.Set(2, 16.0, 1.0, 1.0);
+  double distSq;
+  XYZ dist;
+  EXPECT_TRUE(geom.InRcut(distSq, dist, coords, 0, 1));
+  EXPECT_DOUBLE_EQ(4.0, distSq);
+  EXPECT_DOUBLE_EQ(2.0, dist.x);
+  EXPECT_FALSE(geom.InRcut(distSq, dist, coords, 0, 2));
+  EXPECT_DOUBLE_EQ(225.0, distSq);
+}
+
+TEST(BoxGeometryTest, NonOrthMinImageMatchesBoxDimensions) {
+  BoxDimensionsNonOrth boxDim;
+  boxDim.cellBasis[0].Set(0, 30.0, 0.0, 0.0);
+  boxDim.cellBasis[0].Set(1, 4.0, 30.0, 0.0);
+  boxDim.cellBasis[0].Set(2, 0.0, 3.0, 30.0);
+  boxDim.cellLength.Set(0, boxDim.cellBasis[0].Length(0),
+                        boxDim.cellBasis[0].Length(1),
+                        boxDim.cellBasis[0].Length(2));
+  boxDim.CalcCellDimensions(0);
+  boxDim.axis.Set(0, boxDim.cellLength.Get(0));
+  boxDim.halfAx.Set(0, boxDim.cellLength.Get(0) * 0.5);
+  boxDim.rCutSq[0] = 100.0;
+  NonOrthGeometry geom(boxDim, 0);
+
+  XYZ vecs[] = { XYZ(1.0, -2.0, 3.0), XYZ(16.0, -13.0, 21.5),
+                 XYZ(-29.0, 24.0, -39.0), XYZ(14.9, 12.4, -19.9) };
+  for (uint i = 0; i < 4; ++i) {
+    XYZ expected = boxDim.MinImage(vecs[i], 0);
+    XYZ result = geom.MinImage(vecs[i]);
+    EXPECT_DOUBLE_EQ(expected.x, result.x);
+    EXPECT_DOUBLE_EQ(expected.y, result.y);
+    EXPECT_DOUBLE_EQ(expected.z, result.z);
+  }
+}
@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+#include "CellList.h"
+#include "BoxDimensions.h"
+#include "MoleculeLookup.h"
+#include "Molecules.h"
+#include "XYZArray.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace
+{
+const int N_MOLS = 40;
+const int MOL_ATOMS = 3;
+
+void MakeSystem(Molecules &mols, MoleculeLookup &lookup, BoxDimensions &dims,
+                XYZArray &pos)
+{
+  mols.restartFromCheckpoint = false;
+  mols.beta = mols.occ = NULL;
+  mols.count = N_MOLS;
+  mols.start = new uint32_t[N_MOLS + 1];
+  for (int m = 0; m <= N_MOLS; ++m)
+    mols.start[m] = m * MOL_ATOMS;
+
+  lookup.numKinds = 1;
+  lookup.molLookup = new uint[N_MOLS];
+  for (int m = 0; m < N_MOLS; ++m)
+    lookup.molLookup[m] = m;
+  lookup.boxAndKindStart = new uint[BOX_TOTAL + 1];
+  for (int b = 0; b <= BOX_TOTAL; ++b)
+    lookup.boxAndKindStart[b] = (b == 0 ? 0 : N_MOLS);
+
+  for (int b = 0; b < BOX_TOTAL; ++b) {
+    dims.axis.Set(b, 30.0, 30.0, 30.0);
+    dims.halfAx.Set(b, 15.0, 15.0, 15.0);
+    dims.rCut[b] = 8.0;
+    dims.rCutSq[b] = 64.0;
+  }
+
+  srand(2468);
+  pos.Init(N_MOLS * MOL_ATOMS);
+  for (int p = 0; p < N_MOLS * MOL_ATOMS; ++p)
+    pos.Set(p, 30.0 * rand() / RAND_MAX, 30.0 * rand() / RAND_MAX,
+            30.0 * rand() / RAND_MAX);
+}
+
+//The cell ordered arrays must hold the same particles as the linked list of
+//every cell, in increasing index order
+void CheckCellArrays(CellList const& cl)
+{
+  std::vector<int> const& cellVector = cl.CellVector(0);
+  std::vector<int> const& cellStart = cl.CellStartIndex(0);
+  std::vector<int> const& cellOf = cl.MapParticleToCell(0);
+  int nCells = cl.CellsInBox(0);
+  ASSERT_EQ(nCells + 1, (int)cellStart.size());
+  EXPECT_EQ(nCells * CellList::NEIGHBOR_CELLS,
+            (int)cl.NeighborStencil(0).size());
+
+  int total = 0;
+  for (int c = 0; c < nCells; ++c) {
+    std::vector<int> expected;
+    CellList::Cell it = cl.EnumerateCell(c, 0);
+    while (!it.Done()) {
+      expected.push_back(*it);
+      it.Next();
+    }
+    std::sort(expected.begin(), expected.end());
+    std::vector<int> found(cellVector.begin() + cellStart[c],
+                           cellVector.begin() + cellStart[c + 1]);
+    EXPECT_EQ(expected, found);
+    for (uint i = 0; i < found.size(); ++i)
+      EXPECT_EQ(c, cellOf[found[i]]);
+    total += found.size();
+  }
+  EXPECT_EQ(total, (int)cellVector.size());
+}
+}
+
+TEST(CellListTest, CellArraysFollowTheLinkedList) {
+  Molecules mols;
+  MoleculeLookup lookup;
+  BoxDimensions dims;
+  XYZArray pos;
+  MakeSystem(mols, lookup, dims, pos);
+
+  CellList cl(mols, dims);
+  cl.SetCutoff();
+  cl.GridAll(dims, pos, lookup);
+  CheckCellArrays(cl);
+  EXPECT_EQ(N_MOLS * MOL_ATOMS, (int)cl.CellVector(0).size());
+
+  //Move a molecule to the other side of the box
+  cl.RemoveMol(7, 0, pos);
+  CheckCellArrays(cl);
+  EXPECT_EQ((N_MOLS - 1) * MOL_ATOMS, (int)cl.CellVector(0).size());
+  for (int p = mols.MolStart(7); p < mols.MolEnd(7); ++p)
+    pos.Set(p, 29.0, 1.0, 15.0);
+  cl.AddMol(7, 0, pos);
+  CheckCellArrays(cl);
+  EXPECT_EQ(N_MOLS * MOL_ATOMS, (int)cl.CellVector(0).size());
+}
+
+TEST(CellListTest, HalfStencilHasEveryCellPairOnce) {
+  Molecules mols;
+  MoleculeLookup lookup;
+  BoxDimensions dims;
+  XYZArray pos;
+  MakeSystem(mols, lookup, dims, pos);
+  //3 x 4 x 5 cells, the smallest grid CellList makes is on the x axis
+  for (int b = 0; b < BOX_TOTAL; ++b) {
+    dims.axis.Set(b, 30.0, 40.0, 50.0);
+    dims.halfAx.Set(b, 15.0, 20.0, 25.0);
+    dims.rCut[b] = 10.0;
+    dims.rCutSq[b] = 100.0;
+  }
+
+  CellList cl(mols, dims);
+  cl.SetCutoff();
+  cl.GridAll(dims, pos, lookup);
+  int nCells = cl.CellsInBox(0);
+  ASSERT_EQ(60, nCells);
+  std::vector<int> const& full = cl.NeighborStencil(0);
+  std::vector<int> const& half = cl.HalfStencil(0);
+  ASSERT_EQ(nCells * CellList::HALF_NEIGHBOR_CELLS, (int)half.size());
+
+  std::vector<int> count(nCells * nCells, 0);
+  for (int c = 0; c < nCells; ++c) {
+    EXPECT_EQ(c, half[c * CellList::HALF_NEIGHBOR_CELLS]);
+    for (int k = 1; k < CellList::HALF_NEIGHBOR_CELLS; ++k) {
+      int n = half[c * CellList::HALF_NEIGHBOR_CELLS + k];
+      EXPECT_NE(c, n);
+      ++count[std::min(c, n) * nCells + std::max(c, n)];
+    }
+  }
+  //Every pair of different neighbor cells of the full stencil, once
+  for (int c = 0; c < nCells; ++c) {
+    for (int k = 0; k < CellList::NEIGHBOR_CELLS; ++k) {
+      int n = full[c * CellList::NEIGHBOR_CELLS + k];
+      if (n != c)
+        EXPECT_EQ(1, count[std::min(c, n) * nCells + std::max(c, n)]);
+    }
+  }
+  int total = 0;
+  for (uint i = 0; i < count.size(); ++i)
+    total += count[i];
+  EXPECT_EQ(nCells * (CellList::HALF_NEIGHBOR_CELLS - 1), total);
+}
@@ -0,0 +1,35 @@
+#include <gtest/gtest.h>
+#include "EwaldRealTable.h"
+#include <cmath>
+
+TEST(EwaldRealTableTest, MatchesErfc) {
+  const double alpha = 0.28, accuracy = 1e-10;
+  EwaldRealTable table;
+  table.Init(0, alpha, 1.0, 12.0, accuracy);
+  ASSERT_TRUE(table.Enabled(0));
+
+  for (double distSq = 1.0; distSq < 144.0; distSq += 0.0137) {
+    double dist = sqrt(distSq);
+    double en = erfc(alpha * dist) / dist;
+    double vir = (en + alpha * M_2_SQRTPI * exp(-alpha * alpha * distSq)) /
+                 distSq;
+    double tableEn, tableVir;
+    ASSERT_TRUE(table.Energy(tableEn, distSq, 0));
+    ASSERT_TRUE(table.Virial(tableVir, distSq, 0));
+    EXPECT_NEAR(en, tableEn, accuracy * en);
+    EXPECT_NEAR(vir, tableVir, accuracy * vir);
+  }
+}
+
+TEST(EwaldRealTableTest, OutsideTable) {
+  EwaldRealTable table;
+  double val;
+  EXPECT_FALSE(table.Enabled(0));
+  EXPECT_FALSE(table.Energy(val, 4.0, 0));
+
+  table.Init(0, 0.3, 2.0, 10.0, 1e-8);
+  EXPECT_FALSE(table.Energy(val, 3.0, 0));
+  EXPECT_TRUE(table.Energy(val, 4.0, 0));
+  EXPECT_TRUE(table.Virial(val, 99.9, 0));
+  EXPECT_FALSE(table.Virial(val, 100.0, 0));
+}
@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+#include "FFT3D.h"
+#include <cmath>
+
+namespace
+{
+//Direct sum of the transform of FFT3D::Transform
+std::vector<std::complex<double> > NaiveDFT(
+  const std::vector<std::complex<double> > &in, const uint *n, const int sign)
+{
+  std::vector<std::complex<double> > out(in.size());
+  for(uint mx = 0; mx < n[0]; mx++)
+    for(uint my = 0; my < n[1]; my++)
+      for(uint mz = 0; mz < n[2]; mz++) {
+        std::complex<double> sum(0.0, 0.0);
+        for(uint gx = 0; gx < n[0]; gx++)
+          for(uint gy = 0; gy < n[1]; gy++)
+            for(uint gz = 0; gz < n[2]; gz++) {
+              double angle = sign * 2.0 * M_PI *
+                             ((double) (mx * gx) / n[0] +
+                              (double) (my * gy) / n[1] +
+                              (double) (mz * gz) / n[2]);
+              sum += in[(gx * n[1] + gy) * n[2] + gz] *
+                     std::complex<double>(cos(angle), sin(angle));
+            }
+        out[(mx * n[1] + my) * n[2] + mz] = sum;
+      }
+  return out;
+}
+}
+
+TEST(FFT3DTest, MatchesDirectSum) {
+  const uint n[3] = {4, 8, 2};
+  FFT3D fft;
+  fft.Resize(n[0], n[1], n[2]);
+  ASSERT_EQ(64u, fft.Size());
+
+  std::vector<std::complex<double> > in(fft.Size());
+  for(uint i = 0; i < in.size(); i++)
+    in[i] = std::complex<double>(sin(0.7 * i + 0.1), cos(1.3 * i));
+
+  for(int sign = -1; sign <= 1; sign += 2) {
+    std::vector<std::complex<double> > data(in);
+    fft.Transform(&data[0], sign);
+    std::vector<std::complex<double> > ref = NaiveDFT(in, n, sign);
+    for(uint i = 0; i < data.size(); i++) {
+      EXPECT_NEAR(ref[i].real(), data[i].real(), 1e-10);
+      EXPECT_NEAR(ref[i].imag(), data[i].imag(), 1e-10);
+    }
+  }
+}
+
+TEST(FFT3DTest, RoundTrip) {
+  FFT3D fft;
+  fft.Resize(16, 4, 32);
+  std::vector<std::complex<double> > in(fft.Size());
+  for(uint i = 0; i < in.size(); i++)
+    in[i] = std::complex<double>(0.01 * i, -0.5 + (i % 7));
+
+  std::vector<std::complex<double> > data(in);
+  fft.Transform(&data[0], 1);
+  fft.Transform(&data[0], -1);
+  for(uint i = 0; i < data.size(); i++) {
+    EXPECT_NEAR(in[i].real(), data[i].real() / fft.Size(), 1e-10);
+    EXPECT_NEAR(in[i].imag(), data[i].imag() / fft.Size(), 1e-10);
+  }
+}
+
+TEST(FFT3DTest, NextPowerOfTwo) {
+  EXPECT_EQ(1u, FFT3D::NextPowerOfTwo(1));
+  EXPECT_EQ(16u, FFT3D::NextPowerOfTwo(9));
+  EXPECT_EQ(32u, FFT3D::NextPowerOfTwo(32));
+}
@@ -0,0 +1,230 @@
+#include <gtest/gtest.h>
+#include "SimdPairKernel.h"
+#include "EwaldRealTable.h"
+#include <cmath>
+#include <cstdlib>
+
+namespace
+{
+const int N_ATOMS = 45;
+const int N_KINDS = 3;
+
+void MakeSystem(simd::CellAtoms &atoms, simd::PairParams &par,
+                simd::BoxParams &box)
+{
+  srand(12345);
+  atoms.Resize(N_ATOMS);
+  for (int p = 0; p < N_ATOMS; ++p) {
+    atoms.x[p] = 20.0 * rand() / RAND_MAX;
+    atoms.y[p] = 20.0 * rand() / RAND_MAX;
+    atoms.z[p] = 20.0 * rand() / RAND_MAX;
+    atoms.kind[p] = p % N_KINDS;
+    atoms.charge[p] = (p % N_KINDS == 0) ? -0.8 : 0.4;
+    atoms.mol[p] = p / 3;
+    atoms.atom[p] = p;
+  }
+
+  par.count = N_KINDS;
+  for (int i = 0; i < N_KINDS * N_KINDS; ++i) {
+    par.sigmaSq.push_back(4.0 + i);
+    par.epsilon_cn.push_back(4.0 * (0.1 + 0.05 * i));
+    par.epsilon_cn_6.push_back(24.0 * (0.1 + 0.05 * i));
+    par.shiftConst.push_back(0.001 * i);
+  }
+  par.electrostatic = true;
+  par.ewald = true;
+  par.coulombShift = 0.0;
+  par.qqFact = 100.0;
+
+  for (int i = 0; i < 3; ++i) {
+    box.axis[i] = 20.0;
+    box.axisInv[i] = 1.0 / 20.0;
+  }
+  box.rCutSq = 64.0;
+  box.rCutCoulombSq = 64.0;
+  box.alpha = 0.3;
+  box.alphaSq = 0.09;
+  box.tableEn = box.tableVir = NULL;
+  box.tableStart = box.tableEnd = 0.0;
+  box.tableShift = 0;
+  box.tableBase = box.tableMask = 0;
+}
+
+//Plain pair loop with the same rules as RowEnergy
+void Reference(simd::CellAtoms const& a, simd::PairParams const& par,
+               simd::BoxParams const& box, const int skipMol,
+               double &realEn, double &ljEn)
+{
+  realEn = ljEn = 0.0;
+  for (int i = 0; i < N_ATOMS; ++i) {
+    for (int j = i + 1; j < N_ATOMS; ++j) {
+      if (a.mol[i] == a.mol[j] || a.mol[i] == skipMol || a.mol[j] == skipMol)
+        continue;
+      double d[3] = { a.x[i] - a.x[j], a.y[i] - a.y[j], a.z[i] - a.z[j] };
+      double distSq = 0.0;
+      for (int k = 0; k < 3; ++k) {
+        d[k] -= box.axis[k] * std::rint(d[k] * box.axisInv[k]);
+        distSq += d[k] * d[k];
+      }
+      if (distSq >= box.rCutSq)
+        continue;
+      int index = a.kind[i] + a.kind[j] * par.count;
+      double rRat2 = par.sigmaSq[index] / distSq;
+      double attract = rRat2 * rRat2 * rRat2;
+      ljEn += par.epsilon_cn[index] * (attract * attract - attract) -
+              par.shiftConst[index];
+      double dist = sqrt(distSq);
+      realEn += a.charge[i] * a.charge[j] * par.qqFact *
+                erfc(box.alpha * dist) / dist;
+    }
+  }
+}
+}
+
+TEST(SimdPairKernelTest, RowEnergyMatchesScalarLoop) {
+  simd::Isa isa = simd::DetectIsa();
+  if (isa == simd::ISA_NONE)
+    return;
+
+  simd::CellAtoms atoms;
+  simd::PairParams par;
+  simd::BoxParams box;
+  MakeSystem(atoms, par, box);
+  //All atoms in one cell, which is its own only neighbor
+  int cells[1] = { 0 };
+  int cellStart[2] = { 0, N_ATOMS };
+
+  //Every instruction set up to the best one of this CPU
+  for (int i = simd::ISA_AVX2; i <= isa; ++i) {
+    for (int skipMol = -1; skipMol < 2; skipMol += 2) {
+      double refReal, refLJ;
+      Reference(atoms, par, box, skipMol, refReal, refLJ);
+      double realEn = 0.0, ljEn = 0.0;
+      for (int p = 0; p < N_ATOMS; ++p) {
+        if (atoms.mol[p] == skipMol)
+          continue;
+        simd::RowEnergy(simd::Isa(i), atoms, par, box, p, cells, 1,
+                        cellStart, skipMol, realEn, ljEn);
+      }
+      EXPECT_NEAR(refLJ, ljEn, 1e-9 * std::abs(refLJ));
+      EXPECT_NEAR(refReal, realEn, 1e-9 * std::abs(refReal));
+    }
+  }
+}
+
+TEST(SimdPairKernelTest, RowForceIsNewtonThirdLaw) {
+  simd::Isa isa = simd::DetectIsa();
+  if (isa == simd::ISA_NONE)
+    return;
+
+  simd::CellAtoms atoms;
+  simd::PairParams par;
+  simd::BoxParams box;
+  MakeSystem(atoms, par, box);
+  int cells[1] = { 0 };
+  int cellStart[2] = { 0, N_ATOMS };
+  const int nMol = N_ATOMS / 3;
+  double aF[3][N_ATOMS] = {}, mF[3][N_ATOMS / 3] = {};
+
+  double refReal, refLJ, realEn = 0.0, ljEn = 0.0;
+  Reference(atoms, par, box, -1, refReal, refLJ);
+  for (int p = 0; p < N_ATOMS; ++p) {
+    simd::RowForce(isa, atoms, par, box, p, cells, 1, cellStart, -1,
+                   realEn, ljEn, aF[0], aF[1], aF[2], mF[0], mF[1], mF[2]);
+  }
+  EXPECT_NEAR(refLJ, ljEn, 1e-9 * std::abs(refLJ));
+  EXPECT_NEAR(refReal, realEn, 1e-9 * std::abs(refReal));
+  for (int k = 0; k < 3; ++k) {
+    double sumAtom = 0.0, sumMol = 0.0, scale = 0.0;
+    for (int p = 0; p < N_ATOMS; ++p) {
+      sumAtom += aF[k][p];
+      scale += std::abs(aF[k][p]);
+    }
+    for (int m = 0; m < nMol; ++m)
+      sumMol += mF[k][m];
+    EXPECT_NEAR(0.0, sumAtom, 1e-10 * scale);
+    EXPECT_NEAR(0.0, sumMol, 1e-10 * scale);
+  }
+}
+
+TEST(SimdPairKernelTest, RowEnergyWithEwaldTable) {
+  simd::Isa isa = simd::DetectIsa();
+  if (isa == simd::ISA_NONE)
+    return;
+
+  simd::CellAtoms atoms;
+  simd::PairParams par;
+  simd::BoxParams box;
+  MakeSystem(atoms, par, box);
+  EwaldRealTable table;
+  table.Init(0, box.alpha, 0.0, 8.0, 1e-10);
+  box.tableEn = table.EnergyCoef(0);
+  box.tableVir = table.VirialCoef(0);
+  box.tableStart = table.Start(0);
+  box.tableEnd = table.End(0);
+  box.tableShift = table.Shift(0);
+  box.tableBase = table.Base(0);
+  box.tableMask = table.Mask(0);
+  //Some pairs closer than the start of the table
+  atoms.x[4] = atoms.x[0] + 0.5;
+  atoms.y[4] = atoms.y[0];
+  atoms.z[4] = atoms.z[0];
+  int cells[1] = { 0 };
+  int cellStart[2] = { 0, N_ATOMS };
+
+  double refReal, refLJ;
+  Reference(atoms, par, box, -1, refReal, refLJ);
+  for (int i = simd::ISA_AVX2; i <= isa; ++i) {
+    double realEn = 0.0, ljEn = 0.0;
+    for (int p = 0; p < N_ATOMS; ++p) {
+      simd::RowEnergy(simd::Isa(i), atoms, par, box, p, cells, 1, cellStart,
+                      -1, realEn, ljEn);
+    }
+    EXPECT_NEAR(refLJ, ljEn, 1e-9 * std::abs(refLJ));
+    EXPECT_NEAR(refReal, realEn, 1e-8 * std::abs(refReal));
+  }
+}
+
+TEST(SimdPairKernelTest, RowEnergyMixedMatchesScalarLoop) {
+  simd::Isa isa = simd::DetectIsa();
+  if (isa == simd::ISA_NONE)
+    return;
+
+  simd::CellAtoms atoms;
+  simd::PairParams par;
+  simd::BoxParams box;
+  MakeSystem(atoms, par, box);
+  atoms.Resize(N_ATOMS, true);
+  for (int p = 0; p < N_ATOMS; ++p) {
+    atoms.xf[p] = atoms.x[p];
+    atoms.yf[p] = atoms.y[p];
+    atoms.zf[p] = atoms.z[p];
+    atoms.chargef[p] = atoms.charge[p];
+  }
+  par.FillSingle();
+  int cells[1] = { 0 };
+  int cellStart[2] = { 0, N_ATOMS };
+
+  for (int i = simd::ISA_AVX2; i <= isa; ++i) {
+    for (int skipMol = -1; skipMol < 2; skipMol += 2) {
+      //Reference from the rounded coordinates, so only the pair math counts
+      simd::CellAtoms rounded = atoms;
+      for (int p = 0; p < N_ATOMS; ++p) {
+        rounded.x[p] = atoms.xf[p];
+        rounded.y[p] = atoms.yf[p];
+        rounded.z[p] = atoms.zf[p];
+      }
+      double refReal, refLJ;
+      Reference(rounded, par, box, skipMol, refReal, refLJ);
+      double realEn = 0.0, ljEn = 0.0;
+      for (int p = 0; p < N_ATOMS; ++p) {
+        if (atoms.mol[p] == skipMol)
+          continue;
+        simd::RowEnergyMixed(simd::Isa(i), atoms, par, box, p, cells, 1,
+                             cellStart, skipMol, realEn, ljEn);
+      }
+      EXPECT_NEAR(refLJ, ljEn, 1e-5 * std::abs(refLJ));
+      EXPECT_NEAR(refReal, realEn, 1e-5 * std::abs(refReal));
+    }
+  }
+}
@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include "VerletList.h"
+#include "BoxDimensionsNonOrth.h"
+#include <cstdlib>
+#include <set>
+#include <utility>
+
+namespace
+{
+const int N_ATOMS = 300;
+const double SKIN = 1.0;
+
+void MakeAtoms(XYZArray &coords, std::vector<int> &atoms,
+               std::vector<int> &particleMol, const double side)
+{
+  srand(4321);
+  coords.Init(N_ATOMS);
+  for (int p = 0; p < N_ATOMS; ++p) {
+    coords.Set(p, side * rand() / RAND_MAX, side * rand() / RAND_MAX,
+               side * rand() / RAND_MAX);
+    atoms.push_back(p);
+    particleMol.push_back(p / 2);
+  }
+}
+
+//Every pair of the list must be a unique pair of different molecules, and
+//every such pair closer than rCut + skin must be in the list
+void CheckPairs(VerletList const& list, XYZArray const& coords,
+                BoxDimensions const& boxDim, std::vector<int> const& particleMol)
+{
+  double listCutSq = (boxDim.rCut[0] + SKIN) * (boxDim.rCut[0] + SKIN);
+  std::set< std::pair<int, int> > found;
+  std::vector<int> const& atoms = list.Atoms(0);
+  std::vector<int> const& start = list.Start(0);
+  std::vector<int> const& pairs = list.Pairs(0);
+  for (uint r = 0; r < atoms.size(); ++r) {
+    for (int k = start[r]; k < start[r + 1]; ++k) {
+      EXPECT_LT(atoms[r], pairs[k]);
+      EXPECT_NE(particleMol[atoms[r]], particleMol[pairs[k]]);
+      EXPECT_TRUE(found.insert(std::make_pair(atoms[r], pairs[k])).second);
+    }
+  }
+  uint expected = 0;
+  for (int i = 0; i < N_ATOMS; ++i) {
+    for (int j = i + 1; j < N_ATOMS; ++j) {
+      if (particleMol[i] == particleMol[j])
+        continue;
+      XYZ dist = boxDim.MinImage(coords.Difference(i, j), 0);
+      if (dist.LengthSq() < listCutSq) {
+        EXPECT_EQ(1u, found.count(std::make_pair(i, j)));
+        ++expected;
+      }
+    }
+  }
+  EXPECT_EQ(expected, found.size());
+}
+}
+
+TEST(VerletListTest, OrthListHasAllPairs) {
+  BoxDimensions boxDim;
+  boxDim.axis.Set(0, 30.0, 30.0, 30.0);
+  boxDim.halfAx.Set(0, 15.0, 15.0, 15.0);
+  boxDim.rCut[0] = 8.0;
+  boxDim.rCutSq[0] = 64.0;
+  XYZArray coords;
+  std::vector<int> atoms, particleMol;
+  MakeAtoms(coords, atoms, particleMol, 30.0);
+
+  VerletList list;
+  list.Init(SKIN);
+  list.Update(coords, boxDim, 0, atoms, particleMol);
+  EXPECT_EQ(1u, list.Builds(0));
+  CheckPairs(list, coords, boxDim, particleMol);
+}
+
+TEST(VerletListTest, NonOrthListHasAllPairs) {
+  BoxDimensionsNonOrth boxDim;
+  boxDim.cellBasis[0].Set(0, 30.0, 0.0, 0.0);
+  boxDim.cellBasis[0].Set(1, 8.0, 30.0, 0.0);
+  boxDim.cellBasis[0].Set(2, 0.0, 6.0, 30.0);
+  boxDim.cellLength.Set(0, boxDim.cellBasis[0].Length(0),
+                        boxDim.cellBasis[0].Length(1),
+                        boxDim.cellBasis[0].Length(2));
+  boxDim.CalcCellDimensions(0);
+  boxDim.axis.Set(0, boxDim.cellLength.Get(0));
+  boxDim.halfAx.Set(0, boxDim.cellLength.Get(0) * 0.5);
+  boxDim.rCut[0] = 6.0;
+  boxDim.rCutSq[0] = 36.0;
+  XYZArray coords;
+  std::vector<int> atoms, particleMol;
+  MakeAtoms(coords, atoms, particleMol, 30.0);
+  //Put the atoms inside the slanted cell
+  for (int p = 0; p < N_ATOMS; ++p)
+    coords.Set(p, boxDim.TransformSlant(coords.Get(p), 0));
+
+  VerletList list;
+  list.Init(SKIN);
+  list.Update(coords, boxDim, 0, atoms, particleMol);
+  CheckPairs(list, coords, boxDim, particleMol);
+}
+
+TEST(VerletListTest, RebuildsOnlyWhenNeeded) {
+  BoxDimensions boxDim;
+  boxDim.axis.Set(0, 30.0, 30.0, 30.0);
+  boxDim.halfAx.Set(0, 15.0, 15.0, 15.0);
+  boxDim.rCut[0] = 8.0;
+  boxDim.rCutSq[0] = 64.0;
+  XYZArray coords;
+  std::vector<int> atoms, particleMol;
+  MakeAtoms(coords, atoms, particleMol, 30.0);
+
+  VerletList list;
+  list.Init(SKIN);
+  list.Update(coords, boxDim, 0, atoms, particleMol);
+
+  //Every atom moves less than half the skin
+  for (int p = 0; p < N_ATOMS; ++p)
+    coords.Add(p, 0.2, -0.2, 0.2);
+  list.Update(coords, boxDim, 0, atoms, particleMol);
+  EXPECT_EQ(1u, list.Builds(0));
+
+  //Moving through the box boundary is not a real move
+  coords.Set(0, 29.9, 10.0, 10.0);
+  list.Update(coords, boxDim, 0, atoms, particleMol);
+  coords.Set(0, 0.1, 10.0, 10.0);
+  EXPECT_EQ(2u, list.Builds(0));
+  list.Update(coords, boxDim, 0, atoms, particleMol);
+  EXPECT_EQ(2u, list.Builds(0));
+
+  //One atom moves more than half the skin
+  coords.Add(1, 0.6, 0.0, 0.0);
+  list.Update(coords, boxDim, 0, atoms, particleMol);
+  EXPECT_EQ(3u, list.Builds(0));
+  CheckPairs(list, coords, boxDim, particleMol);
+
+  //An atom leaves the box
+  atoms.pop_back();
+  list.Update(coords, boxDim, 0, atoms, particleMol);
+  EXPECT_EQ(4u, list.Builds(0));
+
+  //The box is resized
+  boxDim.axis.Set(0, 31.0, 31.0, 31.0);
+  boxDim.halfAx.Set(0, 15.5, 15.5, 15.5);
+  list.Update(coords, boxDim, 0, atoms, particleMol);
+  EXPECT_EQ(5u, list.Builds(0));
+}